@@ -5,6 +5,13 @@
 #include "parameters.hpp"
 #include "random.hpp"
 #include "architecture.hpp"
+#include "readpars.hpp"
+#include "checker.hpp"
+#include "bits.hpp"
+#include "cache.hpp"
+#include "packing.hpp"
+#include "patch.hpp"
+#include "sampler.hpp"
 #include <iostream>
 #include <bitset>
 #include <cassert>
@@ -13,13 +20,17 @@
 #include <sstream>
 #include <numeric>
 #include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <bit>
 
 // Function to import matrix of alleles from file
-void gen::import(std::vector<std::bitset<64u> > &alleles, const std::string &filename, const size_t &N) {
+void gen::import(std::vector<std::bitset<64u> > &alleles, const std::string &filename, const size_t &N, const size_t &ploidy) {
 
     // alleles: vector of bitsets representing matrix of alleles
     // filename: name of the file to import
     // N: total number of alleles in the population
+    // ploidy: number of alleles per locus
 
     // Create input file stream
     std::ifstream file(filename);
@@ -28,15 +39,18 @@ void gen::import(std::vector<std::bitset<64u> > &alleles, const std::string &fil
     if (!file.is_open())
         throw std::runtime_error("Unable to open file " + filename);
 
-    // Skip header
+    // Read header
     std::string line;
     std::getline(file, line);
 
+    // Check whether there is a deme column
+    const bool hasdemes = line.rfind("id,deme,", 0u) == 0u;
+
     // Number of bits per bitset
     const size_t n = 64u;
 
-    // Number of diploid genotype entries expected in the file
-    const size_t ngenotypes = N / 2u;
+    // Number of genotype entries expected in the file
+    const size_t ngenotypes = N / ploidy;
 
     // For each line in the file...
     size_t i = 0u;
@@ -50,6 +64,10 @@ void gen::import(std::vector<std::bitset<64u> > &alleles, const std::string &fil
         if (!std::getline(stream, token, ','))
             throw std::runtime_error("Invalid format in file " + filename);
 
+        // Skip the deme column if any
+        if (hasdemes && !std::getline(stream, token, ','))
+            throw std::runtime_error("Invalid format in file " + filename);
+
         // Parse only genotype columns
         while (std::getline(stream, token, ',')) {
 
@@ -70,15 +88,15 @@ void gen::import(std::vector<std::bitset<64u> > &alleles, const std::string &fil
             }
 
             // Check that it is a valid genotype
-            if (value < 0 || value > 2)
+            if (value < 0 || value > static_cast<int>(ploidy))
                 throw std::runtime_error("Invalid genotype value in file " + filename);
 
-            // Set the corresponding bits in the bitsets
-            if (value == 1) alleles[i / n].set(i % n);
-            else if (value == 2) {
-                alleles[i / n].set(i % n);
-                alleles[(i + ngenotypes) / n].set((i + ngenotypes) % n);
-            }
+            // Set as many of the alleles of the locus as the genotype says
+            for (size_t h = 0u; h < static_cast<size_t>(value); ++h)
+                alleles[(ploidy * i + h) / n].set((ploidy * i + h) % n);
+
+            // Note: The alleles of a locus are next to each other in the bit
+            // stream, and the genotype (or dosage) is the number of 1-alleles.
 
             // Move to the next allele
             ++i;
@@ -269,19 +287,649 @@ void gen::mutate(std::vector<std::bitset<64u> > &alleles, const double &mu, cons
     }
 }
 
-// Function to convert the matrix of alleles into a vector of trait values
-std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles, const Parameters &pars, const Architecture &arch, const size_t &N) {
+// Function to sample allele frequencies across loci
+std::vector<double> gen::frequencies(const Parameters &pars) {
+
+    // pars: general hyperparameters
+
+    // Prepare one frequency per locus
+    std::vector<double> freqs(pars.nloci, pars.mutation);
+
+    // Depending on the frequency spectrum...
+    if (pars.spectrum == 1u) {
+
+        // Prepare gamma samplers
+        rnd::gamma getx(pars.shapes[0u], 1.0);
+        rnd::gamma gety(pars.shapes[1u], 1.0);
+
+        // For each locus...
+        for (size_t l = 0u; l < pars.nloci; ++l) {
+
+            // Random stream of the locus
+            rnd::Stream stream = rnd::rng.stream(rnd::frequencies, l);
+
+            // Forget cached draws if the stream is the locus' own
+            if (rnd::rng.iscounter()) { getx.reset(); gety.reset(); }
+
+            // Sample from a beta distribution
+            const double x = getx(stream);
+            const double y = gety(stream);
+            freqs[l] = x / (x + y);
+
+        }
+
+        // Note: A beta variate is the ratio of a gamma variate
+        // to the sum of itself and another.
+
+    } else if (pars.spectrum == 2u) {
+
+        // Prepare a uniform sampler
+        rnd::uniform getu(0.0, 1.0);
+
+        // Ratio between the highest and lowest possible frequencies
+        const double range = (1.0 - pars.minfreq) / pars.minfreq;
+
+        // For each locus...
+        for (size_t l = 0u; l < pars.nloci; ++l) {
+
+            // Random stream of the locus
+            rnd::Stream stream = rnd::rng.stream(rnd::frequencies, l);
+
+            // Sample from a density proportional to one over the frequency
+            freqs[l] = pars.minfreq * pow(range, getu(stream));
+
+        }
+
+        // Note: This is inverse transform sampling of the neutral site
+        // frequency spectrum, truncated between minfreq and 1 - minfreq.
+
+    } else if (pars.spectrum == 3u) {
+
+        // Name of the input file
+        const std::string filename = "frequencies.txt";
+
+        // Create a reader
+        ReadPars reader(filename);
+
+        // Open the file
+        reader.open();
+
+        // Flag
+        bool found = false;
+
+        // For each line in the file...
+        while (!reader.iseof()) {
+
+            // Read a line
+            reader.readline();
+
+            // Skip empty or comment line
+            if (reader.isempty() || reader.iscomment()) continue;
+
+            // Read the frequencies
+            if (reader.getname() == "frequencies") reader.readvalues<double>(freqs, pars.nloci, chk::proportion<double>);
+            else
+                reader.readerror();
+
+            // Remember
+            found = true;
+
+        }
+
+        // Close the file
+        reader.close();
+
+        // Error if needed
+        if (!found)
+            throw std::runtime_error("No frequencies found in file " + filename);
+
+    } else {
+
+        // Otherwise one possible choice left
+        assert(pars.spectrum == 0u);
+
+    }
+
+    // Check
+    assert(freqs.size() == pars.nloci);
+
+    // Exit
+    return freqs;
+
+}
+
+// Function to throw mutations with locus-specific rates
+void gen::mutate(std::vector<std::bitset<64u> > &alleles, const std::vector<double> &freqs, const size_t &popsize, const size_t &ploidy) {
+
+    // alleles: vector of bitsets representing matrix of alleles
+    // freqs: mutation rate of each locus
+    // popsize: number of individuals in the population
+    // ploidy: number of alleles per locus
+
+    // Number of bits per bitset
+    const size_t n = 64u;
+
+    // Number of loci
+    const size_t nloci = freqs.size();
+
+    // Number of alleles per locus across the population
+    const size_t M = ploidy * popsize;
+
+    // Note: Each locus is a column of M alleles, ploidy per individual. Within
+    // a column, consecutive groups of alleles are one row (ploidy * nloci bits)
+    // apart in the bit stream.
+
+    // For each locus...
+    for (size_t l = 0u; l < nloci; ++l) {
+
+        // Mutation rate at that locus
+        double mu = freqs[l];
+
+        // Skip if no mutations
+        if (mu == 0.0) continue;
+
+        // Position of the locus within a row
+        const size_t offset = ploidy * l;
+
+        // Flag for whether to flip the whole column
+        const bool high = mu > 0.5;
+
+        // If mutation rate is high...
+        if (high) {
+
+            // Flip all alleles in the column
+            for (size_t k = 0u; k < M; ++k) {
+
+                // Position in the bit stream
+                const size_t i = (k / ploidy) * ploidy * nloci + offset + k % ploidy;
+
+                // Flip
+                alleles[i / n].flip(i % n);
+
+            }
+
+            // Sample those to flip back instead
+            mu = 1.0 - mu;
+
+        }
+
+        // Skip if nothing to flip back
+        if (mu == 0.0) continue;
+
+        // Random stream of the locus
+        rnd::Stream stream = rnd::rng.stream(rnd::mutation, l);
+
+        // Prepare a next mutation sampler
+        rnd::geometric getnext(mu);
+
+        // Sample first mutation
+        size_t k = getnext(stream);
+
+        // For as long as it takes...
+        while (k < M) {
+
+            // Position in the bit stream
+            const size_t i = (k / ploidy) * ploidy * nloci + offset + k % ploidy;
+
+            // Flip the sampled allele
+            alleles[i / n].flip(i % n);
+
+            // Sample the next one (avoid self)
+            k += getnext(stream) + 1u;
+
+        }
+
+        // Check
+        assert(k >= M);
+
+    }
+
+    // Note: The number of draws is proportional to the number of mutant
+    // alleles, not to the number of alleles in the population.
+
+}
+
+// Function to sample genotypes directly from locus-specific frequencies
+void gen::sample(std::vector<std::bitset<64u> > &alleles, const std::vector<double> &freqs, const size_t &popsize, const size_t &ploidy, rnd::Generator &rng) {
 
     // alleles: vector of bitsets representing matrix of alleles
+    // freqs: frequency of the 1-allele at each locus
+    // popsize: number of individuals in the population
+    // ploidy: number of alleles per locus
+    // rng: random number generator to draw from
+
+    // Number of bits per bitset
+    const size_t n = 64u;
+
+    // Number of alleles per individual (length of a row)
+    const size_t R = ploidy * freqs.size();
+
+    // Prepare a block of 64 slots by 64 individuals
+    std::array<std::uint64_t, 64u> block;
+
+    // For each block of 64 individuals...
+    for (size_t b = 0u; b < popsize; b += n) {
+
+        // Number of individuals in the block
+        const size_t ni = std::min(n, popsize - b);
+
+        // For each chunk of 64 allele slots along the row...
+        for (size_t c = 0u; c < R; c += n) {
+
+            // Number of slots in the chunk
+            const size_t ns = std::min(n, R - c);
+
+            // Random stream of the block
+            rnd::Stream stream = rng.stream(rnd::mutation, (b / n) * ((R + n - 1u) / n) + c / n);
+
+            // For each slot...
+            for (size_t s = 0u; s < n; ++s) {
+
+                // Sample which of the 64 individuals carry the 1-allele
+                block[s] = s < ns ? rnd::mask(freqs[(c + s) / ploidy], stream) : 0u;
+
+                // Note: All slots of a locus share its frequency but are
+                // sampled independently (Hardy-Weinberg equilibrium).
+
+            }
+
+            // Turn slot-major words into individual-major words
+            bit::transpose(block);
+
+            // For each individual in the block...
+            for (size_t j = 0u; j < ni; ++j) {
+
+                // Write its 64 slots at the right place in its row
+                bit::flip(alleles, (b + j) * R + c, block[j]);
+
+            }
+        }
+    }
+
+    // Note: Sampled alleles are flipped rather than set, like mutations, so
+    // this is equivalent to mutating each allele with the frequency of its locus.
+
+}
+
+// Function to sample haplotypes as mosaics of blocks copied from founders
+void gen::mosaic(std::vector<std::bitset<64u> > &alleles, const std::vector<double> &freqs, const size_t &popsize, const size_t &ploidy, const size_t &nfounders, const double &rate, rnd::Generator &rng) {
+
+    // alleles: vector of bitsets representing matrix of alleles
+    // freqs: frequency of the 1-allele at each locus among founders
+    // popsize: number of individuals in the population
+    // ploidy: number of alleles per locus
+    // nfounders: number of founder haplotypes
+    // rate: probability to switch founder between consecutive loci
+    // rng: random number generator to draw from
+
+    // Number of loci
+    const size_t nloci = freqs.size();
+
+    // Number of loci copied per word (one allele every ploidy bits)
+    const size_t n = 64u / ploidy;
+
+    // Function to place the alleles of consecutive loci at the right stride
+    std::uint64_t (*deposit)(const std::uint64_t&) = bit::deposit<2u>;
+    if (ploidy == 1u) deposit = bit::deposit<1u>;
+    else if (ploidy == 4u) deposit = bit::deposit<4u>;
+    else if (ploidy == 6u) deposit = bit::deposit<6u>;
+
+    // Prepare the founder haplotypes, one row of loci each
+    std::vector<std::bitset<64u> > founders(nfounders * nloci / 64u + 1u);
+
+    // Prepare a uniform sampler
+    rnd::uniform getu(0.0, 1.0);
+
+    // For each founder...
+    for (size_t f = 0u; f < nfounders; ++f) {
+
+        // Random stream of the founder
+        rnd::Stream stream = rng.stream(rnd::founders, f);
+
+        // Sample its allele at each locus
+        for (size_t l = 0u; l < nloci; ++l)
+            if (getu(stream) < freqs[l]) founders[(f * nloci + l) / 64u].set((f * nloci + l) % 64u);
+
+    }
+
+    // Prepare to pick founders and run lengths
+    rnd::random getfounder(0u, nfounders - 1u);
+    rnd::geometric getrun(rate > 0.0 && rate < 1.0 ? rate : 0.5);
+
+    // For each haplotype in the population...
+    for (size_t j = 0u; j < ploidy * popsize; ++j) {
+
+        // Individual and haplotype within the individual
+        const size_t i = j / ploidy;
+        const size_t h = j % ploidy;
+
+        // Random stream of the haplotype
+        rnd::Stream stream = rng.stream(rnd::haplotypes, j);
+
+        // For each run of loci copied from the same founder...
+        for (size_t l = 0u, len = 0u; l < nloci; l += len) {
+
+            // Pick the founder
+            const size_t f = getfounder(stream);
+
+            // Sample the number of loci until the next switch
+            len = rate >= 1.0 ? 1u : rate > 0.0 ? std::min(getrun(stream) + 1u, nloci - l) : nloci;
+
+            // Note: The geometric distribution needs a rate strictly between
+            // zero and one, so the edge cases are handled separately.
+
+            // For each word's worth of loci in the run...
+            for (size_t c = 0u; c < len; c += n) {
+
+                // Read the alleles of the founder and keep those in the run
+                const size_t w = std::min(n, len - c);
+                const std::uint64_t bits = bit::get(founders, f * nloci + l + c) & (~0ull >> (64u - w));
+
+                // Write them onto the haplotype, one every ploidy bits
+                bit::flip(alleles, ploidy * (i * nloci + l + c) + h, deposit(bits));
+
+            }
+        }
+    }
+
+    // Note: Each haplotype is a Markov chain over loci that jumps to a random
+    // founder (possibly the same one) with the given rate between loci, so
+    // nearby loci are in linkage disequilibrium. Whole runs are written a
+    // word at a time, so the cost scales with the number of switches rather
+    // than the number of alleles. Like mutations, copied alleles are flipped.
+
+}
+
+// Function to sample the genotypes of a population structured in demes
+void gen::structure(std::vector<std::bitset<64u> > &alleles, const std::vector<double> &freqs, const Parameters &pars) {
+
+    // alleles: vector of bitsets representing matrix of alleles
+    // freqs: frequency of the 1-allele at each locus in the ancestral population
     // pars: general hyperparameters
-    // arch: genetic architecture
-    // N: total number of alleles in the population
 
     // Number of bits per bitset
     const size_t n = 64u;
 
+    // Number of alleles per individual (length of a row)
+    const size_t R = pars.ploidy * freqs.size();
+
+    // Prepare to store the alleles of each deme separately
+    std::vector<std::vector<std::bitset<64u> > > slices(pars.ndemes);
+
+    // Function to sample the alleles of a given deme
+    auto generate = [&](const size_t &d) {
+
+        // Generator of the deme
+        rnd::Generator rng = rnd::rng.derive(rnd::demes, d);
+
+        // Prepare the allele frequencies of the deme
+        std::vector<double> local = freqs;
+
+        // For each locus...
+        for (size_t l = 0u; l < freqs.size() && pars.fst > 0.0; ++l) {
+
+            // Ancestral frequency
+            const double p = freqs[l];
+
+            // Skip if fixed
+            if (p == 0.0 || p == 1.0) continue;
+
+            // Random stream of the locus
+            rnd::Stream stream = rng.stream(rnd::frequencies, l);
+
+            // Fixed at random if the demes are completely differentiated
+            if (pars.fst == 1.0) { local[l] = rnd::uniform(0.0, 1.0)(stream) < p; continue; }
+
+            // Otherwise sample from a beta distribution centered on the ancestral frequency
+            const double scale = (1.0 - pars.fst) / pars.fst;
+            const double x = rnd::gamma(p * scale, 1.0)(stream);
+            const double y = rnd::gamma((1.0 - p) * scale, 1.0)(stream);
+            if (x + y > 0.0) local[l] = x / (x + y);
+
+        }
+
+        // Note: This is the Balding-Nichols model, where the frequency of a locus
+        // in each deme has the ancestral frequency as mean and p(1 - p)Fst as variance.
+
+        // Prepare the alleles of the deme
+        slices[d].resize(pars.demesizes[d] * R / n + 1u);
+
+        // Sample genotypes from the frequencies of the deme
+        if (pars.sampling == 5u) gen::mosaic(slices[d], local, pars.demesizes[d], pars.ploidy, pars.nfounders, pars.switchrate, rng);
+        else gen::sample(slices[d], local, pars.demesizes[d], pars.ploidy, rng);
+
+    };
+
+    // Number of threads to use
+    const size_t ncores = pars.nthreads > 0u ? pars.nthreads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t nthreads = std::min(pars.ndemes, ncores);
+
+    // Prepare threads
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+
+    // Generate the demes on the threads in turn
+    for (size_t t = 0u; t < nthreads; ++t)
+        threads.emplace_back([&, t]() { for (size_t d = t; d < pars.ndemes; d += nthreads) generate(d); });
+
+    // Wait for all of them
+    for (std::thread &thread : threads) thread.join();
+
+    // First row of the current deme
+    size_t start = 0u;
+
+    // For each deme...
+    for (size_t d = 0u; d < pars.ndemes; ++d) {
+
+        // Number of alleles in the deme
+        const size_t M = pars.demesizes[d] * R;
+
+        // Copy them, one word at a time, into the rows of the deme
+        for (size_t c = 0u; c < M; c += n) {
+            const std::uint64_t mask = M - c < n ? ~0ull >> (n - (M - c)) : ~0ull;
+            bit::flip(alleles, start * R + c, slices[d][c / n].to_ullong() & mask);
+        }
+
+        // Move to the next deme
+        start += pars.demesizes[d];
+
+    }
+
+    // Note: Demes do not start at word boundaries in the matrix of alleles,
+    // so each thread writes into its own buffer, and the buffers are then
+    // stitched together. Each deme draws from its own generator, so results
+    // do not depend on the number of threads or the order they run in.
+
+}
+
+// Function to replace the population by its offspring
+void gen::reproduce(std::vector<std::bitset<64u> > &alleles, std::vector<std::bitset<64u> > &buffer, const Parameters &pars, const size_t &t) {
+
+    // alleles: vector of bitsets representing matrix of alleles (parents, then offspring)
+    // buffer: vector of bitsets of the same size, to build the offspring into
+    // pars: general hyperparameters
+    // t: generation number
+
+    // Number of loci per word (two alleles each)
+    const size_t n = 32u;
+
+    // Number of alleles per individual (length of a row)
+    const size_t R = 2u * pars.nloci;
+
+    // Even bits (first haplotype of each locus)
+    const std::uint64_t even = 0x5555555555555555ull;
+
+    // Check
+    assert(buffer.size() == alleles.size());
+    assert(pars.ploidy == 2u);
+
+    // Clear the offspring
+    for (std::bitset<64u> &word : buffer) word.reset();
+
+    // Prepare to store crossover points
+    std::vector<size_t> crossovers;
+
+    // Prepare samplers
+    rnd::bernoulli gethaplotype(0.5);
+    rnd::geometric getinterval(pars.recombination > 0.0 && pars.recombination < 1.0 ? pars.recombination : 0.5);
+
+    // Function to sample the number of loci between two crossovers (none if every locus recombines)
+    auto interval = [&](rnd::Stream &stream) -> size_t { return pars.recombination < 1.0 ? getinterval(stream) : 0u; };
+
+    // Note: The geometric distribution needs a rate strictly between zero
+    // and one, so the edge cases are handled separately.
+
+    // First individual of the current deme
+    size_t start = 0u;
+
+    // For each deme...
+    for (size_t d = 0u; d < pars.ndemes; ++d) {
+
+        // Prepare to sample parents from within the deme
+        rnd::random getparent(start, start + pars.demesizes[d] - 1u);
+
+        // For each offspring in the deme...
+        for (size_t i = start; i < start + pars.demesizes[d]; ++i) {
+
+            // Random stream of the offspring
+            rnd::Stream stream = rnd::rng.stream(rnd::reproduction, t * pars.popsize + i);
+
+            // For each of its two haplotypes...
+            for (size_t h = 0u; h < 2u; ++h) {
+
+                // Sample the parent
+                const size_t parent = getparent(stream);
+
+                // Sample the haplotype of the parent to start from
+                bool state = gethaplotype(stream);
+
+                // Sample the loci at which the gamete switches haplotype
+                crossovers.clear();
+                if (pars.recombination > 0.0)
+                    for (size_t x = interval(stream) + 1u; x < pars.nloci; x += interval(stream) + 1u)
+                        crossovers.push_back(x);
+
+                // For each chunk of loci...
+                for (size_t c = 0u, x = 0u; c < pars.nloci; c += n) {
+
+                    // Start from the haplotype in use
+                    std::uint64_t mask = state ? 0xFFFFFFFFull : 0u;
+
+                    // Switch haplotype at every crossover within the chunk
+                    for (; x < crossovers.size() && crossovers[x] < c + n; ++x) {
+                        mask ^= (0xFFFFFFFFull << (crossovers[x] - c)) & 0xFFFFFFFFull;
+                        state = !state;
+                    }
+
+                    // Spread the mask over the first allele of each locus
+                    mask = bit::spread(mask);
+
+                    // Alleles of the parent in the chunk
+                    const std::uint64_t word = bit::get(alleles, parent * R + 2u * c);
+
+                    // Pick the allele of either haplotype at each locus
+                    std::uint64_t gamete = (word & ~mask & even) | ((word >> 1u) & mask & even);
+
+                    // Keep only the loci of the chunk
+                    if (pars.nloci - c < n) gamete &= ~0ull >> (64u - 2u * (pars.nloci - c));
+
+                    // Write it as the right haplotype of the offspring
+                    bit::flip(buffer, i * R + 2u * c, gamete << h);
+
+                }
+            }
+        }
+
+        // Move to the next deme
+        start += pars.demesizes[d];
+
+    }
+
+    // Offspring become the parents of the next generation
+    alleles.swap(buffer);
+
+    // Note: Each haplotype of an offspring is a gamete from a parent sampled at
+    // random within its deme (Wright-Fisher model). Gametes are assembled 32 loci
+    // at a time from a mask telling which haplotype of the parent each locus comes
+    // from, and recombination happens between consecutive loci with the given rate.
+
+}
+
+// Function to add the contributions of a run of hyperedges of the same order to trait values
+template <size_t K>
+void gen::interact(std::vector<double> &traits, const std::vector<double> &expressions, const Parameters &pars, const Architecture &arch, const size_t &first, const size_t &last) {
+
+    // traits: trait values of all individuals (to add to)
+    // expressions: expression levels of all loci in all individuals
+    // pars: general hyperparameters
+    // arch: genetic architecture
+    // first: first hyperedge of the run
+    // last: end of the run (excluded)
+    // K: order of the hyperedges (any order, read from the offsets, if zero)
+
+    // Get population size
+    const size_t popsize = expressions.size() / arch.nloci;
+
+    // Loci of the first hyperedge of the run
+    const Architecture::Locus *loci = arch.hyperloci.data() + arch.hyperstarts[first];
+
+    // For each individual...
+    for (size_t individual = 0u; individual < popsize; ++individual) {
+
+        // Expression levels and trait values of the individual
+        const double *x = expressions.data() + individual * arch.nloci;
+        double *y = traits.data() + individual * arch.ntraits;
+
+        // Loci of the current hyperedge
+        const Architecture::Locus *members = loci;
+
+        // For each hyperedge in the run...
+        for (size_t h = first; h < last; ++h) {
+
+            // Number of loci in the hyperedge
+            const size_t k = K > 0u ? K : arch.hyperstarts[h + 1u] - arch.hyperstarts[h];
+
+            // Multiply the expression levels of its loci
+            double product = x[members[0u]];
+            for (size_t e = 1u; e < k; ++e) product *= x[members[e]];
+
+            // Which trait is affected?
+            const size_t traitid = arch.traitids[members[0u]];
+
+            // Add the interaction contribution to the phenotype
+            y[traitid] += product * arch.hyperweights[h] * pars.epistasis[traitid];
+
+            // Move to the next hyperedge
+            members += k;
+
+        }
+    }
+
+    // Note: When the order is known at compile time, the product is fully
+    // unrolled and the loci of consecutive hyperedges are found at fixed
+    // strides, with no offsets to read. The generic version (K = 0) handles
+    // hyperedges of higher orders.
+
+}
+
+// Function to convert the matrix of alleles into a vector of trait values, for a given ploidy
+template <size_t P>
+std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles, const Parameters &pars, const Architecture &arch, const size_t &N, const size_t &t) {
+
+    // alleles: vector of bitsets representing matrix of alleles
+    // pars: general hyperparameters
+    // arch: genetic architecture
+    // N: total number of alleles in the population
+    // t: generation (to draw environmental noise from its own streams)
+
+    // Number of loci decoded per word
+    const size_t n = 64u / P;
+
+    // Mask of the alleles of one locus
+    const std::uint64_t field = (1ull << P) - 1u;
+
     // Get population size
-    const size_t popsize = N / (2u * arch.nloci);
+    const size_t popsize = N / (P * arch.nloci);
 
     // Total number of genotypes
     const size_t tloci = popsize * arch.nloci;
@@ -298,32 +946,38 @@ std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles,
     // Prepare to store individual trait values
     std::vector<double> traits(ttraits);
 
+    // Dosages of the current chunk of loci
+    std::uint64_t dosages = 0u;
+
+    // Whether some loci affect several traits
+    const bool pleiotropic = arch.npleio > 0u;
+
     // For each locus in each individual...
     for (size_t i = 0u; i < tloci; ++i) {
 
         // Locus index
         const size_t locus = i % arch.nloci;
 
-        // Which trait is affected?
-        const size_t traitid = arch.traitids[locus];
+        // Position of the locus within its chunk
+        const size_t j = locus % n;
 
-        // Get the two alleles (stored next to each other)
-        const size_t i1 = 2u * i;
-        const size_t i2 = i1 + 1u;
-        const bool allele1 = alleles[i1 / n].test(i1 % n);
-        const bool allele2 = alleles[i2 / n].test(i2 % n);
+        // Decode the dosages of a whole chunk of loci at once if needed
+        if (j == 0u) dosages = bit::dosages<P>(bit::get(alleles, P * i));
 
-        // Note: This assumes that each diploid locus is encoded as adjacent
-        // alleles in the bit stream.
+        // Note: This assumes that the P alleles of each locus are encoded
+        // next to each other in the bit stream.
 
-        // Get genotype from alleles
-        const size_t genotype = allele1 + allele2;
+        // Which trait is affected?
+        const size_t traitid = arch.traitids[locus];
+
+        // Get genotype (number of 1-alleles) from the dosages
+        const size_t genotype = (dosages >> (P * j)) & field;
 
-        // Translate genotype into expression level (-1, 0, or +1)
-        expressions[i] = genotype - 1.0;
+        // Translate genotype into expression level (from -1 to +1)
+        expressions[i] = 2.0 * genotype / P - 1.0;
 
         // Add dominance deviation for heterozygotes if needed
-        expressions[i] += (genotype == 1u) * arch.domcoeffs[locus] * pars.dominance[traitid];
+        expressions[i] += (genotype > 0u && genotype < P) * arch.domcoeffs[locus] * pars.dominance[traitid];
 
         // Compute additive contribution to the phenotype
         const double value = expressions[i] * arch.effects[locus] * (1.0 - pars.epistasis[traitid]);
@@ -338,10 +992,83 @@ std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles,
         // such that values encoding different traits for the same individual
         // are contiguous.
 
+        // Skip unless the locus affects other traits
+        if (!pleiotropic) continue;
+
+        // Whether the individual is heterozygous at the locus
+        const bool heterozygous = genotype > 0u && genotype < P;
+
+        // For each other trait affected by the locus...
+        for (size_t e = arch.pleiostarts[locus]; e < arch.pleiostarts[locus + 1u]; ++e) {
+
+            // Which trait is affected?
+            const size_t other = arch.pleiotraits[e];
+
+            // Expression level with the dominance deviation specific to that trait
+            const double expression = 2.0 * genotype / P - 1.0 + heterozygous * arch.pleiodomcoeffs[e] * pars.dominance[other];
+
+            // Add the additive contribution to that trait
+            traits[individual * arch.ntraits + other] += expression * arch.pleioeffects[e] * (1.0 - pars.epistasis[other]);
+
+        }
+
+        // Note: Only the non-zero entries of the matrix of pleiotropic effects are
+        // visited. Interactions only use the expression level of the main trait.
+
     }
 
-    // For each edge in each individual...
-    for (size_t i = 0u; i < tedges; ++i) {
+    // If the edges are packed...
+    if (!arch.packed.empty()) {
+
+        // Number of edges decoded at a time
+        const size_t block = 4096u;
+
+        // Prepare to store the loci of a block of edges
+        std::vector<Architecture::Locus> bfrom(block), bto(block);
+
+        // For each individual...
+        for (size_t individual = 0u; individual < popsize; ++individual) {
+
+            // Decode the edges from the start
+            Unpacker unpacker(arch.packed.data(), arch.packed.size());
+
+            // For each block of edges...
+            for (size_t first = 0u; first < arch.nedges; first += block) {
+
+                // Decode it
+                const size_t n = unpacker.next(bfrom.data(), bto.data(), block);
+
+                // Check
+                assert(n == std::min(block, arch.nedges - first));
+
+                // For each edge in the block...
+                for (size_t e = 0u; e < n; ++e) {
+
+                    // Which trait is affected?
+                    const size_t traitid = arch.traitids[bfrom[e]];
+
+                    // Convert into indices for the current individual
+                    const size_t ifrom = individual * arch.nloci + bfrom[e];
+                    const size_t ito = individual * arch.nloci + bto[e];
+
+                    // Compute interaction contribution to the phenotype
+                    const double value = expressions[ifrom] * expressions[ito] * arch.weights[first + e] * pars.epistasis[traitid];
+
+                    // Add to trait value
+                    traits[individual * arch.ntraits + traitid] += value;
+
+                }
+            }
+        }
+
+        // Note: The edges are decoded again for each individual, a block small
+        // enough to stay in the fastest cache at a time, so that the expression
+        // levels of one individual are visited at a time, as with unpacked edges.
+
+    }
+
+    // For each edge in each individual (unless packed)...
+    for (size_t i = 0u; i < tedges && arch.packed.empty(); ++i) {
 
         // Edge index
         const size_t edge = i % arch.nedges;
@@ -368,17 +1095,287 @@ std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles,
 
     }
 
+    // For each run of hyperedges of the same order...
+    for (size_t first = 0u, last = 0u; first < arch.nhyper; first = last) {
+
+        // Order of the hyperedges in the run
+        const size_t K = arch.hyperstarts[first + 1u] - arch.hyperstarts[first];
+
+        // Find the end of the run
+        for (last = first + 1u; last < arch.nhyper && arch.hyperstarts[last + 1u] - arch.hyperstarts[last] == K; ++last);
+
+        // Add their contributions with the loop of the right order
+        if (K == 2u) interact<2u>(traits, expressions, pars, arch, first, last);
+        else if (K == 3u) interact<3u>(traits, expressions, pars, arch, first, last);
+        else if (K == 4u) interact<4u>(traits, expressions, pars, arch, first, last);
+        else interact<0u>(traits, expressions, pars, arch, first, last);
+
+    }
+
+    // Note: Hyperedges are grouped by order, so there are only a few runs.
+
     // Prepare an environmental noise generator
     rnd::normal getnormal(0.0, 1.0);
 
+    // Random stream of the current individual
+    rnd::Stream stream = rnd::rng.stream(rnd::noise, 0u);
+
     // For each trait value in each individual...
     for (size_t i = 0u; i < ttraits; ++i) {
 
         // Trait index
         const size_t traitid = i % arch.ntraits;
 
+        // If this is a new individual...
+        if (traitid == 0u && rnd::rng.iscounter()) {
+
+            // Move to its own stream
+            stream = rnd::rng.stream(rnd::noise, t * popsize + i / arch.ntraits);
+            getnormal.reset();
+
+        }
+
         // Add environmental noise
-        traits[i] += getnormal(rnd::rng) * pars.envnoise[traitid];
+        traits[i] += getnormal(stream) * pars.envnoise[traitid];
+
+    }
+
+    // Exit
+    return traits;
+
+}
+
+// Function to convert the matrix of alleles into a vector of trait values
+std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles, const Parameters &pars, const Architecture &arch, const size_t &N, const size_t &t) {
+
+    // alleles: vector of bitsets representing matrix of alleles
+    // pars: general hyperparameters
+    // arch: genetic architecture
+    // N: total number of alleles in the population
+    // t: generation
+
+    // Use the decoder of the right ploidy
+    if (pars.ploidy == 1u) return develop<1u>(alleles, pars, arch, N, t);
+    if (pars.ploidy == 4u) return develop<4u>(alleles, pars, arch, N, t);
+    if (pars.ploidy == 6u) return develop<6u>(alleles, pars, arch, N, t);
+    return develop<2u>(alleles, pars, arch, N, t);
+
+    // Note: The ploidy is only checked once here, so that the loop over
+    // loci in each version runs without branching on the ploidy.
+
+}
+
+// Function to update trait values after edits to the architecture
+void gen::revise(std::vector<double> &traits, const std::vector<std::bitset<64u> > &alleles, const Parameters &pars, const Architecture &arch, const Patch &patch, const size_t &N) {
+
+    // traits: trait values of all individuals (to update)
+    // alleles: vector of bitsets representing matrix of alleles
+    // pars: general hyperparameters
+    // arch: genetic architecture (before the edits)
+    // patch: edits to the architecture
+    // N: total number of alleles in the population
+
+    // Check that the patch fits the architecture
+    patch.test(arch);
+
+    // Ploidy
+    const size_t P = pars.ploidy;
+
+    // Get population size
+    const size_t popsize = N / (P * arch.nloci);
+
+    // Check
+    if (traits.size() != popsize * arch.ntraits)
+        throw std::runtime_error("Number of trait values does not match the population and the architecture");
+
+    // Parameters of the loci after the edits
+    std::vector<Architecture::Effect> effects(arch.effects.begin(), arch.effects.end());
+    std::vector<Architecture::Effect> domcoeffs(arch.domcoeffs.begin(), arch.domcoeffs.end());
+    for (size_t i = 0u; i < patch.nloci; ++i) {
+        if (!patch.effects.empty()) effects[patch.loci[i]] = patch.effects[i];
+        if (!patch.domcoeffs.empty()) domcoeffs[patch.loci[i]] = patch.domcoeffs[i];
+    }
+
+    // Which loci change their expression levels (through their dominance coefficients)
+    std::vector<bool> reexpressed(arch.nloci, false);
+    for (size_t l : patch.loci) reexpressed[l] = domcoeffs[l] != arch.domcoeffs[l];
+
+    // New weight of each patched edge
+    std::unordered_map<size_t, Architecture::Effect> weights;
+    for (size_t i = 0u; i < patch.nedges; ++i) weights[patch.edges[i]] = patch.weights[i];
+
+    // Prepare to store the touched edges (loci, old and new weights)
+    std::vector<std::pair<size_t, size_t> > touched;
+    std::vector<std::pair<double, double> > changes;
+
+    // Function to record an edge if it is touched
+    auto visit = [&](const size_t &e, const size_t &from, const size_t &to) {
+
+        // Find its new weight
+        const auto it = weights.find(e);
+        const double weight = it != weights.end() ? it->second : arch.weights[e];
+
+        // Skip if neither its weight nor the expression of its loci change
+        if (it == weights.end() && !reexpressed[from] && !reexpressed[to]) return;
+
+        // Record it
+        touched.emplace_back(from, to);
+        changes.emplace_back(arch.weights[e], weight);
+
+    };
+
+    // Go through the edges once, decoding them if they are packed
+    if (!arch.packed.empty()) {
+        const size_t block = 4096u;
+        std::vector<Architecture::Locus> bfrom(block), bto(block);
+        Unpacker unpacker(arch.packed.data(), arch.packed.size());
+        for (size_t first = 0u; first < arch.nedges; first += block) {
+            const size_t n = unpacker.next(bfrom.data(), bto.data(), block);
+            for (size_t e = 0u; e < n; ++e) visit(first + e, bfrom[e], bto[e]);
+        }
+    }
+    else for (size_t e = 0u; e < arch.nedges; ++e) visit(e, arch.from[e], arch.to[e]);
+
+    // Note: Edges with a locus whose dominance coefficient changes are touched
+    // too, as the expression level of that locus changes.
+
+    // Prepare to store the hyperedges touched in the same way
+    std::vector<size_t> hypertouched;
+    for (size_t h = 0u; h < arch.nhyper; ++h)
+        for (size_t e = arch.hyperstarts[h]; e < arch.hyperstarts[h + 1u]; ++e)
+            if (reexpressed[arch.hyperloci[e]]) { hypertouched.push_back(h); break; }
+
+    // For each individual...
+    for (size_t individual = 0u; individual < popsize; ++individual) {
+
+        // Function to compute the expression level of a locus, with a given dominance coefficient
+        auto express = [&](const size_t &locus, const double &domcoeff) {
+
+            // Get genotype (number of 1-alleles)
+            const size_t genotype = std::popcount(bit::get(alleles, P * (individual * arch.nloci + locus)) & ((1ull << P) - 1u));
+
+            // Translate it into expression level, with dominance deviation for heterozygotes
+            const size_t traitid = arch.traitids[locus];
+            return 2.0 * genotype / P - 1.0 + (genotype > 0u && genotype < P) * domcoeff * pars.dominance[traitid];
+
+        };
+
+        // Trait values of the individual
+        double *y = traits.data() + individual * arch.ntraits;
+
+        // For each patched locus...
+        for (size_t l : patch.loci) {
+
+            // Which trait is affected?
+            const size_t traitid = arch.traitids[l];
+
+            // Replace its additive contribution
+            const double before = express(l, arch.domcoeffs[l]) * arch.effects[l];
+            const double after = express(l, domcoeffs[l]) * effects[l];
+            y[traitid] += (after - before) * (1.0 - pars.epistasis[traitid]);
+
+        }
+
+        // For each touched edge...
+        for (size_t e = 0u; e < touched.size(); ++e) {
+
+            // Its loci and the trait they affect
+            const size_t from = touched[e].first;
+            const size_t to = touched[e].second;
+            const size_t traitid = arch.traitids[from];
+
+            // Replace its interaction contribution
+            const double before = express(from, arch.domcoeffs[from]) * express(to, arch.domcoeffs[to]) * changes[e].first;
+            const double after = express(from, domcoeffs[from]) * express(to, domcoeffs[to]) * changes[e].second;
+            y[traitid] += (after - before) * pars.epistasis[traitid];
+
+        }
+
+        // For each touched hyperedge...
+        for (size_t h : hypertouched) {
+
+            // Multiply the expression levels of its loci, before and after
+            double before = arch.hyperweights[h], after = arch.hyperweights[h];
+            for (size_t e = arch.hyperstarts[h]; e < arch.hyperstarts[h + 1u]; ++e) {
+                const size_t l = arch.hyperloci[e];
+                before *= express(l, arch.domcoeffs[l]);
+                after *= express(l, domcoeffs[l]);
+            }
+
+            // Replace its interaction contribution
+            const size_t traitid = arch.traitids[arch.hyperloci[arch.hyperstarts[h]]];
+            y[traitid] += (after - before) * pars.epistasis[traitid];
+
+        }
+    }
+
+    // Note: This takes time proportional to the population size times the
+    // number of touched loci and edges (plus one pass through the edges to
+    // find them), instead of the whole architecture. Environmental noise is
+    // already part of the trait values and stays as it is. The architecture
+    // itself is left as it is (see Patch::apply).
+
+}
+
+// Function to read trait values saved by a previous run
+std::vector<double> gen::reload(const std::string &filename, const size_t &ntraits, std::vector<size_t> &demes) {
+
+    // filename: name of the file to read
+    // ntraits: number of traits per individual
+    // demes: deme of each individual (to fill in, if there is a deme column)
+
+    // Create input file stream
+    std::ifstream file(filename);
+
+    // Check that it is open
+    if (!file.is_open())
+        throw std::runtime_error("Unable to open file " + filename);
+
+    // Read header
+    std::string line;
+    std::getline(file, line);
+
+    // Check whether there is a deme column
+    const bool hasdemes = line.rfind("id,deme,", 0u) == 0u;
+
+    // Prepare to store trait values
+    std::vector<double> traits;
+    demes.clear();
+
+    // For each line in the file...
+    while (std::getline(file, line)) {
+
+        // Parse line as CSV
+        std::stringstream stream(line);
+        std::string token;
+
+        // Skip the identifier column
+        if (!std::getline(stream, token, ','))
+            throw std::runtime_error("Invalid format in file " + filename);
+
+        // Read the deme column if any
+        if (hasdemes && !std::getline(stream, token, ','))
+            throw std::runtime_error("Invalid format in file " + filename);
+
+        // Number of trait values read so far
+        const size_t n = traits.size();
+
+        try {
+
+            // Record the deme if needed
+            if (hasdemes) demes.push_back(std::stoul(token));
+
+            // Read trait values
+            while (std::getline(stream, token, ',')) traits.push_back(std::stod(token));
+
+        }
+        catch (const std::exception&) {
+            throw std::runtime_error("Invalid format in file " + filename);
+        }
+
+        // Check that there is one value per trait
+        if (traits.size() - n != ntraits)
+            throw std::runtime_error("Incorrect number of trait values read from file " + filename);
 
     }
 
@@ -388,11 +1385,12 @@ std::vector<double> gen::develop(const std::vector<std::bitset<64u> > &alleles,
 }
 
 // Function to save trait values to file
-void stf::saveTraits(const std::vector<double> &traits, const size_t &ntraits, const std::string &filename) {
+void stf::saveTraits(const std::vector<double> &traits, const size_t &ntraits, const std::string &filename, const std::vector<size_t> &demes) {
 
     // traits: vector of trait values
     // ntraits: number of traits per individual
     // filename: name of the file to save
+    // demes: deme of each individual (no deme column if empty)
 
     // Check
     assert(traits.size() % ntraits == 0u);
@@ -406,6 +1404,7 @@ void stf::saveTraits(const std::vector<double> &traits, const size_t &ntraits, c
 
     // Header
     file << "id,";
+    if (!demes.empty()) file << "deme,";
 
     // For each trait...
     for (size_t j = 0u; j < ntraits; ++j) {
@@ -423,8 +1422,9 @@ void stf::saveTraits(const std::vector<double> &traits, const size_t &ntraits, c
     // For each trait in each individual...
     for (size_t i = 0u; i < ntraits * popsize; ++i) {
 
-        // Write individual identifier to file
+        // Write individual identifier (and deme if needed) to file
         if (i % ntraits == 0u) file << i / ntraits + 1u << ',';
+        if (i % ntraits == 0u && !demes.empty()) file << demes[i / ntraits] << ',';
 
         // Write trait value to file
         file << traits[i];
@@ -445,22 +1445,24 @@ void stf::saveTraits(const std::vector<double> &traits, const size_t &ntraits, c
 }
 
 // Function to save matrix of alleles to file
-void stf::saveAlleles(std::vector<std::bitset<64u> > &alleles, const size_t &popsize, const size_t &nloci, const std::string &filename, const bool &binary) {
+void stf::saveAlleles(std::vector<std::bitset<64u> > &alleles, const size_t &popsize, const size_t &nloci, const std::string &filename, const bool &binary, const std::vector<size_t> &demes, const size_t &ploidy) {
 
     // alleles: vector of bitsets representing matrix of alleles
     // popsize: total number of individuals in the population
     // nloci: number of loci in the genome
     // filename: name of the file to save
     // binary: whether to save in binary (if not, CSV)
+    // demes: deme of each individual (no deme column if empty, or in binary)
+    // ploidy: number of alleles per locus
 
     // Number of bits per bitset
     const size_t n = 64u;
 
     // Total number of alleles in the population
-    const size_t N = popsize * nloci * 2u;
+    const size_t N = popsize * nloci * ploidy;
 
     // Make sure that the trailing bits are zeros
-    for (size_t i = 0u; i < N % n; ++i)
+    for (size_t i = N % n; i < n; ++i)
         alleles.back().reset(i);
 
     // Create output file stream
@@ -500,6 +1502,7 @@ void stf::saveAlleles(std::vector<std::bitset<64u> > &alleles, const size_t &pop
 
         // First write a header
         file << "id,";
+        if (!demes.empty()) file << "deme,";
 
         // For each locus...
         for (size_t i = 0u; i < nloci; ++i) {
@@ -511,28 +1514,26 @@ void stf::saveAlleles(std::vector<std::bitset<64u> > &alleles, const size_t &pop
 
         }
 
-        // Note: If saving as CSV, we save the combined genotype (0, 1 or 2),
-        // not the alleles separately.
+        // Note: If saving as CSV, we save the combined genotype (e.g. 0, 1 or 2
+        // in diploids), not the alleles separately.
 
         // For each locus in each individual...
         for (size_t i = 0u; i < nloci * popsize; ++i) {
 
-            // Write individual identifier to file
+            // Write individual identifier (and deme if needed) to file
             if (i % nloci == 0u) file << i / nloci + 1u << ',';
+            if (i % nloci == 0u && !demes.empty()) file << demes[i / nloci] << ',';
 
-            // Find the two haplotypes in the bitsets
-            const size_t j = i / 2u;
-            const size_t k = j + 1u;
-
-            // Extract alleles
-            const bool a = alleles[j / n].test(j % n);
-            const bool b = alleles[k / n].test(k % n);
+            // Count the 1-alleles among the haplotypes, next to each other in the bitsets
+            size_t genotype = 0u;
+            for (size_t j = ploidy * i; j < ploidy * (i + 1u); ++j)
+                genotype += alleles[j / n].test(j % n);
 
             // Check
-            assert(a + b <= 2u);
+            assert(genotype <= ploidy);
 
             // Write combined genotype to file
-            file << a + b;
+            file << genotype;
 
             // Right separator
             if (i % nloci == nloci - 1u) file << '\n';
@@ -584,6 +1585,9 @@ void doMain(const std::vector<std::string> &args) {
     // Create parameters (from file if needed)
     Parameters pars(parfile);
 
+    // Use the requested level of validation from now on
+    chk::validation = pars.validation;
+
     // Check
     pars.check();
 
@@ -593,20 +1597,87 @@ void doMain(const std::vector<std::string> &args) {
     // Verbose if needed
     if (args.size() == 2u) std::cout << "Parameters read in succesfully\n";
 
-    // Seed the random number generator
+    // Choose the engine of the random number generator and seed it
+    rnd::rng.use(pars.rng);
     rnd::rng.seed(pars.seed);
 
+    // File to read the architecture from (in the format it is saved in)
+    const std::string loadfile = pars.binarch ? "architecture.dat" : "architecture.txt";
+
     // Create a simple genetic architecture or read from file if needed
-    Architecture arch(pars.loadarch ? "architecture.txt" : "");
+    Architecture arch(pars.loadarch ? loadfile : "", pars.nthreads);
 
     // Check that the architecture is compatible with the parameters
     if (pars.loadarch) arch.test(pars);
 
-    // For each replicate...
-    for (size_t k = 0u; k < pars.nrepl; ++k) {
+    // Prepare a cache of generated architectures
+    Cache cache("archcache", pars.cachesize);
+
+    // Read edits to make to the architecture if needed
+    const Patch patch(pars.patcharch ? "patch.txt" : "");
+
+    // Partnering weights of each trait, reused by the replicates
+    std::vector<Powers> powers;
+
+    // Replicates to run (all of them by default)
+    std::vector<size_t> replicates = pars.replicates;
+    if (replicates.empty())
+        for (size_t k = 1u; k <= pars.nrepl; ++k) replicates.push_back(k);
+
+    // For each replicate to run...
+    for (size_t r : replicates) {
+
+        // Index of the replicate
+        const size_t k = r - 1u;
+
+        // Check
+        assert(k < pars.nrepl);
+
+        // Move the random streams to the current replicate
+        rnd::rng.replicate(k);
+
+        // Note: Each replicate has its own streams, so running only some of
+        // the replicates reproduces exactly what they give in a full run.
+
+        // If the architecture must be written to file as it is generated...
+        if (pars.streamarch) {
+
+            // Generate it straight into its file
+            arch.stream(pars, addrepl("architecture", pars.binarch ? "dat" : "txt", k, pars.nrepl > 1u), pars.binarch);
 
-        // Simulate a (complicated) genetic architecture if needed
-        if (!pars.loadarch) arch.generate(pars);
+            // Verbose if needed
+            if (pars.verbose) std::cout << "Replicate " << k + 1u << " of " << pars.nrepl << '\n';
+            if (pars.verbose) std::cout << "Genetic architecture streamed to file\n";
+
+            // Note: The edges are not kept in memory, so there is no population
+            // to simulate. This is meant for architectures too large for memory.
+
+            // Move on to the next replicate
+            continue;
+
+        }
+
+        // Whether the architecture was found in the cache
+        bool cached = false;
+
+        // Simulate a (complicated) genetic architecture if needed (and not cached)
+        if (!pars.loadarch && pars.archcache) {
+
+            // Key of the architecture of the replicate
+            const std::string key = cache.key(pars, k);
+
+            // Load it, or generate it and keep it for next time
+            cached = cache.fetch(arch, key);
+            if (!cached) {
+                arch.generate(pars, powers);
+                cache.store(arch, key);
+            }
+        }
+        else if (!pars.loadarch) arch.generate(pars, powers);
+
+        // Compress the edges or expand them, as requested (e.g. if read from file)
+        if (pars.packedges) arch.pack();
+        else arch.unpack();
 
         // If needed...
         if (pars.verbose) {
@@ -614,29 +1685,61 @@ void doMain(const std::vector<std::string> &args) {
             // Verbose
             std::cout << "Replicate " << k + 1u << " of " << pars.nrepl << '\n';
             std::cout << "Genetic architecture ";
-            std::cout << (pars.loadarch ? "read in" : "generated");
+            std::cout << (pars.loadarch ? "read in" : cached ? "loaded from cache" : "generated");
             std::cout << " successfully\n";
 
         }
 
+        // If trait values of a previous run must be updated for edits to the architecture...
+        if (pars.patcharch) {
+
+            // Total number of alleles
+            const size_t N = pars.popsize * arch.nloci * pars.ploidy;
+
+            // Read the genotypes of the previous run
+            std::vector<std::bitset<64u> > alleles(N / 64u + 1u);
+            gen::import(alleles, addrepl("genotypes", "csv", k, pars.nrepl > 1u), N, pars.ploidy);
+
+            // Read its trait values (and demes, if any)
+            std::vector<size_t> demes;
+            std::vector<double> traits = gen::reload(addrepl("traits", "csv", k, pars.nrepl > 1u), pars.ntraits, demes);
+
+            // Update them for the touched loci and edges only
+            gen::revise(traits, alleles, pars, arch, patch, N);
+
+            // Save them
+            stf::saveTraits(traits, pars.ntraits, addrepl("traits_patched", "csv", k, pars.nrepl > 1u), demes);
+
+            // Verbose if needed
+            if (pars.verbose) std::cout << "Trait values patched successfully\n";
+
+            // Note: No population is simulated. The trait values are those
+            // that a run with the patched architecture would give, with the
+            // same genotypes and environmental noise.
+
+            // Move on to the next replicate
+            continue;
+
+        }
+
         // Current parameters
         Parameters parsk = pars;
 
         // Override general parameters if needed
         parsk.override(arch);
 
-        // Check
-        arch.check();
-        parsk.check();
+        // Note: Both the architecture and the parameters have just been
+        // checked (upon generating or reading, and upon overriding).
 
         // Output file name
-        const std::string archfile = addrepl("architecture", "txt", k, pars.nrepl > 1u);
+        const std::string archfile = addrepl("architecture", pars.binarch ? "dat" : "txt", k, pars.nrepl > 1u);
 
         // Save the architecture if needed
-        if (pars.savearch) arch.save(archfile);
+        if (pars.savearch && pars.binarch) arch.savebinary(archfile);
+        else if (pars.savearch) arch.save(archfile);
 
         // Total number of bits needed
-        const size_t N = pars.popsize * pars.nloci * 2u;
+        const size_t N = pars.popsize * pars.nloci * pars.ploidy;
 
         // Number of bitsets needed
         const size_t n = N / 64u;
@@ -647,29 +1750,62 @@ void doMain(const std::vector<std::string> &args) {
         // Note: The size of a bitset must be hard-coded in C++.
         
         // Import matrix of alleles if needed
-        if (pars.import) gen::import(alleles, "genotypes.csv", N);
+        if (pars.import) gen::import(alleles, "genotypes.csv", N, pars.ploidy);
+
+        // Throw mutations, with locus-specific rates or demes if needed
+        if (pars.ndemes > 1u) gen::structure(alleles, gen::frequencies(parsk), parsk);
+        else if (pars.sampling == 4u) gen::sample(alleles, gen::frequencies(parsk), pars.popsize, pars.ploidy);
+        else if (pars.sampling == 5u) gen::mosaic(alleles, gen::frequencies(parsk), pars.popsize, pars.ploidy, pars.nfounders, pars.switchrate);
+        else if (pars.spectrum == 0u) gen::mutate(alleles, pars.mutation, N, pars.sampling, pars.ratio);
+        else gen::mutate(alleles, gen::frequencies(parsk), pars.popsize, pars.ploidy);
+
+        // Deme of each individual (if several)
+        std::vector<size_t> demes;
+        if (pars.ndemes > 1u)
+            for (size_t d = 0u; d < pars.ndemes; ++d)
+                demes.insert(demes.end(), pars.demesizes[d], d + 1u);
+
+        // Prepare a second matrix of alleles to build offspring into, if needed
+        std::vector<std::bitset<64u> > buffer(pars.ngenerations > 0u ? alleles.size() : 0u);
+
+        // For each generation...
+        for (size_t t = 0u; t < pars.ngenerations; ++t) {
+
+            // Save the trait values of the current generation if needed
+            if (!pars.lastonly) {
+                const std::string genfile = addrepl("traits_gen" + std::to_string(t), "csv", k, pars.nrepl > 1u);
+                stf::saveTraits(gen::develop(alleles, pars, arch, N, t), pars.ntraits, genfile, demes);
+            }
 
-        // Throw mutations
-        gen::mutate(alleles, pars.mutation, N, pars.sampling, pars.ratio);
+            // Replace the population by its offspring
+            gen::reproduce(alleles, buffer, parsk, t);
+
+        }
 
         // Develop genotypes into phenotypes
-        const std::vector<double> traits = gen::develop(alleles, pars, arch, N);
+        const std::vector<double> traits = gen::develop(alleles, pars, arch, N, pars.ngenerations);
 
         // Output file name
         const std::string traitfile = addrepl("traits", "csv", k, pars.nrepl > 1u);
 
         // Save trait values to file
-        stf::saveTraits(traits, pars.ntraits, traitfile);
+        stf::saveTraits(traits, pars.ntraits, traitfile, demes);
         
         // Output file name
         const std::string genfile = addrepl("genotypes", "csv", k, pars.nrepl > 1u);
         const std::string allfile = addrepl("alleles", "dat", k, pars.nrepl > 1u);
 
         // Save matrix of alleles if needed
-        stf::saveAlleles(alleles, pars.popsize, pars.nloci, pars.binary ? allfile : genfile, pars.binary);
+        stf::saveAlleles(alleles, pars.popsize, pars.nloci, pars.binary ? allfile : genfile, pars.binary, demes, pars.ploidy);
         
         // Verbose if needed
         if (pars.verbose) std::cout << "Population generated successfully\n";
 
     }
+
+    // Report on the use of the cache if needed
+    if (pars.verbose && pars.archcache && !pars.loadarch) {
+        std::cout << "Architecture cache: " << cache.nhits() << " hits, " << cache.nmisses() << " misses";
+        std::cout << ", " << cache.nevicted() << " evicted\n";
+    }
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 #include "parameters.hpp"
 #include "architecture.hpp"
+#include "patch.hpp"
+#include "random.hpp"
 #include <vector>
 #include <string>
 #include <bitset>
@@ -15,10 +17,10 @@ namespace stf {
     // Note: This is handy in testing.
 
     // Function to save trait values to file
-    void saveTraits(const std::vector<double>&, const size_t&, const std::string&);
+    void saveTraits(const std::vector<double>&, const size_t&, const std::string&, const std::vector<size_t>& = {});
 
     // Function to save matrix of alleles to file
-    void saveAlleles(std::vector<std::bitset<64u> >&, const size_t&, const size_t&, const std::string&, const bool& = false);
+    void saveAlleles(std::vector<std::bitset<64u> >&, const size_t&, const size_t&, const std::string&, const bool& = false, const std::vector<size_t>& = {}, const size_t& = 2u);
 
 }
 
@@ -26,13 +28,45 @@ namespace stf {
 namespace gen {
 
     // Function to import matrix of alleles from file
-    void import(std::vector<std::bitset<64u> >&, const std::string&, const size_t&);
+    void import(std::vector<std::bitset<64u> >&, const std::string&, const size_t&, const size_t& = 2u);
+
+    // Function to sample allele frequencies across loci
+    std::vector<double> frequencies(const Parameters&);
 
     // Function to throw mutations into the matrix of alleles
     void mutate(std::vector<std::bitset<64u> >&, const double&, const size_t&, const size_t&, const double& = 0.25);
 
+    // Function to throw mutations with locus-specific rates
+    void mutate(std::vector<std::bitset<64u> >&, const std::vector<double>&, const size_t&, const size_t& = 2u);
+
+    // Function to sample genotypes directly from locus-specific frequencies
+    void sample(std::vector<std::bitset<64u> >&, const std::vector<double>&, const size_t&, const size_t& = 2u, rnd::Generator& = rnd::rng);
+
+    // Function to sample haplotypes as mosaics of blocks copied from founders
+    void mosaic(std::vector<std::bitset<64u> >&, const std::vector<double>&, const size_t&, const size_t&, const size_t&, const double&, rnd::Generator& = rnd::rng);
+
+    // Function to sample the genotypes of a population structured in demes
+    void structure(std::vector<std::bitset<64u> >&, const std::vector<double>&, const Parameters&);
+
+    // Function to replace the population by its offspring
+    void reproduce(std::vector<std::bitset<64u> >&, std::vector<std::bitset<64u> >&, const Parameters&, const size_t&);
+
+    // Function to add the contributions of a run of hyperedges of the same order to trait values
+    template <size_t K>
+    void interact(std::vector<double>&, const std::vector<double>&, const Parameters&, const Architecture&, const size_t&, const size_t&);
+
+    // Function to convert the matrix of alleles into a vector of trait values (for a given ploidy)
+    template <size_t P>
+    std::vector<double> develop(const std::vector<std::bitset<64u> >&, const Parameters&, const Architecture&, const size_t&, const size_t& = 0u);
+
     // Function to convert the matrix of alleles into a vector of trait values
-    std::vector<double> develop(const std::vector<std::bitset<64u> >&, const Parameters&, const Architecture&, const size_t&);
+    std::vector<double> develop(const std::vector<std::bitset<64u> >&, const Parameters&, const Architecture&, const size_t&, const size_t& = 0u);
+
+    // Function to update trait values after edits to the architecture
+    void revise(std::vector<double>&, const std::vector<std::bitset<64u> >&, const Parameters&, const Architecture&, const Patch&, const size_t&);
+
+    // Function to read trait values saved by a previous run
+    std::vector<double> reload(const std::string&, const size_t&, std::vector<size_t>&);
     
 }
 
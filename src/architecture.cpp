@@ -5,29 +5,161 @@
 #include "checker.hpp"
 #include "parameters.hpp"
 #include "random.hpp"
+#include "sampler.hpp"
+#include "mapping.hpp"
+#include "packing.hpp"
+#include <thread>
+#include <unordered_map>
+#include <string_view>
+#include <exception>
+#include <algorithm>
+#include <unordered_set>
+#include <set>
+#include <numeric>
+#include <limits>
+#include <cstring>
+#include <filesystem>
+
+// Smallest number of bytes of a line of values for it to be parsed in parallel
+constexpr size_t longline = 1048576u;
+
+// Function to parse a long line of values in parallel
+template <typename T>
+void parallelize(const ReadPars &reader, const std::string_view &line, std::vector<T> &values, const size_t &n, const std::function<std::string(const T&)> &check, const size_t &nthreads) {
+
+    // reader: reader at the line, used to report errors
+    // line: the values in the line (after the parameter name)
+    // values: vector to read into
+    // n: number of values to read
+    // check: function used to check individual values
+    // nthreads: number of threads to use
+
+    // Function to tell if a character is whitespace (as in the default locale)
+    auto blank = [](const char &c) { return c == ' ' || (c >= '\t' && c <= '\r'); };
+
+    // Split the line into one chunk per thread, each ending at whitespace
+    std::vector<size_t> bounds(nthreads + 1u, line.size());
+    bounds[0u] = 0u;
+    for (size_t t = 1u; t < nthreads; ++t) {
+        bounds[t] = std::max(bounds[t - 1u], t * line.size() / nthreads);
+        while (bounds[t] < line.size() && !blank(line[bounds[t]])) ++bounds[t];
+    }
+
+    // Note: A chunk thus never cuts through a value.
+
+    // Function to run a task on each chunk, one per thread
+    auto run = [&](const auto &task) {
+        std::vector<std::thread> threads;
+        threads.reserve(nthreads);
+        for (size_t t = 0u; t < nthreads; ++t) threads.emplace_back(task, t);
+        for (std::thread &thread : threads) thread.join();
+    };
+
+    // Count the values in each chunk
+    std::vector<size_t> starts(nthreads + 1u, 0u);
+    run([&](const size_t &t) {
+        for (size_t i = bounds[t]; i < bounds[t + 1u]; ++i)
+            starts[t + 1u] += !blank(line[i]) && (i == 0u || blank(line[i - 1u]));
+    });
+
+    // Turn the counts into the position of the first value of each chunk
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+    const size_t total = starts.back();
+
+    // Make room for all of them
+    values.resize(total);
+
+    // Prepare to record the first problem met in each chunk (the index of the value, what happened and the message of the check)
+    const size_t none = std::numeric_limits<size_t>::max();
+    std::vector<size_t> failures(nthreads, none);
+    std::vector<int> kinds(nthreads, 0);
+    std::vector<std::string> messages(nthreads);
+
+    // Parse the values of each chunk into place
+    run([&](const size_t &t) {
+
+        // Message of the check
+        std::string message;
+
+        // For each value in the chunk...
+        for (size_t i = bounds[t], k = starts[t]; i < bounds[t + 1u]; ++k) {
+
+            // Find its bounds
+            while (i < bounds[t + 1u] && blank(line[i])) ++i;
+            if (i == bounds[t + 1u]) break;
+            const size_t first = i;
+            while (i < bounds[t + 1u] && !blank(line[i])) ++i;
+            const std::string_view word = line.substr(first, i - first);
+
+            // Stop at the first problem
+            if (!ReadPars::isword(word)) { failures[t] = k; kinds[t] = 0; break; }
+            if (!ReadPars::convert(word, values[k])) { failures[t] = k; kinds[t] = 1; break; }
+            if (check) message = check(values[k]);
+            if (!message.empty()) { failures[t] = k; kinds[t] = 2; messages[t] = message; break; }
+
+        }
+    });
+
+    // Find the first problem in the line
+    size_t t = 0u;
+    while (t < nthreads && failures[t] == none) ++t;
+    size_t failure = t < nthreads ? failures[t] : none;
+    int kind = t < nthreads ? kinds[t] : 0;
+
+    // Whitespace at the end of the line is read as a missing value
+    if (failure == none && !line.empty() && blank(line.back())) failure = total;
+
+    // Report it as if the values had been read one by one
+    if (failure < n) {
+        if (kind == 0) throw std::runtime_error(reader.errorReadValue());
+        if (kind == 1) throw std::runtime_error(reader.errorParseValue());
+        reader.checkerror(messages[t]);
+    }
+
+    // Error if the number of values is wrong
+    if (failure != none || total > n) throw std::runtime_error(reader.errorTooManyValues());
+    if (total < n) throw std::runtime_error(reader.errorTooFewValues());
+
+    // Note: The values are checked in the same way and give the same errors
+    // as when read by the reader, but several chunks are parsed at the same
+    // time, which speeds up the reading of large architectures.
+
+}
 
 // Constructor
-Architecture::Architecture(const std::string& archfile) :
+Architecture::Architecture(const std::string& archfile, const size_t &nthreads) :
     nloci(10u),
     nedges(0u),
     ntraits(1u),
+    npleio(0u),
+    nhyper(0u),
     traitids(nloci, 0u),
     effects(nloci, 0.0),
     domcoeffs(nloci, 0.0),
+    pleiostarts(),
+    pleiotraits(),
+    pleioeffects(),
+    pleiodomcoeffs(),
     from(nedges, 0u),
     to(nedges, 0u),
     weights(nedges, 0.0),
+    packed(),
+    hyperstarts(),
+    hyperloci(),
+    hyperweights(),
     nlocipertrait(ntraits, nloci),
-    nedgespertrait(ntraits, nedges)
+    nedgespertrait(ntraits, nedges),
+    nhyperpertrait(ntraits, nhyper)
 {
 
     // archfile: (optional) name of the file to read from
+    // nthreads: (optional) maximum number of threads to read it on (all cores if zero)
 
     // Note: Keep the default to no edges, so that the user can stick to
     // that by not supplying any in the architecture file.
     
     // Either read of generate an architecture
-    if (archfile != "") read(archfile);
+    if (archfile != "") read(archfile, nthreads);
 
     // Check
     check();
@@ -35,9 +167,16 @@ Architecture::Architecture(const std::string& archfile) :
 }
 
 // Function to read a genetic architecture from a file
-void Architecture::read(const std::string& filename) {
+void Architecture::read(const std::string& filename, const size_t &nthreads) {
 
     // filename: name of the file to read from
+    // nthreads: maximum number of threads to use (all cores if zero)
+
+    // Read the file as binary if it is in that format
+    if (isbinary(filename)) {
+        readbinary(filename);
+        return;
+    }
 
     // Create a reader
     ReadPars reader(filename);
@@ -45,6 +184,61 @@ void Architecture::read(const std::string& filename) {
     // Open it
     reader.open();
 
+    // Number of threads to use
+    const size_t ncores = nthreads > 0u ? nthreads : std::max(1u, std::thread::hardware_concurrency());
+
+    // Map the file into memory if it may have long lines to parse in parallel
+    Mapping mapping;
+    if (ncores > 1u && std::filesystem::file_size(filename) > longline) mapping.open(filename);
+    const std::string_view contents(mapping.data(), mapping.size());
+
+    // Prepare to find where the values of each long line are
+    std::unordered_map<size_t, std::string_view> lines;
+
+    // For each line of the file...
+    for (size_t start = 0u, count = 1u; start < contents.size(); ++count) {
+
+        // Find where it ends
+        const size_t end = std::min(contents.find('\n', start), contents.size());
+
+        // If it is long...
+        if (end - start > longline) {
+
+            // Skip the parameter name
+            size_t first = start;
+            while (first < end && std::isspace(static_cast<unsigned char>(contents[first]))) ++first;
+            while (first < end && !std::isspace(static_cast<unsigned char>(contents[first]))) ++first;
+
+            // Record where the values are
+            lines[count] = contents.substr(first, end - first);
+
+        }
+
+        // Move on to the next line
+        start = end + 1u;
+
+    }
+
+    // Note: Lines are found in the mapped file at once, and each long line is
+    // then parsed in chunks on several threads when the reader comes to it.
+    // The reader itself only skips through those lines.
+
+    // Prepare to read the locus of each pleiotropic effect
+    std::vector<size_t> pleioloci;
+
+    // Prepare to read the order of each hyperedge
+    std::vector<size_t> hyperorders;
+
+    // Reset packed edges, pleiotropic effects and hyperedges
+    packed.clear();
+    npleio = 0u;
+    pleiotraits.clear();
+    pleioeffects.clear();
+    pleiodomcoeffs.clear();
+    nhyper = 0u;
+    hyperloci.clear();
+    hyperweights.clear();
+
         // For each line in the file...
     while (!reader.iseof()) {
 
@@ -64,25 +258,53 @@ void Architecture::read(const std::string& filename) {
         // Current parameter name 
         std::string name = reader.getname();
 
+        // Where the values of the line are, if it is long
+        const auto it = lines.find(reader.getcount());
+
+        // Whether it has been parsed in parallel
+        bool parallel = false;
+
+        // Function to read many values, in parallel if the line is long
+        auto readmany = [&](auto &values, const size_t &n, const auto &check) {
+            typedef typename std::decay_t<decltype(values)>::value_type T;
+            std::vector<T> parsed;
+            if (it == lines.end()) reader.readvalues<T>(parsed, n, check);
+            else {
+                parallelize<T>(reader, it->second, parsed, n, check, ncores);
+                parallel = true;
+            }
+            values = std::move(parsed);
+        };
+
         // Read the parameter value(s)
         if (name == "nloci") reader.readvalue<size_t>(nloci, chk::strictpos<size_t>);
         else if (name == "nedges") reader.readvalue<size_t>(nedges);
         else if (name == "ntraits") reader.readvalue<size_t>(ntraits, chk::strictpos<size_t>);
-        else if (name == "traitids") reader.readvalues<size_t>(traitids, nloci, chk::strictpos<size_t>);
-        else if (name == "effects") reader.readvalues<double>(effects, nloci);
-        else if (name == "domcoeffs") reader.readvalues<double>(domcoeffs, nloci);
-        else if (name == "from") reader.readvalues<size_t>(from, nedges, chk::strictpos<size_t>);
-        else if (name == "to") reader.readvalues<size_t>(to, nedges, chk::strictpos<size_t>);
-        else if (name == "weights") reader.readvalues<double>(weights, nedges);
+        else if (name == "traitids") readmany(traitids, nloci, chk::strictpos<Trait>);
+        else if (name == "effects") readmany(effects, nloci, nullptr);
+        else if (name == "domcoeffs") readmany(domcoeffs, nloci, nullptr);
+        else if (name == "npleio") reader.readvalue<size_t>(npleio);
+        else if (name == "pleioloci") reader.readvalues<size_t>(pleioloci, npleio, chk::strictpos<size_t>);
+        else if (name == "pleiotraits") readmany(pleiotraits, npleio, chk::strictpos<Trait>);
+        else if (name == "pleioeffects") readmany(pleioeffects, npleio, nullptr);
+        else if (name == "pleiodomcoeffs") readmany(pleiodomcoeffs, npleio, nullptr);
+        else if (name == "from") readmany(from, nedges, chk::strictpos<Locus>);
+        else if (name == "to") readmany(to, nedges, chk::strictpos<Locus>);
+        else if (name == "weights") readmany(weights, nedges, nullptr);
+        else if (name == "nhyper") reader.readvalue<size_t>(nhyper);
+        else if (name == "hyperorders") reader.readvalues<size_t>(hyperorders, nhyper, chk::atleasttwo<size_t>);
+        else if (name == "hyperloci") readmany(hyperloci, std::accumulate(hyperorders.begin(), hyperorders.end(), size_t(0u)), chk::strictpos<Locus>);
+        else if (name == "hyperweights") readmany(hyperweights, nhyper, nullptr);
         else
             reader.readerror();
 
         // Note: Edge-specific parameters may be absent from the architecture file,
-        // which will stand for no edges. All other parameters must be supplied,
-        // and their dimensions must be consistent with the hyperparameters.
+        // which will stand for no edges (and likewise for pleiotropic effects
+        // and hyperedges). All other parameters must be supplied, and their
+        // dimensions must be consistent with the hyperparameters.
 
-        // Check that we have reached the end of the line
-        assert(reader.iseol());
+        // Check that we have reached the end of the line (unless it was parsed in parallel)
+        assert(parallel || reader.iseol());
  
     }
 
@@ -95,6 +317,10 @@ void Architecture::read(const std::string& filename) {
     // Check more specific features of the parameters
     if (ntraits > nloci) throw std::runtime_error("Too many traits for the number of loci in file " + filename);
 
+    // Check that indices fit in the types they are stored in
+    if (nloci > std::numeric_limits<Locus>::max()) throw std::runtime_error("Too many loci to be indexed in file " + filename);
+    if (ntraits > std::numeric_limits<Trait>::max()) throw std::runtime_error("Too many traits to be indexed in file " + filename);
+
     // Check that all vectors have the right size
     if (traitids.size() != nloci) throw std::runtime_error("Number of encoded traits does not match number of loci in file " + filename);
     if (effects.size() != nloci) throw std::runtime_error("Number of effects does not match number of loci in file " + filename);
@@ -102,14 +328,22 @@ void Architecture::read(const std::string& filename) {
     if (from.size() != nedges) throw std::runtime_error("Number of start loci does not match number of edges in file " + filename);
     if (to.size() != nedges) throw std::runtime_error("Number of end loci does not match number of edges in file " + filename);
     if (weights.size() != nedges) throw std::runtime_error("Number of interaction weights does not match number of edges in file " + filename);
+    if (pleioloci.size() != npleio) throw std::runtime_error("Number of pleiotropic loci does not match number of pleiotropic effects in file " + filename);
+    if (pleiotraits.size() != npleio) throw std::runtime_error("Number of pleiotropic traits does not match number of pleiotropic effects in file " + filename);
+    if (pleioeffects.size() != npleio) throw std::runtime_error("Number of pleiotropic effect sizes does not match number of pleiotropic effects in file " + filename);
+    if (pleiodomcoeffs.size() != npleio) throw std::runtime_error("Number of pleiotropic dominance effects does not match number of pleiotropic effects in file " + filename);
+    if (hyperorders.size() != nhyper) throw std::runtime_error("Number of hyperedge orders does not match number of hyperedges in file " + filename);
+    if (hyperloci.size() != std::accumulate(hyperorders.begin(), hyperorders.end(), size_t(0u))) throw std::runtime_error("Number of hyperedge loci does not match orders of hyperedges in file " + filename);
+    if (hyperweights.size() != nhyper) throw std::runtime_error("Number of hyperedge weights does not match number of hyperedges in file " + filename);
 
     // Note: At this point the edge-specific parameters may have been omitted, in
     // which case they will remain empty. The above makes sure that if one is empty,
     // they all are.
 
-    // Prepare to count numbers of loci and edges per trait
+    // Prepare to count numbers of loci, edges and hyperedges per trait
     nlocipertrait.assign(ntraits, 0u);
     nedgespertrait.assign(ntraits, 0u);
+    nhyperpertrait.assign(ntraits, 0u);
 
     // For each locus...
     for (size_t i = 0u; i < nloci; ++i) {
@@ -129,31 +363,139 @@ void Architecture::read(const std::string& filename) {
 
     }
 
-    // For each edge...
-    for (size_t i = 0u; i < nedges; ++i) {
+    // Number of threads to check the edges on (only if there are many)
+    const size_t nworkers = std::min(ncores, nedges / 65536u + 1u);
+
+    // Prepare to record the first error in each block of edges, and to count edges per trait
+    std::vector<size_t> failures(nworkers, nedges);
+    std::vector<std::string> messages(nworkers);
+    std::vector<std::vector<size_t> > counts(nworkers, std::vector<size_t>(ntraits, 0u));
+
+    // Function to check a block of edges
+    auto validate = [&](const size_t &t) {
+
+        // For each edge in the block...
+        for (size_t i = t * nedges / nworkers; i < (t + 1u) * nedges / nworkers; ++i) {
+
+            // Check start locus
+            if (from[i] > nloci)
+                messages[t] = "Start locus " + std::to_string(from[i]) + " of edge " + std::to_string(i + 1u) + " is out of bounds in file " + filename;
+
+            // Check end locus
+            else if (to[i] > nloci)
+                messages[t] = "End locus " + std::to_string(to[i]) + " of edge " + std::to_string(i + 1u) + " is out of bounds in file " + filename;
+
+            // Check that they are different
+            else if (from[i] == to[i])
+                messages[t] = "Start and end loci of edge " + std::to_string(i + 1u) + " are the same in file " + filename;
+
+            // Check that they affect the same trait
+            else if (traitids[from[i] - 1u] != traitids[to[i] - 1u])
+                messages[t] = "Start and end loci of edge " + std::to_string(i + 1u) + " affect different traits in file " + filename;
+
+            // Stop at the first error
+            if (!messages[t].empty()) { failures[t] = i; return; }
+
+            // Decrement
+            --from[i];
+            --to[i];
+
+            // Count the number of edges per trait
+            ++counts[t][traitids[from[i]]];
+
+        }
+    };
+
+    // Check the blocks on the threads (or on this one if there is only one)
+    if (nworkers == 1u) validate(0u);
+    else {
+        std::vector<std::thread> threads;
+        threads.reserve(nworkers);
+        for (size_t t = 0u; t < nworkers; ++t) threads.emplace_back(validate, t);
+        for (std::thread &thread : threads) thread.join();
+    }
 
-        // Check start locus
-        if (from[i] > nloci) 
-            throw std::runtime_error("Start locus " + std::to_string(from[i]) + " of edge " + std::to_string(i + 1u) + " is out of bounds in file " + filename);
-            
-        // Check end locus
-        if (to[i] > nloci) 
-            throw std::runtime_error("End locus " + std::to_string(to[i]) + " of edge " + std::to_string(i + 1u) + " is out of bounds in file " + filename);
-            
-        // Check that they are different
-        if (from[i] == to[i]) 
-            throw std::runtime_error("Start and end loci of edge " + std::to_string(i + 1u) + " are the same in file " + filename);
+    // Report the error of the first edge that failed, if any
+    for (size_t t = 0u; t < nworkers; ++t)
+        if (failures[t] < nedges) throw std::runtime_error(messages[t]);
+
+    // Add up the numbers of edges per trait
+    for (size_t t = 0u; t < nworkers; ++t)
+        for (size_t j = 0u; j < ntraits; ++j)
+            nedgespertrait[j] += counts[t][j];
+
+    // Note: Blocks come in the order of the edges, so the error reported is
+    // the same as if the edges had been checked one by one.
+
+    // For each pleiotropic effect...
+    for (size_t i = 0u; i < npleio; ++i) {
+
+        // Check the locus
+        if (pleioloci[i] > nloci)
+            throw std::runtime_error("Locus " + std::to_string(pleioloci[i]) + " of pleiotropic effect " + std::to_string(i + 1u) + " is out of bounds in file " + filename);
+
+        // Check the trait
+        if (pleiotraits[i] > ntraits)
+            throw std::runtime_error("Trait " + std::to_string(pleiotraits[i]) + " of pleiotropic effect " + std::to_string(i + 1u) + " is out of bounds in file " + filename);
 
         // Decrement
-        --from[i];
-        --to[i];
+        --pleioloci[i];
+        --pleiotraits[i];
+
+        // Check that the trait is not the main trait of the locus
+        if (pleiotraits[i] == traitids[pleioloci[i]])
+            throw std::runtime_error("Pleiotropic effect " + std::to_string(i + 1u) + " is on the trait already encoded by its locus in file " + filename);
+
+    }
+
+    // Arrange the pleiotropic effects by locus
+    index(pleioloci);
+
+    // Turn the orders of the hyperedges into offsets
+    hyperstarts.clear();
+    if (nhyper > 0u) {
+        hyperstarts.assign(nhyper + 1u, 0u);
+        std::partial_sum(hyperorders.begin(), hyperorders.end(), hyperstarts.begin() + 1u);
+    }
+
+    // For each hyperedge...
+    for (size_t h = 0u; h < nhyper; ++h) {
+
+        // For each of its loci...
+        for (size_t e = hyperstarts[h]; e < hyperstarts[h + 1u]; ++e) {
+
+            // Check the locus
+            if (hyperloci[e] > nloci)
+                throw std::runtime_error("Locus " + std::to_string(hyperloci[e]) + " of hyperedge " + std::to_string(h + 1u) + " is out of bounds in file " + filename);
+
+            // Decrement
+            --hyperloci[e];
+
+            // Check that it affects the same trait as the first locus
+            if (traitids[hyperloci[e]] != traitids[hyperloci[hyperstarts[h]]])
+                throw std::runtime_error("Loci of hyperedge " + std::to_string(h + 1u) + " affect different traits in file " + filename);
 
-        // Check that they affect the same trait
-        if (traitids[from[i]] != traitids[to[i]]) 
-            throw std::runtime_error("Start and end loci of edge " + std::to_string(i + 1u) + " affect different traits in file " + filename);
-       
-        // Count the number of edges per trait
-        ++nedgespertrait[traitids[from[i]]];
+            // Check that it is not repeated
+            if (std::find(hyperloci.begin() + hyperstarts[h], hyperloci.begin() + e, hyperloci[e]) != hyperloci.begin() + e)
+                throw std::runtime_error("Hyperedge " + std::to_string(h + 1u) + " has the same locus more than once in file " + filename);
+
+        }
+
+        // Count the number of hyperedges per trait
+        ++nhyperpertrait[traitids[hyperloci[hyperstarts[h]]]];
+
+    }
+
+    // Group the hyperedges by order
+    group();
+
+    // For each locus...
+    for (size_t i = 0u; i < nloci && npleio > 0u; ++i) {
+
+        // Check that it affects each other trait at most once
+        for (size_t e = pleiostarts[i] + 1u; e < pleiostarts[i + 1u]; ++e)
+            if (pleiotraits[e] == pleiotraits[e - 1u])
+                throw std::runtime_error("Locus " + std::to_string(i + 1u) + " has more than one pleiotropic effect on trait " + std::to_string(pleiotraits[e] + 1u) + " in file " + filename);
 
     }
 
@@ -168,6 +510,139 @@ void Architecture::read(const std::string& filename) {
 
 }
 
+// Function to arrange pleiotropic effects by locus
+void Architecture::index(const std::vector<size_t> &loci) {
+
+    // loci: locus of each pleiotropic effect
+
+    // Check
+    assert(loci.size() == npleio);
+    assert(pleiotraits.size() == npleio);
+    assert(pleioeffects.size() == npleio);
+    assert(pleiodomcoeffs.size() == npleio);
+
+    // No need for row offsets if there are no pleiotropic effects
+    if (npleio == 0u) {
+        pleiostarts.clear();
+        return;
+    }
+
+    // Count the pleiotropic effects of each locus
+    pleiostarts.assign(nloci + 1u, 0u);
+    for (size_t l : loci) ++pleiostarts[l + 1u];
+
+    // Accumulate them into row offsets
+    std::partial_sum(pleiostarts.begin(), pleiostarts.end(), pleiostarts.begin());
+
+    // Order the effects by locus, then by trait
+    std::vector<size_t> order(npleio);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](const size_t &a, const size_t &b) {
+        return std::make_pair(loci[a], pleiotraits[a]) < std::make_pair(loci[b], pleiotraits[b]);
+    });
+
+    // Function to rearrange a vector in that order
+    auto rearrange = [&](auto &values) {
+        auto copy = values;
+        for (size_t e = 0u; e < npleio; ++e) values[e] = copy[order[e]];
+    };
+
+    // Rearrange the effects
+    rearrange(pleiotraits);
+    rearrange(pleioeffects);
+    rearrange(pleiodomcoeffs);
+
+}
+
+// Function to group hyperedges of the same order together
+void Architecture::group() {
+
+    // Check
+    assert(hyperweights.size() == nhyper);
+    assert(hyperstarts.empty() ? nhyper == 0u : hyperstarts.size() == nhyper + 1u);
+
+    // Order of a hyperedge
+    auto order = [&](const size_t &h) { return hyperstarts[h + 1u] - hyperstarts[h]; };
+
+    // Sort the hyperedges by order, keeping them in place otherwise
+    std::vector<size_t> sorted(nhyper);
+    std::iota(sorted.begin(), sorted.end(), 0u);
+    std::stable_sort(sorted.begin(), sorted.end(), [&](const size_t &a, const size_t &b) { return order(a) < order(b); });
+
+    // Prepare the rearranged hyperedges
+    std::vector<size_t> newstarts(hyperstarts.size(), 0u);
+    Array<Locus> newloci;
+    Array<Effect> newweights;
+    newloci.reserve(hyperloci.size());
+    newweights.reserve(nhyper);
+
+    // For each hyperedge in the new order...
+    for (size_t h = 0u; h < nhyper; ++h) {
+
+        // Copy it
+        newloci.insert(newloci.end(), hyperloci.begin() + hyperstarts[sorted[h]], hyperloci.begin() + hyperstarts[sorted[h] + 1u]);
+        newweights.push_back(hyperweights[sorted[h]]);
+        newstarts[h + 1u] = newloci.size();
+
+    }
+
+    // Replace them
+    hyperstarts.swap(newstarts);
+    hyperloci.swap(newloci);
+    hyperweights.swap(newweights);
+
+}
+
+// Function to compress the start and end loci of the edges
+void Architecture::pack() {
+
+    // Skip if already packed or no edges
+    if (!packed.empty() || nedges == 0u) return;
+
+    // Check
+    assert(from.size() == nedges);
+    assert(to.size() == nedges);
+
+    // Encode the edges
+    std::vector<std::uint8_t> bytes;
+    Packer packer(bytes);
+    packer.add(std::as_const(from).data(), std::as_const(to).data(), nedges);
+    bytes.shrink_to_fit();
+    packed = std::move(bytes);
+
+    // Release the uncompressed loci
+    Array<Locus>().swap(from);
+    Array<Locus>().swap(to);
+
+    // Check
+    check();
+
+}
+
+// Function to expand packed edges back into start and end loci
+void Architecture::unpack() {
+
+    // Skip unless packed
+    if (packed.empty()) return;
+
+    // Decode the edges
+    from.resize(nedges);
+    to.resize(nedges);
+    Unpacker unpacker(std::as_const(packed).data(), packed.size());
+    [[maybe_unused]] const size_t n = unpacker.next(from.data(), to.data(), nedges);
+
+    // Check
+    assert(n == nedges);
+    assert(unpacker.done());
+
+    // Release the stream
+    Array<std::uint8_t>().swap(packed);
+
+    // Check
+    check();
+
+}
+
 // Function to check that the architecture is compatible with the parameters
 void Architecture::test(const Parameters &pars) const {
 
@@ -178,16 +653,38 @@ void Architecture::test(const Parameters &pars) const {
 }
 
 // Function to generate a genetic architecture
-void Architecture::generate(const Parameters &pars) {
+void Architecture::generate(const Parameters &pars, const Flush &flush, const size_t &chunk) {
+
+    // pars: general hyperparameters
+    // flush: (optional) function to hand over chunks of edges to instead of keeping them
+    // chunk: number of edges per chunk
+
+    // Use tables of partnering weights for this call only
+    std::vector<Powers> powers;
+    generate(pars, powers, flush, chunk);
+
+}
+
+// Function to generate a genetic architecture, reusing tables of partnering weights
+void Architecture::generate(const Parameters &pars, std::vector<Powers> &powers, const Flush &flush, const size_t &chunk) {
 
     // pars: general hyperparameters
+    // powers: partnering weights of each degree, per trait (kept by the caller between calls)
+    // flush: (optional) function to hand over chunks of edges to instead of keeping them
+    // chunk: number of edges per chunk
 
     // Override hyperparameters
     nloci = pars.nloci;
     nedges = pars.nedges;
     ntraits = pars.ntraits;
+    nhyper = pars.nhyper;
     nlocipertrait = pars.nlocipertrait;
     nedgespertrait = pars.nedgespertrait;
+    nhyperpertrait = pars.nhyperpertrait;
+
+    // Check that indices fit in the types they are stored in
+    if (nloci > std::numeric_limits<Locus>::max()) throw std::runtime_error("Too many loci to be indexed");
+    if (ntraits > std::numeric_limits<Trait>::max()) throw std::runtime_error("Too many traits to be indexed");
 
     // Reset
     traitids.resize(0u);
@@ -196,18 +693,31 @@ void Architecture::generate(const Parameters &pars) {
     from.resize(0u);
     to.resize(0u);
     weights.resize(0u);
+    packed.resize(0u);
+    hyperstarts.resize(0u);
+    hyperloci.resize(0u);
+    hyperweights.resize(0u);
 
     // Reserve memory
     traitids.reserve(nloci);
     effects.reserve(nloci);
     domcoeffs.reserve(nloci);
-    from.reserve(nedges);
-    to.reserve(nedges);
-    weights.reserve(nedges);
+    if (!flush && !pars.packedges) from.reserve(nedges);
+    if (!flush && !pars.packedges) to.reserve(nedges);
+    if (!flush) weights.reserve(nedges);
+    hyperloci.reserve(nhyper * pars.hyperorder);
+    hyperweights.reserve(nhyper);
 
     // Prepare a distribution to sample from
     rnd::normal getnormal(0.0, 1.0);
 
+    // Prepare one table of partnering weights per trait
+    powers.resize(ntraits);
+
+    // Note: These tables are kept by the caller from one call to the next, so
+    // powers of degrees are not computed again for replicates with the same
+    // skewness.
+
     // Prepare square-rooted numbers of loci and edges per trait
     std::vector<double> snl(ntraits, 0.0);
     std::vector<double> sne(ntraits, 0.0);
@@ -224,6 +734,15 @@ void Architecture::generate(const Parameters &pars) {
 
     }
 
+    // Whether loci may affect other traits than their own
+    const bool pleiotropic = pars.pleiotropy > 0.0 && ntraits > 1u;
+
+    // Prepare to store the standard deviates of the effects of each locus
+    std::vector<double> zeffects;
+    std::vector<double> zdomcoeffs;
+
+    // Note: These are needed to correlate the effects of a locus across traits.
+
     // Counter
     size_t trait = 0u;
 
@@ -247,16 +766,90 @@ void Architecture::generate(const Parameters &pars) {
         // Trait affected by the locus
         traitids.push_back(trait);
 
+        // Random stream of the locus
+        rnd::Stream stream = rnd::rng.stream(rnd::effects, i);
+
+        // Forget cached draws if the stream is the locus' own
+        if (rnd::rng.iscounter()) getnormal.reset();
+
+        // Sample standard deviates for the effects of the locus
+        const double z = getnormal(stream);
+        const double zd = getnormal(stream);
+
         // Additive effect size of the locus on the trait
-        effects.push_back(getnormal(rnd::rng) * (pars.standard ? 1.0 / snl[trait] : pars.sdeffects));
+        effects.push_back(z * (pars.standard ? 1.0 / snl[trait] : pars.sdeffects));
 
         // Dominance effect of the locus on the trait
-        domcoeffs.push_back(getnormal(rnd::rng) * (pars.standard ? 1.0 / snl[trait] : pars.sddomcoeffs));
+        domcoeffs.push_back(zd * (pars.standard ? 1.0 / snl[trait] : pars.sddomcoeffs));
 
+        // Remember the deviates if needed
+        if (pleiotropic) {
+            zeffects.push_back(z);
+            zdomcoeffs.push_back(zd);
+        }
     }
 
+    // Random stream for the shuffle
+    rnd::Stream stream = rnd::rng.stream(rnd::shuffle, 0u);
+
     // Shuffle encoded traits randomly
-    std::shuffle(traitids.begin(), traitids.end(), rnd::rng);
+    std::shuffle(traitids.begin(), traitids.end(), stream);
+
+    // Reset pleiotropic effects
+    npleio = 0u;
+    pleiostarts.clear();
+    pleiotraits.clear();
+    pleioeffects.clear();
+    pleiodomcoeffs.clear();
+
+    // If needed...
+    if (pleiotropic) {
+
+        // Prepare row offsets
+        pleiostarts.assign(nloci + 1u, 0u);
+
+        // Weights of the shared and own parts of the effects
+        const double shared = pars.pleiocorr;
+        const double own = sqrt(1.0 - shared * shared);
+
+        // Prepare to skip over traits not affected
+        rnd::geometric getskip(std::min(pars.pleiotropy, 1.0 - 1e-12));
+
+        // For each locus...
+        for (size_t i = 0u; i < nloci; ++i) {
+
+            // Random stream of the locus
+            stream = rnd::rng.stream(rnd::pleiotropy, i);
+
+            // Forget cached draws if the stream is the locus' own
+            if (rnd::rng.iscounter()) getnormal.reset();
+
+            // For each other trait affected...
+            for (size_t k = getskip(stream); k < ntraits - 1u; k += 1u + getskip(stream)) {
+
+                // Index of the trait (skipping the trait of the locus)
+                const size_t j = k < traitids[i] ? k : k + 1u;
+
+                // Add an effect of the locus on that trait, correlated with its main effects
+                pleiotraits.push_back(j);
+                pleioeffects.push_back((shared * zeffects[i] + own * getnormal(stream)) * (pars.standard ? 1.0 / snl[j] : pars.sdeffects));
+                pleiodomcoeffs.push_back((shared * zdomcoeffs[i] + own * getnormal(stream)) * (pars.standard ? 1.0 / snl[j] : pars.sddomcoeffs));
+
+            }
+
+            // Note: Each other trait is affected with probability pleiotropy, and
+            // skipping geometrically over the traits not affected takes time
+            // proportional to the number of effects made.
+
+            // Close the row of the locus
+            pleiostarts[i + 1u] = pleiotraits.size();
+
+        }
+
+        // Update the number of pleiotropic effects
+        npleio = pleiotraits.size();
+
+    }
 
     // Prepare to store indices of the loci affecting each trait
     std::vector<std::vector<size_t> > indices(ntraits);
@@ -277,14 +870,39 @@ void Architecture::generate(const Parameters &pars) {
 
     }
 
-    // Note: What follows implements a modified version of the Barabasi-Albert 
+    // Note: Unless a null model is requested (see the network parameter), what
+    // follows implements a modified version of the Barabasi-Albert
     // preferential attachment algorithm. In this version the number of
     // connections made by each new vertex is not fixed but randomly sampled, so
     // that the mean degree at the end is the number of edges divided by the number
     // of vertices in each network.
 
-    // For each trait...
-    for (size_t j = 0u; j < ntraits; ++j) {
+    // Prepare to store the edges of each trait separately
+    std::vector<std::vector<Locus> > tfrom(ntraits);
+    std::vector<std::vector<Locus> > tto(ntraits);
+    std::vector<std::vector<Effect> > tweights(ntraits);
+
+    // Function to hand over the edges of a trait made so far, if there are enough
+    auto spill = [&](const size_t &j, const size_t &minimum) {
+
+        // j: trait
+        // minimum: number of edges needed to hand them over
+
+        // Skip if the edges are kept or too few
+        if (!flush || tweights[j].empty() || tweights[j].size() < minimum) return;
+
+        // Hand them over
+        flush(tfrom[j], tto[j], tweights[j]);
+
+        // Forget them
+        tfrom[j].clear();
+        tto[j].clear();
+        tweights[j].clear();
+
+    };
+
+    // Function to grow the network of a given trait
+    auto grow = [&](const size_t &j) {
 
         // Useful numbers
         const size_t nL = nlocipertrait[j];
@@ -292,7 +910,7 @@ void Architecture::generate(const Parameters &pars) {
         const double skew = pars.skew[j];
 
         // Skip if no edges affect the trait
-        if (nE == 0u) continue;
+        if (nE == 0u) return;
 
          // Check
         assert(nL > 1u);
@@ -300,14 +918,75 @@ void Architecture::generate(const Parameters &pars) {
         assert(nE <= nL * (nL - 1u) / 2u);
         assert(sne[j] > 0.0);
 
+        // Partnering weights of the trait (cleared if the skewness changed)
+        Powers &power = powers[j];
+        power.reset(skew);
+
+        // Generator of the trait network
+        rnd::Generator rng = rnd::rng.derive(rnd::network, j);
+
+        // Prepare a distribution of interaction weights
+        rnd::normal getnormal(0.0, 1.0);
+
+        // Edges of the trait
+        std::vector<Locus> &jfrom = tfrom[j];
+        std::vector<Locus> &jto = tto[j];
+        std::vector<Effect> &jweights = tweights[j];
+
+        // Reserve memory (for one chunk at a time if edges are handed over)
+        jfrom.reserve(flush ? std::min(nE, chunk) : nE);
+        jto.reserve(flush ? std::min(nE, chunk) : nE);
+        jweights.reserve(flush ? std::min(nE, chunk) : nE);
+
+        // If the network comes from a null model instead...
+        if (pars.network > 0u) {
+
+            // Prepare to store the edges between vertices
+            std::vector<std::pair<size_t, size_t> > edges;
+
+            // Sample them with the right model
+            bool success = true;
+            if (pars.network == 1u) net::random(edges, nL, nE, rng);
+            else if (pars.network == 2u) success = net::configuration(edges, nL, nE, skew, rng);
+            else net::blocks(edges, nL, nE, pars.nblocks, pars.crossblocks, rng);
+
+            // Error if needed
+            if (!success)
+                throw std::runtime_error("Not all requested edges could be made for trait " + std::to_string(j + 1u) + " with the given parameters");
+
+            // Check
+            assert(edges.size() == nE);
+
+            // For each edge...
+            for (const std::pair<size_t, size_t> &edge : edges) {
+
+                // Add the connection
+                jfrom.push_back(indices[j][edge.first]);
+                jto.push_back(indices[j][edge.second]);
+
+                // Sample an interaction weight
+                jweights.push_back(getnormal(rng) * (pars.standard ? 1.0 / sne[j] : pars.sdweights));
+
+                // Hand over a full chunk if needed
+                spill(j, chunk);
+
+            }
+
+            // Done
+            return;
+
+        }
+
+        // Note: Otherwise the network is grown by preferential attachment.
+
         // First connection
-        from.push_back(indices[j][0u]);
-        to.push_back(indices[j][1u]);
+        jfrom.push_back(indices[j][0u]);
+        jto.push_back(indices[j][1u]);
 
         // Note: This connects vertex 0 to vertex 1.
 
         // Sample the first interaction weight
-        weights.push_back(getnormal(rnd::rng) * (pars.standard ? 1.0 / sne[j] : pars.sdweights));
+        jweights.push_back(getnormal(rng) * (pars.standard ? 1.0 / sne[j] : pars.sdweights));
 
         // Initialize vector of degrees across vertices
         std::vector<size_t> degrees(nL, 0u);
@@ -316,15 +995,20 @@ void Architecture::generate(const Parameters &pars) {
         ++degrees[0u];
         ++degrees[1u];
 
-        // Initialize a vector of partnering probabilities
-        std::vector<double> probs(2u, 1.0);
+        // Initialize a sampler of partners
+        Sampler sampler(nL);
+
+        // Give the two first vertices their partnering weights
+        sampler.set(0u, 1.0);
+        sampler.set(1u, 1.0);
 
-        // Note: The probability is to the power determined by the
+        // Note: The weight is the degree to the power determined by the
         // skewness parameter but it remains one for now because
-        // degrees of the two first vertices are one.
+        // degrees of the two first vertices are one. All other vertices
+        // have weight zero for now.
 
-        // All other vertices get probability zero for now
-        probs.resize(nL);
+        // Prepare to store the partners of each new vertex
+        std::vector<size_t> partners;
 
         // Number of edges left to add
         size_t ne = nE - 1u;
@@ -343,7 +1027,7 @@ void Architecture::generate(const Parameters &pars) {
             // at least one for each vertex still to come to make sure the network is connected).
 
             // Sample a number of connections to make or make them all if last
-            size_t n = nl == 0u ? ne : 1u + rnd::binomial(nspare, 1.0 / nl)(rnd::rng);
+            size_t n = nl == 0u ? ne : 1u + rnd::binomial(nspare, 1.0 / nl)(rng);
 
             // Note: This sampling makes the expected number of connections made by each
             // vertex increase as we loop through vertices (contrary to the classic
@@ -357,48 +1041,42 @@ void Architecture::generate(const Parameters &pars) {
             assert(n > 0u);
             assert(n <= i);
 
-            // Vector of probabilities from the point of view of the current vertex
-            std::vector<double> iprobs(probs.begin(), probs.begin() + i);
-
-            // Note: This one will be updated to avoid connecting the current
-            // vertex to the same partner twice. We also just need the probabilities
-            // the vertices already attached; the rest have zero probability.
-
             // Flag for whether no sampling needed
             const bool nosample = (n == i);
 
+            // Reset the partners
+            partners.clear();
+
             // For each connection to make...
             while (n > 0u) {
 
                 // Sample a vertex to connect to
-                const size_t v = nosample ? i - 1u : rnd::discrete(iprobs.cbegin(), iprobs.cend())(rnd::rng);
+                const size_t v = nosample ? n - 1u : sampler.sample(rng);
 
                 // Note: This make sure that we avoid expensive sampling in case
-                // we should anyway connect to all the vertices that came before.
+                // we should anyway connect to all the vertices that came before,
+                // which are then visited once each, from the latest to the first.
 
                 // Check
                 assert(v < i);
 
                 // Add the connection
-                from.push_back(indices[j][i]);
-                to.push_back(indices[j][v]);
+                jfrom.push_back(indices[j][i]);
+                jto.push_back(indices[j][v]);
 
                 // Update degrees
                 ++degrees[i];
                 ++degrees[v];
 
-                // Update probabilities to avoid sampling the same vertex again
-                iprobs[v] = 0.0;
-
-                // Update external probability of the partner vertex               
-                probs[v] = skew == 1.0 ? degrees[v] : pow(degrees[v], skew);
-
-                // Note: We try to avoid regenerating entire vectors of probabilities
-                // too often because the power function is expensive. Here the fast
-                // special case when skewness is one.
+                // Exclude the partner to avoid sampling the same vertex again
+                if (!nosample) sampler.set(v, 0.0);
+                partners.push_back(v);
 
                 // Sample an interaction weight
-                weights.push_back(getnormal(rnd::rng) * (pars.standard ? 1.0 / sne[j]: pars.sdweights));
+                jweights.push_back(getnormal(rng) * (pars.standard ? 1.0 / sne[j]: pars.sdweights));
+
+                // Hand over a full chunk if needed
+                spill(j, chunk);
 
                 // Decrement the number of connections left to make
                 --n;
@@ -406,8 +1084,20 @@ void Architecture::generate(const Parameters &pars) {
 
             }
 
-            // Update external probability of the focal vertex
-            probs[i] = skew == 1.0 ? degrees[i] : pow(degrees[i], skew);
+            // For each partner...
+            for (const size_t &v : partners) {
+
+                // Update its partnering weight with its new degree
+                sampler.set(v, power(degrees[v]));
+
+            }
+
+            // Note: Only the weights of the vertices whose degree changed are
+            // updated, which also lifts their exclusion. Weights are read from
+            // the table to avoid calling the expensive power function.
+
+            // Update partnering weight of the focal vertex
+            sampler.set(i, power(degrees[i]));
 
             // Update number of vertices yet to graft
             --nl;
@@ -425,82 +1115,386 @@ void Architecture::generate(const Parameters &pars) {
         // Check
         assert(ne == 0u);
 
-    }
-    
-    // Check
-    check();
+    };
 
-}
+    // Prepare to store the hyperedges of each trait separately
+    std::vector<std::vector<Locus> > thyperloci(ntraits);
+    std::vector<std::vector<Effect> > thyperweights(ntraits);
 
-// Function to check the consistency of internal parameters
-void Architecture::checkinternal() const {
+    // Number of loci in each hyperedge
+    const size_t K = pars.hyperorder;
 
-    // Prepare
-    size_t nl = 0u;
-    size_t ne = 0u;
+    // Function to draw the hyperedges of a given trait
+    auto draw = [&](const size_t &j) {
 
-    // For each trait...
-    for (size_t i = 0u; i < ntraits; ++i) {
+        // Useful numbers
+        const size_t nL = nlocipertrait[j];
+        const size_t nH = nhyperpertrait[j];
 
-        // Count
-        nl += nlocipertrait[i];
-        ne += nedgespertrait[i];
-        
-    }
+        // Skip if no hyperedges affect the trait
+        if (nH == 0u) return;
 
-    // Check
-    assert(nl == nloci);
-    assert(ne == nedges);
+        // Error if there are not enough distinct sets of loci
+        if (nH > net::nsubsets(nL, K))
+            throw std::runtime_error("Not all requested hyperedges could be made for trait " + std::to_string(j + 1u) + " with the given parameters");
 
-}
+        // Generator of the hyperedges of the trait
+        rnd::Generator rng = rnd::rng.derive(rnd::hyperedges, j);
 
-// Function to check the validity of the architecture
-void Architecture::check() const {
+        // Prepare distributions of vertices and interaction weights
+        rnd::random getvertex(0u, nL - 1u);
+        rnd::normal getnormal(0.0, 1.0);
 
-    // Check internal consistency
-    checkinternal();
+        // Hyperedges of the trait
+        std::vector<Locus> &jloci = thyperloci[j];
+        std::vector<Effect> &jweights = thyperweights[j];
 
-    // Check
-    assert(nloci > 0u);
-    assert(ntraits > 0u);
+        // Reserve memory
+        jloci.reserve(nH * K);
+        jweights.reserve(nH);
 
-    // Check sizes
-    assert(traitids.size() == nloci);
-    assert(effects.size() == nloci);
-    assert(domcoeffs.size() == nloci);
-    assert(from.size() == nedges);
-    assert(to.size() == nedges);
-    assert(weights.size() == nedges);
+        // Prepare to remember the sets of vertices already used
+        std::set<std::vector<size_t> > existing;
 
-    // Note: By now any user-supplied indices have been decremented
-    // to match the zero-based indexing of C++. 
+        // Prepare to store the vertices of the current hyperedge
+        std::vector<size_t> members;
+        members.reserve(K);
 
-    // Prepare to verify number of loci and edges for each trait
-    std::vector<size_t> nl(ntraits, 0u);
-    std::vector<size_t> ne(ntraits, 0u);
+        // Until enough hyperedges are made...
+        while (jweights.size() < nH) {
 
-    // For each locus...
-    for (size_t i = 0u; i < nloci; ++i) {
+            // Sample distinct vertices
+            members.clear();
+            while (members.size() < K) {
+                const size_t v = getvertex(rng);
+                if (std::find(members.begin(), members.end(), v) == members.end()) members.push_back(v);
+            }
 
-        // Check
-        assert(traitids[i] < ntraits);
+            // Sort them, so that each set of vertices is recorded in a single way
+            std::sort(members.begin(), members.end());
 
-        // Count
-        ++nl[traitids[i]];
+            // Skip if that hyperedge exists already
+            if (!existing.insert(members).second) continue;
 
-    }
+            // Add the hyperedge
+            for (size_t v : members) jloci.push_back(indices[j][v]);
 
-    // For each edge...
-    for (size_t i = 0u; i < nedges; ++i) {
+            // Sample an interaction weight
+            jweights.push_back(getnormal(rng) * (pars.standard ? 1.0 / sqrt(nH) : pars.sdweights));
 
-        // Check
-        assert(from[i] < nloci);
-        assert(to[i] < nloci);
-        assert(from[i] != to[i]);
-        assert(traitids[from[i]] == traitids[to[i]]);
+        }
+
+        // Note: Sets of vertices are sampled uniformly and duplicates are
+        // rejected, which takes few attempts unless the hyperedges requested
+        // use up most of the possible sets of vertices.
+
+    };
+
+    // Number of threads to use
+    const size_t ncores = pars.nthreads > 0u ? pars.nthreads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t nthreads = flush ? 1u : std::min(ntraits, ncores);
+
+    // Note: Edges that are handed over must come in the order of the traits,
+    // so they are then made on a single thread, one trait after the other.
+
+    // Prepare to catch errors on each trait
+    std::vector<std::exception_ptr> errors(ntraits);
+
+    // Prepare threads
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+
+    // Grow the networks and draw the hyperedges on the threads in turn
+    for (size_t t = 0u; t < nthreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t j = t; j < ntraits; j += nthreads) {
+                try { grow(j); spill(j, 1u); draw(j); } catch (...) { errors[j] = std::current_exception(); if (flush) break; }
+            }
+        });
+    }
+
+    // Wait for all of them
+    for (std::thread &thread : threads) thread.join();
+
+    // Rethrow the error of the first trait that failed, if any
+    for (size_t j = 0u; j < ntraits; ++j)
+        if (errors[j]) std::rethrow_exception(errors[j]);
+
+    // Prepare to compress the edges if needed
+    std::vector<std::uint8_t> bytes;
+    Packer packer(bytes);
+
+    // For each trait...
+    for (size_t j = 0u; j < ntraits; ++j) {
+
+        // Append its edges, compressed if needed
+        if (pars.packedges) packer.add(tfrom[j].data(), tto[j].data(), tfrom[j].size());
+        else {
+            from.insert(from.end(), tfrom[j].begin(), tfrom[j].end());
+            to.insert(to.end(), tto[j].begin(), tto[j].end());
+        }
+        weights.insert(weights.end(), tweights[j].begin(), tweights[j].end());
+
+        // Release them
+        std::vector<Locus>().swap(tfrom[j]);
+        std::vector<Locus>().swap(tto[j]);
+        std::vector<Effect>().swap(tweights[j]);
+
+        // Append its hyperedges
+        hyperloci.insert(hyperloci.end(), thyperloci[j].begin(), thyperloci[j].end());
+        hyperweights.insert(hyperweights.end(), thyperweights[j].begin(), thyperweights[j].end());
+
+    }
+
+    // Hyperedges all have the same order, so their offsets are evenly spaced
+    if (nhyper > 0u) {
+        hyperstarts.resize(nhyper + 1u);
+        for (size_t h = 0u; h <= nhyper; ++h) hyperstarts[h] = h * K;
+    }
+
+    // Note: Each trait draws from its own generator and the edges (and hyperedges) are merged
+    // in the order of the traits, so results do not depend on the number
+    // of threads or the order in which they run. The edges of each trait are
+    // released once merged, so that they are not all held twice.
+
+    // Keep the packed edges, trimmed
+    bytes.shrink_to_fit();
+    packed = std::move(bytes);
+
+    // Stop here if the edges were handed over, as they are not in memory
+    if (flush) return;
+
+    // Check
+    check();
+
+}
+
+// Function to generate a genetic architecture straight into a file
+void Architecture::stream(const Parameters &pars, const std::string &filename, const bool &binary, const size_t &chunk) {
+
+    // pars: general hyperparameters
+    // filename: name of the output file
+    // binary: whether to save in binary (if not, text)
+    // chunk: number of edges to hold in memory at a time
+
+    // Temporary files for the start loci, end loci and weights of the edges
+    const std::vector<std::string> parts = {filename + ".from.tmp", filename + ".to.tmp", filename + ".weights.tmp"};
+
+    // Open them
+    const std::ios::openmode mode = binary ? std::ios::out | std::ios::binary : std::ios::out;
+    std::ofstream fromfile(parts[0u], mode);
+    std::ofstream tofile(parts[1u], mode);
+    std::ofstream weightfile(parts[2u], mode);
+
+    // Function to remove them
+    auto cleanup = [&]() { for (const std::string &part : parts) std::remove(part.c_str()); };
+
+    // Check that they are open
+    if (!fromfile.is_open() || !tofile.is_open() || !weightfile.is_open()) {
+        cleanup();
+        throw std::runtime_error("Unable to open file " + filename);
+    }
+
+    // Function to write a chunk of edges
+    auto flush = [&](const std::vector<Locus> &f, const std::vector<Locus> &t, const std::vector<Effect> &w) {
+
+        // Write them as they are in memory if binary
+        if (binary) {
+            fromfile.write(reinterpret_cast<const char*>(f.data()), f.size() * sizeof(Locus));
+            tofile.write(reinterpret_cast<const char*>(t.data()), t.size() * sizeof(Locus));
+            weightfile.write(reinterpret_cast<const char*>(w.data()), w.size() * sizeof(Effect));
+            return;
+        }
+
+        // Or as they are written in the text format
+        for (size_t x : f) fromfile << ' ' << x + 1u;
+        for (size_t x : t) tofile << ' ' << x + 1u;
+        for (double x : w) weightfile << ' ' << x;
+
+    };
+
+    try {
+
+        // Generate the architecture, writing the edges as they are made
+        generate(pars, flush, chunk);
+
+        // Close the temporary files
+        fromfile.close();
+        tofile.close();
+        weightfile.close();
+
+        // Check
+        if (!fromfile || !tofile || !weightfile) throw std::runtime_error("Unable to write file " + filename);
+
+        // Write the architecture, with the edges copied from the temporary files
+        if (binary) savebinary(filename, parts);
+        else save(filename, parts);
+
+    } catch (...) {
+
+        // Clean up before passing on the error
+        cleanup();
+        throw;
+
+    }
+
+    // Remove the temporary files
+    cleanup();
+
+    // Note: Edges are written a chunk at a time and each array gets its own
+    // file, so at most one chunk of edges is held in memory, on top of the
+    // per-locus parameters and the sampling state of the trait being grown.
+    // The arrays are then joined in the order of the architecture file.
+
+    // The edges are now only in the file
+    nedges = 0u;
+    nedgespertrait.assign(ntraits, 0u);
+
+    // Check
+    check();
+
+}
+
+// Function to check the consistency of internal parameters
+void Architecture::checkinternal() const {
+
+    // Check that there are counts for every trait
+    assert(nlocipertrait.size() == ntraits);
+    assert(nedgespertrait.size() == ntraits);
+    assert(nhyperpertrait.size() == ntraits);
+
+    // Prepare
+    size_t nl = 0u;
+    size_t ne = 0u;
+    size_t nh = 0u;
+
+    // For each trait...
+    for (size_t i = 0u; i < ntraits; ++i) {
 
         // Count
-        ++ne[traitids[from[i]]];
+        nl += nlocipertrait[i];
+        ne += nedgespertrait[i];
+        nh += nhyperpertrait[i];
+        
+    }
+
+    // Check
+    assert(nl == nloci);
+    assert(ne == nedges);
+    assert(nh == nhyper);
+
+}
+
+// Function to check the validity of the architecture
+void Architecture::check() const {
+
+    // Skip if no validation
+    if (!chk::validates(chk::cheap)) return;
+
+    // Check internal consistency
+    checkinternal();
+
+    // Check
+    assert(nloci > 0u);
+    assert(ntraits > 0u);
+
+    // Check sizes
+    assert(traitids.size() == nloci);
+    assert(effects.size() == nloci);
+    assert(domcoeffs.size() == nloci);
+    assert(packed.empty() ? from.size() == nedges && to.size() == nedges : from.empty() && to.empty());
+    assert(weights.size() == nedges);
+    assert(pleiotraits.size() == npleio);
+    assert(pleioeffects.size() == npleio);
+    assert(pleiodomcoeffs.size() == npleio);
+    assert(pleiostarts.empty() ? npleio == 0u : pleiostarts.size() == nloci + 1u && pleiostarts.back() == npleio);
+    assert(hyperweights.size() == nhyper);
+    assert(hyperstarts.empty() ? nhyper == 0u && hyperloci.empty() : hyperstarts.size() == nhyper + 1u && hyperstarts.back() == hyperloci.size());
+
+    // Note: By now any user-supplied indices have been decremented
+    // to match the zero-based indexing of C++. 
+
+    // Stop here unless full validation
+    if (!chk::validates(chk::full)) return;
+
+    // Prepare to verify number of loci and edges for each trait
+    std::vector<size_t> nl(ntraits, 0u);
+    std::vector<size_t> ne(ntraits, 0u);
+
+    // For each locus...
+    for (size_t i = 0u; i < nloci; ++i) {
+
+        // Check
+        assert(traitids[i] < ntraits);
+
+        // Count
+        ++nl[traitids[i]];
+
+    }
+
+    // Decode the edges if they are packed
+    Array<Locus> unpacked[2u];
+    if (!packed.empty()) {
+        unpacked[0u].resize(nedges);
+        unpacked[1u].resize(nedges);
+        Unpacker unpacker(packed.data(), packed.size());
+        [[maybe_unused]] const size_t n = unpacker.next(unpacked[0u].data(), unpacked[1u].data(), nedges);
+        assert(n == nedges);
+        assert(unpacker.done());
+    }
+
+    // Start and end loci of the edges
+    const Array<Locus> &efrom = packed.empty() ? from : unpacked[0u];
+    [[maybe_unused]] const Array<Locus> &eto = packed.empty() ? to : unpacked[1u];
+
+    // For each edge...
+    for (size_t i = 0u; i < nedges; ++i) {
+
+        // Check
+        assert(efrom[i] < nloci);
+        assert(eto[i] < nloci);
+        assert(efrom[i] != eto[i]);
+        assert(traitids[efrom[i]] == traitids[eto[i]]);
+
+        // Count
+        ++ne[traitids[efrom[i]]];
+
+    }
+
+    // For each locus with pleiotropic effects...
+    for (size_t i = 0u; i < nloci && npleio > 0u; ++i) {
+
+        // For each of its pleiotropic effects...
+        for (size_t e = pleiostarts[i]; e < pleiostarts[i + 1u]; ++e) {
+
+            // Check
+            assert(pleiotraits[e] < ntraits);
+            assert(pleiotraits[e] != traitids[i]);
+            assert(e == pleiostarts[i] || pleiotraits[e] > pleiotraits[e - 1u]);
+
+        }
+    }
+
+    // Prepare to verify the number of hyperedges for each trait
+    std::vector<size_t> nh(ntraits, 0u);
+
+    // For each hyperedge...
+    for (size_t h = 0u; h < nhyper; ++h) {
+
+        // Check its order
+        assert(hyperstarts[h + 1u] >= hyperstarts[h] + 2u);
+
+        // For each of its loci...
+        for (size_t e = hyperstarts[h]; e < hyperstarts[h + 1u]; ++e) {
+
+            // Check
+            assert(hyperloci[e] < nloci);
+            assert(traitids[hyperloci[e]] == traitids[hyperloci[hyperstarts[h]]]);
+
+        }
+
+        // Count
+        ++nh[traitids[hyperloci[hyperstarts[h]]]];
 
     }
 
@@ -510,14 +1504,16 @@ void Architecture::check() const {
         // Check
         assert(nl[i] == nlocipertrait[i]);
         assert(ne[i] == nedgespertrait[i]);
+        assert(nh[i] == nhyperpertrait[i]);
 
     }
 }
 
 // Function to save architecture parameters to file
-void Architecture::save(const std::string &filename) const {
+void Architecture::save(const std::string &filename, const std::vector<std::string> &parts) const {
 
     // filename: name of the output file
+    // parts: (optional) files holding the start loci, end loci and weights of the edges, if not in memory
 
     // Create output file stream
     std::ofstream file(filename);
@@ -540,8 +1536,54 @@ void Architecture::save(const std::string &filename) const {
     for (double x : domcoeffs) file << ' ' << x;
     file << '\n';
 
-    // If edges...
-    if (nedges > 0u) {
+    // If pleiotropic effects...
+    if (npleio > 0u) {
+
+        // Write them too
+        file << "npleio " << npleio << '\n';
+        file << "pleioloci";
+        for (size_t i = 0u; i < nloci; ++i)
+            for (size_t e = pleiostarts[i]; e < pleiostarts[i + 1u]; ++e) file << ' ' << i + 1u;
+        file << '\n';
+        file << "pleiotraits";
+        for (size_t x : pleiotraits) file << ' ' << x + 1u;
+        file << '\n';
+        file << "pleioeffects";
+        for (double x : pleioeffects) file << ' ' << x;
+        file << '\n';
+        file << "pleiodomcoeffs";
+        for (double x : pleiodomcoeffs) file << ' ' << x;
+        file << '\n';
+
+    }
+
+    // If edges packed in memory...
+    if (nedges > 0u && parts.empty() && !packed.empty()) {
+
+        // Prepare to decode them a block at a time
+        const size_t block = 65536u;
+        std::vector<Locus> bfrom(block), bto(block);
+
+        // Write the start loci, then the end loci
+        for (size_t side = 0u; side < 2u; ++side) {
+            file << (side == 0u ? "from" : "to");
+            Unpacker unpacker(packed.data(), packed.size());
+            for (size_t n = block; n == block; ) {
+                n = unpacker.next(bfrom.data(), bto.data(), block);
+                for (size_t e = 0u; e < n; ++e) file << ' ' << (side == 0u ? bfrom[e] : bto[e]) + 1u;
+            }
+            file << '\n';
+        }
+
+        // And the weights
+        file << "weights";
+        for (double x : weights) file << ' ' << x;
+        file << '\n';
+
+    }
+
+    // If edges in memory...
+    if (nedges > 0u && parts.empty() && packed.empty()) {
 
         // Write them too
         file << "from";
@@ -556,10 +1598,826 @@ void Architecture::save(const std::string &filename) const {
 
     }
 
+    // Or if edges in separate files...
+    if (nedges > 0u && !parts.empty()) {
+
+        // Check
+        assert(parts.size() == 3u);
+
+        // Copy them in
+        const std::string names[3u] = {"from", "to", "weights"};
+        for (size_t p = 0u; p < 3u; ++p) {
+            std::ifstream part(parts[p]);
+            file << names[p] << part.rdbuf() << '\n';
+        }
+    }
+
+    // If hyperedges...
+    if (nhyper > 0u) {
+
+        // Write them too
+        file << "nhyper " << nhyper << '\n';
+        file << "hyperorders";
+        for (size_t h = 0u; h < nhyper; ++h) file << ' ' << hyperstarts[h + 1u] - hyperstarts[h];
+        file << '\n';
+        file << "hyperloci";
+        for (size_t x : hyperloci) file << ' ' << x + 1u;
+        file << '\n';
+        file << "hyperweights";
+        for (double x : hyperweights) file << ' ' << x;
+        file << '\n';
+
+    }
+
     // Close the file
     file.close();
 
     // Check
     assert(!file.is_open());
 
-}
\ No newline at end of file
+}
+
+// Header of binary architecture files
+struct BinaryHeader {
+
+    char magic[8];              // signature of the format
+    std::uint32_t version;      // version of the format
+    std::uint32_t order;        // byte order marker
+    std::uint32_t locussize;    // number of bytes per locus index
+    std::uint32_t traitsize;    // number of bytes per trait index
+    std::uint32_t effectsize;   // number of bytes per effect or weight
+    std::uint32_t reserved;     // unused (zero)
+    std::uint64_t nloci;        // number of loci
+    std::uint64_t nedges;       // number of edges
+    std::uint64_t ntraits;      // number of traits
+    std::uint64_t npleio;       // number of pleiotropic effects
+    std::uint64_t nhyper;       // number of hyperedges
+    std::uint64_t npacked;      // number of bytes of packed edges (zero if not packed)
+    std::uint64_t length;       // number of bytes after the header
+    std::uint64_t checksum;     // checksum of the bytes after the header
+
+};
+
+// Constants of the binary format
+constexpr char binarymagic[8] = {'A', 'R', 'C', 'H', 'G', 'E', 'N', '\0'};
+constexpr std::uint32_t binaryversion = 3u;
+constexpr std::uint32_t binaryorder = 0x01020304u;
+constexpr size_t binaryalign = 64u;
+
+// Note: The header is followed by the arrays of the architecture, each
+// starting at a multiple of 64 bytes from the start of the file (padded with
+// zeros), in native byte order: loci and edges per trait (64-bit), encoded
+// traits, effects, dominance coefficients, start loci, end loci (or, if
+// packed, the stream of packed edges instead of both), interaction weights,
+// then, if any, the pleiotropic row offsets (64-bit), traits, effects and
+// dominance coefficients, and, if any, the hyperedges per trait (64-bit),
+// hyperedge offsets (64-bit), loci and weights.
+
+// Function to round an offset up to the alignment of arrays
+size_t binarypad(const size_t &offset) {
+
+    // offset: number of bytes from the start of the file
+
+    return (offset + binaryalign - 1u) / binaryalign * binaryalign;
+
+}
+
+// Function to tell whether a file holds a binary architecture
+bool Architecture::isbinary(const std::string &filename) {
+
+    // filename: name of the file
+
+    // Open the file
+    std::ifstream file(filename, std::ios::binary);
+
+    // Read the first bytes
+    char magic[sizeof binarymagic] = {};
+    file.read(magic, sizeof magic);
+
+    // Compare them with the signature
+    return file && std::memcmp(magic, binarymagic, sizeof magic) == 0;
+
+    // Note: Text files cannot start with a null character, so there is no
+    // confusion with architecture files in the text format.
+
+}
+
+// Function to save architecture parameters to a binary file
+void Architecture::savebinary(const std::string &filename, const std::vector<std::string> &parts) const {
+
+    // filename: name of the output file
+    // parts: (optional) files holding the start loci, end loci and weights of the edges, if not in memory
+
+    // File to write into before moving it into place
+    const std::string temp = filename + ".tmp";
+
+    // Note: The architecture may have been read from the very file it is saved
+    // to and still point into it (see readbinary), so that file is replaced
+    // rather than overwritten.
+
+    // Create output file stream
+    std::ofstream file(temp, std::ios::binary);
+
+    // Check that it is open
+    if (!file.is_open()) 
+        throw std::runtime_error("Unable to open file " + filename);
+
+    // Prepare the header
+    BinaryHeader header = {};
+    std::memcpy(header.magic, binarymagic, sizeof binarymagic);
+    header.version = binaryversion;
+    header.order = binaryorder;
+    header.locussize = sizeof(Locus);
+    header.traitsize = sizeof(Trait);
+    header.effectsize = sizeof(Effect);
+    header.nloci = nloci;
+    header.nedges = nedges;
+    header.ntraits = ntraits;
+    header.npleio = npleio;
+    header.nhyper = nhyper;
+    header.npacked = parts.empty() ? packed.size() : 0u;
+
+    // Write it (the length and checksum are filled in at the end)
+    file.write(reinterpret_cast<const char*>(&header), sizeof header);
+
+    // Number of bytes written so far
+    size_t offset = sizeof header;
+
+    // Function to write an array at the next aligned position
+    auto write = [&](const auto &values) {
+
+        // Pad with zeros
+        const size_t start = binarypad(offset);
+        const std::vector<char> zeros(start - offset, 0);
+        file.write(zeros.data(), zeros.size());
+
+        // Write the values in one go
+        const size_t nbytes = values.size() * sizeof values[0];
+        file.write(reinterpret_cast<const char*>(values.data()), nbytes);
+
+        // Move on
+        offset = start + nbytes;
+
+    };
+
+    // Numbers of loci and edges per trait
+    std::vector<std::uint64_t> counts(nlocipertrait.begin(), nlocipertrait.end());
+    write(counts);
+    counts.assign(nedgespertrait.begin(), nedgespertrait.end());
+    write(counts);
+
+    // Locus-specific parameters
+    write(traitids);
+    write(effects);
+    write(domcoeffs);
+
+    // Function to copy an array from a separate file at the next aligned position
+    auto copy = [&](const std::string &part, const size_t &nbytes) {
+
+        // Pad with zeros
+        const size_t start = binarypad(offset);
+        const std::vector<char> zeros(start - offset, 0);
+        file.write(zeros.data(), zeros.size());
+
+        // Copy the bytes of the file
+        std::ifstream input(part, std::ios::binary);
+        if (nbytes > 0u) file << input.rdbuf();
+
+        // Move on
+        offset = start + nbytes;
+
+    };
+
+    // Edge-specific parameters
+    if (parts.empty() && !packed.empty()) {
+        write(packed);
+        write(weights);
+    }
+    else if (parts.empty()) {
+        write(from);
+        write(to);
+        write(weights);
+    }
+    else {
+        assert(parts.size() == 3u);
+        copy(parts[0u], nedges * sizeof(Locus));
+        copy(parts[1u], nedges * sizeof(Locus));
+        copy(parts[2u], nedges * sizeof(Effect));
+    }
+
+    // Pleiotropic effects, if any
+    if (npleio > 0u) {
+        counts.assign(pleiostarts.begin(), pleiostarts.end());
+        write(counts);
+        write(pleiotraits);
+        write(pleioeffects);
+        write(pleiodomcoeffs);
+    }
+
+    // Hyperedges, if any
+    if (nhyper > 0u) {
+        counts.assign(nhyperpertrait.begin(), nhyperpertrait.end());
+        write(counts);
+        counts.assign(hyperstarts.begin(), hyperstarts.end());
+        write(counts);
+        write(hyperloci);
+        write(hyperweights);
+    }
+
+    // Pad the end of the file
+    write(std::vector<char>());
+
+    // Close the file
+    file.close();
+
+    // Check
+    if (!file) throw std::runtime_error("Unable to write file " + filename);
+
+    // Map the file back in to compute its checksum
+    Mapping mapping(temp);
+
+    // Check that everything was written (including edges copied from other files)
+    if (mapping.size() != offset) throw std::runtime_error("Unable to write file " + filename);
+
+    // Complete the header
+    header.length = offset - sizeof header;
+    header.checksum = checksum(mapping.data() + sizeof header, header.length);
+
+    // Release the file
+    mapping.close();
+
+    // Overwrite the header
+    std::fstream patch(temp, std::ios::binary | std::ios::in | std::ios::out);
+    patch.write(reinterpret_cast<const char*>(&header), sizeof header);
+    patch.close();
+
+    // Check
+    if (!patch) throw std::runtime_error("Unable to write file " + filename);
+
+    // Move the file into place
+    std::error_code error;
+    std::filesystem::rename(temp, filename, error);
+    if (error) {
+        std::filesystem::remove(temp, error);
+        throw std::runtime_error("Unable to write file " + filename);
+    }
+
+    // Note: Arrays are written straight from memory and the checksum is
+    // computed from the page cache, so no copy of the architecture is made.
+
+}
+
+// Function to read a genetic architecture from a binary file
+void Architecture::readbinary(const std::string &filename) {
+
+    // filename: name of the file to read from
+
+    // Map the file into memory (kept for as long as arrays point into it)
+    const std::shared_ptr<const Mapping> file = std::make_shared<const Mapping>(filename);
+    const Mapping &mapping = *file;
+
+    // Check that there is a header
+    if (mapping.size() < sizeof(BinaryHeader))
+        throw std::runtime_error("Truncated binary architecture in file " + filename);
+
+    // Read the header
+    BinaryHeader header;
+    std::memcpy(&header, mapping.data(), sizeof header);
+
+    // Check that the file is compatible
+    if (header.version != binaryversion)
+        throw std::runtime_error("Unsupported version " + std::to_string(header.version) + " of binary architecture in file " + filename);
+    if (header.order != binaryorder)
+        throw std::runtime_error("Binary architecture written with a different byte order in file " + filename);
+    if (header.locussize != sizeof(Locus) || header.traitsize != sizeof(Trait) || (header.effectsize != sizeof(float) && header.effectsize != sizeof(double)))
+        throw std::runtime_error("Unsupported storage types in binary architecture in file " + filename);
+
+    // Check that the file is complete and intact
+    if (header.length != mapping.size() - sizeof header)
+        throw std::runtime_error("Truncated binary architecture in file " + filename);
+    if (header.checksum != checksum(mapping.data() + sizeof header, header.length))
+        throw std::runtime_error("Checksum mismatch in binary architecture in file " + filename);
+
+    // Check that indices fit in the types they are stored in
+    if (header.nloci == 0u || header.ntraits == 0u || header.ntraits > header.nloci)
+        throw std::runtime_error("Invalid numbers of loci and traits in binary architecture in file " + filename);
+    if (header.nloci > std::numeric_limits<Locus>::max() || header.ntraits > std::numeric_limits<Trait>::max())
+        throw std::runtime_error("Too many loci or traits to be indexed in file " + filename);
+
+    // Update hyperparameters
+    nloci = header.nloci;
+    nedges = header.nedges;
+    ntraits = header.ntraits;
+    npleio = header.npleio;
+    nhyper = header.nhyper;
+
+    // Number of bytes read so far
+    size_t offset = sizeof header;
+
+    // Function to read an array from the next aligned position
+    auto load = [&](auto &values, const size_t &n, const size_t &size) {
+
+        // Find the array
+        const size_t start = binarypad(offset);
+
+        // Check that it is within the file
+        if (n > (mapping.size() - std::min(start, mapping.size())) / size)
+            throw std::runtime_error("Truncated binary architecture in file " + filename);
+
+        // Type of the values to read into
+        typedef typename std::remove_reference_t<decltype(values)>::value_type T;
+
+        // Point into the mapping if the types match
+        if (size == sizeof(T)) values.view(reinterpret_cast<const T*>(mapping.data() + start), n, file);
+
+        // Otherwise convert effects from the precision they were saved in
+        else if (size == sizeof(float)) {
+            const float *x = reinterpret_cast<const float*>(mapping.data() + start);
+            values.assign(x, x + n);
+        }
+        else {
+            const double *x = reinterpret_cast<const double*>(mapping.data() + start);
+            values.assign(x, x + n);
+        }
+
+        // Move on
+        offset = start + n * size;
+
+    };
+
+    // Numbers of loci and edges per trait
+    Array<std::uint64_t> counts;
+    load(counts, ntraits, sizeof(std::uint64_t));
+    nlocipertrait.assign(counts.begin(), counts.end());
+    load(counts, ntraits, sizeof(std::uint64_t));
+    nedgespertrait.assign(counts.begin(), counts.end());
+
+    // Locus-specific parameters
+    load(traitids, nloci, sizeof(Trait));
+    load(effects, nloci, header.effectsize);
+    load(domcoeffs, nloci, header.effectsize);
+
+    // Function to throw unless a condition on the contents holds
+    auto require = [&](const bool &condition) {
+        if (!condition) throw std::runtime_error("Inconsistent binary architecture in file " + filename);
+    };
+
+    // Note: The checksum only tells that the file is intact, not that it was
+    // written by this program, so indices are checked before being used.
+
+    // Read the arrays as constant, so checking them does not copy them (see array.hpp)
+    const Architecture &loaded = *this;
+
+    // Check that encoded traits are within bounds and match the numbers of loci per trait
+    std::vector<size_t> nl(ntraits, 0u);
+    for (size_t i = 0u; i < nloci; ++i) {
+        require(loaded.traitids[i] < ntraits);
+        ++nl[loaded.traitids[i]];
+    }
+    require(nl == nlocipertrait);
+
+    // Prepare to count the edges of each trait
+    std::vector<size_t> ne(ntraits, 0u);
+
+    // Function to check an edge and count it
+    auto edge = [&](const Locus &i, const Locus &j) {
+        require(i < nloci && j < nloci && i != j && loaded.traitids[i] == loaded.traitids[j]);
+        ++ne[loaded.traitids[i]];
+    };
+
+    // Edge-specific parameters, packed or not
+    if (header.npacked > 0u) {
+        load(packed, header.npacked, 1u);
+        from.clear();
+        to.clear();
+    }
+    else {
+        packed.clear();
+        load(from, nedges, sizeof(Locus));
+        load(to, nedges, sizeof(Locus));
+        for (size_t e = 0u; e < nedges; ++e) edge(loaded.from[e], loaded.to[e]);
+    }
+    load(weights, nedges, header.effectsize);
+
+    // Check that packed edges decode into the right number of edges within bounds
+    if (header.npacked > 0u) {
+
+        // Prepare to decode them a block at a time
+        const size_t block = 65536u;
+        std::vector<Locus> bfrom(block), bto(block);
+        Unpacker unpacker(loaded.packed.data(), loaded.packed.size());
+
+        // Check and count them (stopping as soon as there are too many)
+        size_t n = 0u;
+        for (size_t m = block; m == block; n += m) {
+            m = unpacker.next(bfrom.data(), bto.data(), block);
+            require(n + m <= nedges);
+            for (size_t e = 0u; e < m; ++e) edge(bfrom[e], bto[e]);
+        }
+
+        // Check that they are all there
+        require(n == nedges && unpacker.done());
+
+        // Note: A run of edges of width zero takes no bytes, however many
+        // edges it claims, so the count is bounded by nedges as it goes.
+
+    }
+
+    // Pleiotropic effects, if any
+    pleiostarts.clear();
+    if (npleio > 0u) {
+        load(counts, nloci + 1u, sizeof(std::uint64_t));
+        pleiostarts.assign(counts.begin(), counts.end());
+    }
+    load(pleiotraits, npleio, sizeof(Trait));
+    load(pleioeffects, npleio, header.effectsize);
+    load(pleiodomcoeffs, npleio, header.effectsize);
+
+    // Check that the pleiotropic rows are in order and their traits within bounds
+    if (npleio > 0u) {
+        require(pleiostarts[0u] == 0u && pleiostarts[nloci] == npleio);
+        for (size_t i = 0u; i < nloci; ++i) {
+            require(pleiostarts[i] <= pleiostarts[i + 1u]);
+            for (size_t k = pleiostarts[i]; k < pleiostarts[i + 1u]; ++k)
+                require(loaded.pleiotraits[k] < ntraits && loaded.pleiotraits[k] != loaded.traitids[i]);
+        }
+    }
+
+    // Hyperedges, if any
+    nhyperpertrait.assign(ntraits, 0u);
+    hyperstarts.clear();
+    if (nhyper > 0u) {
+        load(counts, ntraits, sizeof(std::uint64_t));
+        nhyperpertrait.assign(counts.begin(), counts.end());
+        load(counts, nhyper + 1u, sizeof(std::uint64_t));
+        hyperstarts.assign(counts.begin(), counts.end());
+    }
+
+    // Check that the offsets of the hyperedges are valid before using them
+    for (size_t h = 0u; h < nhyper; ++h)
+        if (hyperstarts[h + 1u] < hyperstarts[h] + 2u)
+            throw std::runtime_error("Inconsistent binary architecture in file " + filename);
+    if (nhyper > 0u && hyperstarts[0u] != 0u)
+        throw std::runtime_error("Inconsistent binary architecture in file " + filename);
+
+    load(hyperloci, nhyper > 0u ? hyperstarts.back() : 0u, sizeof(Locus));
+    load(hyperweights, nhyper, header.effectsize);
+
+    // Note: Arrays are aligned in the file, so they are used where they are
+    // in the mapping, with no parsing and no copy (unless effects were saved
+    // in another precision). Other processes reading the same file share the
+    // same pages of memory.
+
+    // Check that the edges match the numbers of edges per trait
+    require(ne == nedgespertrait);
+
+    // Prepare to count the hyperedges of each trait
+    std::vector<size_t> nh(ntraits, 0u);
+
+    // Check that the loci of each hyperedge are distinct, within bounds and of the same trait
+    for (size_t h = 0u; h < nhyper; ++h) {
+        const size_t first = hyperstarts[h];
+        const Array<Locus> &loci = loaded.hyperloci;
+        require(loci[first] < nloci);
+        for (size_t e = first + 1u; e < hyperstarts[h + 1u]; ++e) {
+            require(loci[e] < nloci && loaded.traitids[loci[e]] == loaded.traitids[loci[first]]);
+            require(std::find(loci.begin() + first, loci.begin() + e, loci[e]) == loci.begin() + e);
+        }
+        ++nh[loaded.traitids[loci[first]]];
+    }
+
+    // Check that they match the numbers of hyperedges per trait
+    require(nh == nhyperpertrait);
+
+    // Check
+    check();
+
+}
+
+// Function to pick distinct indices uniformly at random
+std::vector<size_t> net::select(const size_t &N, const size_t &M, rnd::Generator &rng) {
+
+    // N: number of indices to pick from
+    // M: number of indices to pick
+    // rng: random number generator
+
+    // Check
+    assert(M <= N);
+
+    // Prepare to store the picked indices
+    std::vector<size_t> picked;
+    picked.reserve(M + M / 10u + 64u);
+
+    // Pick them all if needed
+    if (M == N) {
+        for (size_t t = 0u; t < N; ++t) picked.push_back(t);
+        return picked;
+    }
+
+    // Exit if none to pick
+    if (M == 0u) return picked;
+
+    // Probability to keep each index, high enough to keep at least M in most cases
+    const double p = std::min(1.0, (M + 4.0 * sqrt(M) + 10.0) / N);
+
+    // Prepare to skip over indices
+    rnd::geometric getskip(std::min(p, 1.0 - 1e-12));
+
+    // Until enough indices are kept...
+    while (picked.size() < M) {
+
+        // Start afresh
+        picked.clear();
+
+        // Keep each index with that probability
+        for (size_t t = getskip(rng); t < N; t += 1u + getskip(rng))
+            picked.push_back(t);
+
+    }
+
+    // Note: The gaps between kept indices are geometric, so jumping from one
+    // to the next takes time proportional to the number of indices kept,
+    // not to the number of indices to pick from.
+
+    // Remove indices at random until the right number is left
+    while (picked.size() > M) {
+        std::swap(picked[rnd::random(0u, picked.size() - 1u)(rng)], picked.back());
+        picked.pop_back();
+    }
+
+    // Note: Given the number of kept indices, each set of indices is equally
+    // likely, and so is each set left after removing some at random. The result
+    // is a uniform sample of M indices out of N. Only of the order of the square
+    // root of M indices are kept in excess, and fewer than M are kept (which
+    // makes us start again) with probability less than one in ten thousand.
+
+    // Check
+    assert(picked.size() == M);
+
+    // Exit
+    return picked;
+
+}
+
+// Function to find the pair of vertices with a given rank
+std::pair<size_t, size_t> net::unrank(const size_t &t) {
+
+    // t: rank of the pair (u, v), where u < v, in the order (0, 1), (0, 2), (1, 2), (0, 3)...
+
+    // Guess the larger vertex
+    size_t v = static_cast<size_t>((1.0 + sqrt(1.0 + 8.0 * t)) / 2.0);
+
+    // Correct for rounding errors
+    while (v * (v - 1u) / 2u > t) --v;
+    while ((v + 1u) * v / 2u <= t) ++v;
+
+    // Exit
+    return std::make_pair(t - v * (v - 1u) / 2u, v);
+
+}
+
+// Function to count the sets of distinct vertices of a given size
+size_t net::nsubsets(const size_t &n, const size_t &k) {
+
+    // n: number of vertices
+    // k: number of vertices in each set
+
+    // No such set if too few vertices
+    if (k > n) return 0u;
+
+    // Largest count that can be returned
+    const size_t maximum = std::numeric_limits<size_t>::max();
+
+    // Prepare to count
+    size_t count = 1u;
+
+    // For each vertex added to the sets...
+    for (size_t r = 1u; r <= k; ++r) {
+
+        // Stop at the maximum if the count gets too large
+        if (count > maximum / (n - k + r)) return maximum;
+
+        // Update the count of sets of r vertices out of n - k + r
+        count = count * (n - k + r) / r;
+
+    }
+
+    // Note: Each step is exact as the product is always divisible by r.
+
+    // Exit
+    return count;
+
+}
+
+// Function to sample a network where all pairs of vertices are equally likely to connect
+void net::random(std::vector<std::pair<size_t, size_t> > &edges, const size_t &nL, const size_t &nE, rnd::Generator &rng) {
+
+    // edges: pairs of connected vertices (to fill)
+    // nL: number of vertices
+    // nE: number of edges
+    // rng: random number generator
+
+    // Pick pairs of vertices
+    const std::vector<size_t> picked = select(nL * (nL - 1u) / 2u, nE, rng);
+
+    // Convert them into edges
+    edges.reserve(nE);
+    for (size_t t : picked) edges.push_back(unrank(t));
+
+    // Note: This is the Erdos-Renyi model with a fixed number of edges.
+
+}
+
+// Function to sample a network with a given distribution of degrees
+bool net::configuration(std::vector<std::pair<size_t, size_t> > &edges, const size_t &nL, const size_t &nE, const double &skew, rnd::Generator &rng) {
+
+    // edges: pairs of connected vertices (to fill)
+    // nL: number of vertices
+    // nE: number of edges
+    // skew: skewness of the degree distribution
+    // rng: random number generator
+
+    // Prepare to sample the vertex of each edge end (stub)
+    Sampler sampler(nL);
+    for (size_t i = 0u; i < nL; ++i)
+        sampler.set(i, pow(i + 1u, -0.5 * skew));
+
+    // Sample the degree of each vertex
+    std::vector<size_t> degrees(nL, 0u);
+    for (size_t k = 0u; k < 2u * nE; ++k) {
+
+        // Sample a vertex to get the stub
+        const size_t v = sampler.sample(rng);
+
+        // Stop giving stubs to vertices that are connected to all others
+        if (++degrees[v] == nL - 1u) sampler.set(v, 0.0);
+
+    }
+
+    // Note: This gives a heavy-tailed degree sequence, where the expected degree
+    // of a vertex decays with its rank as a power law. The degree distribution
+    // then has a tail exponent of 1 + 2 / skew, which is 3 (as in the original
+    // Barabasi-Albert model) when skew is one, and degrees are Poisson-like
+    // when skew is zero.
+
+    // Line up the stubs
+    std::vector<size_t> stubs;
+    stubs.reserve(2u * nE);
+    for (size_t i = 0u; i < nL; ++i)
+        stubs.insert(stubs.end(), degrees[i], i);
+
+    // Shuffle them
+    std::shuffle(stubs.begin(), stubs.end(), rng);
+
+    // Function to identify a pair regardless of order
+    auto key = [&](const size_t &u, const size_t &v) { return std::min(u, v) * nL + std::max(u, v); };
+
+    // Prepare to store the existing edges and the invalid ones
+    std::unordered_set<size_t> existing;
+    std::vector<std::pair<size_t, size_t> > invalid;
+    existing.reserve(nE);
+    edges.reserve(nE);
+
+    // For each pair of consecutive stubs...
+    for (size_t k = 0u; k < 2u * nE; k += 2u) {
+
+        // Vertices to connect
+        const size_t u = stubs[k];
+        const size_t v = stubs[k + 1u];
+
+        // Keep the edge unless it is a self-loop or a duplicate
+        if (u != v && existing.insert(key(u, v)).second) edges.emplace_back(u, v);
+        else invalid.emplace_back(u, v);
+
+    }
+
+    // Maximum number of attempts at repairing invalid edges
+    const size_t ntries = 100u * invalid.size() + 1000u;
+
+    // For each attempt...
+    for (size_t n = 0u; n < ntries && !invalid.empty() && !edges.empty(); ++n) {
+
+        // Sample an invalid edge to repair
+        const size_t i = rnd::random(0u, invalid.size() - 1u)(rng);
+        const size_t u = invalid[i].first;
+        const size_t v = invalid[i].second;
+
+        // Sample a valid edge to swap ends with, in either direction
+        const size_t e = rnd::random(0u, edges.size() - 1u)(rng);
+        const bool flip = rnd::random(0u, 1u)(rng);
+        const size_t x = flip ? edges[e].second : edges[e].first;
+        const size_t y = flip ? edges[e].first : edges[e].second;
+
+        // Skip if the swap would create a self-loop or a duplicate
+        if (u == x || v == y || key(u, x) == key(v, y)) continue;
+        if (existing.count(key(u, x)) || existing.count(key(v, y))) continue;
+
+        // Otherwise rewire the two edges
+        existing.erase(key(x, y));
+        existing.insert(key(u, x));
+        existing.insert(key(v, y));
+        edges[e] = std::make_pair(u, x);
+        edges.emplace_back(v, y);
+        invalid[i] = invalid.back();
+        invalid.pop_back();
+
+    }
+
+    // Note: Swapping ends keeps the degree of every vertex, and only a few
+    // edges are usually invalid, so repairing them takes little time.
+
+    // Exit
+    return invalid.empty();
+
+}
+
+// Function to sample a network with vertices clustered into blocks
+void net::blocks(std::vector<std::pair<size_t, size_t> > &edges, const size_t &nL, const size_t &nE, const size_t &nblocks, const double &cross, rnd::Generator &rng) {
+
+    // edges: pairs of connected vertices (to fill)
+    // nL: number of vertices
+    // nE: number of edges
+    // nblocks: number of blocks
+    // cross: proportion of the edges that connect different blocks
+    // rng: random number generator
+
+    // Number of blocks (no more than vertices)
+    const size_t B = std::min(nblocks, nL);
+
+    // First vertex of each block, splitting vertices evenly
+    std::vector<size_t> starts(B + 1u, 0u);
+    for (size_t b = 0u; b < B; ++b)
+        starts[b + 1u] = starts[b] + nL / B + (b < nL % B);
+
+    // Prepare to rank pairs within and between blocks
+    std::vector<size_t> within(B + 1u, 0u);
+    std::vector<size_t> between(B + 1u, 0u);
+
+    // For each block...
+    for (size_t a = 0u; a < B; ++a) {
+
+        // Number of vertices in the block
+        const size_t na = starts[a + 1u] - starts[a];
+
+        // Count pairs within the block
+        within[a + 1u] = within[a] + na * (na - 1u) / 2u;
+
+        // Count pairs with vertices of any later block
+        between[a + 1u] = between[a] + na * (nL - starts[a + 1u]);
+
+    }
+
+    // Note: Pairs of vertices are ranked block after block, with cumulative
+    // counts marking where each starts. A pair between blocks is ranked with
+    // the earlier of its two blocks, so the counts grow linearly (and not
+    // quadratically) with the number of blocks.
+
+    // Total numbers of pairs
+    const size_t nwithin = within.back();
+    const size_t nbetween = between.back();
+
+    // Split the edges between the two kinds of pairs
+    size_t ncross = std::min(nbetween, static_cast<size_t>(std::round(cross * nE)));
+    if (nE - ncross > nwithin) ncross = nE - nwithin;
+
+    // Check
+    assert(ncross <= nbetween);
+    assert(nE - ncross <= nwithin);
+
+    // Prepare to store edges
+    edges.reserve(nE);
+
+    // For each pair of vertices picked within blocks...
+    for (size_t t : select(nwithin, nE - ncross, rng)) {
+
+        // Find the block it belongs to
+        const size_t a = std::upper_bound(within.begin(), within.end(), t) - within.begin() - 1u;
+
+        // Find the pair within the block
+        const std::pair<size_t, size_t> pair = unrank(t - within[a]);
+
+        // Add the edge
+        edges.emplace_back(starts[a] + pair.first, starts[a] + pair.second);
+
+    }
+
+    // For each pair of vertices picked between blocks...
+    for (size_t t : select(nbetween, ncross, rng)) {
+
+        // Find the earlier block it belongs to
+        const size_t a = std::upper_bound(between.begin(), between.end(), t) - between.begin() - 1u;
+
+        // Find the pair of vertices, the second one from a later block
+        const size_t nb = nL - starts[a + 1u];
+        const size_t r = t - between[a];
+
+        // Add the edge
+        edges.emplace_back(starts[a] + r / nb, starts[a + 1u] + r % nb);
+
+    }
+
+    // Note: This is a stochastic block model where pairs of vertices within
+    // the same block are all equally likely to connect, and so are pairs of
+    // vertices from different blocks.
+
+}
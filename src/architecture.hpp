@@ -9,45 +9,127 @@
 
 #pragma once
 
+#include "array.hpp"
 #include <string>
 #include <vector>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include <functional>
+
+// Precision of stored effects and weights (0 double, 1 float)
+#ifndef ARCHGEN_FLOAT_EFFECTS
+#define ARCHGEN_FLOAT_EFFECTS 0
+#endif
 
 struct Parameters;
 
+class Powers;
+
+namespace rnd { class Generator; }
+
 struct Architecture {
 
+    // Compact types to store indices and effects
+    typedef std::uint32_t Locus;
+    typedef std::uint16_t Trait;
+    typedef std::conditional_t<ARCHGEN_FLOAT_EFFECTS, float, double> Effect;
+
+    // Note: Indices are streamed through for every individual when computing
+    // trait values, so storing them in four (or two) bytes instead of eight
+    // halves the memory traffic. Hyperparameters and row offsets, which can
+    // exceed these ranges, remain full-size.
+
+    // Function to receive chunks of generated edges (start loci, end loci and weights)
+    typedef std::function<void(const std::vector<Locus>&, const std::vector<Locus>&, const std::vector<Effect>&)> Flush;
+
     // Constructor
-    Architecture(const std::string& = "");
+    Architecture(const std::string& = "", const size_t& = 0u);
 
     // Functions
-    void read(const std::string&);
-    void generate(const Parameters&);
+    void read(const std::string&, const size_t& = 0u);
+    void generate(const Parameters&, const Flush& = nullptr, const size_t& = 1048576u);
+    void generate(const Parameters&, std::vector<Powers>&, const Flush& = nullptr, const size_t& = 1048576u);
+    void stream(const Parameters&, const std::string&, const bool& = false, const size_t& = 1048576u);
     void test(const Parameters&) const;
     void check() const;
-    void save(const std::string&) const;
+    void save(const std::string&, const std::vector<std::string>& = {}) const;
+    void savebinary(const std::string&, const std::vector<std::string>& = {}) const;
 
     // Internal functions
     void checkinternal() const;
+    void index(const std::vector<size_t>&);
+    void group();
+    void pack();
+    void unpack();
+    void readbinary(const std::string&);
+    static bool isbinary(const std::string&);
 
     // Hyperparameters
     size_t nloci;
     size_t nedges;
     size_t ntraits;
+    size_t npleio;
+    size_t nhyper;
 
     // Locus-specific parameters
-    std::vector<size_t> traitids;
-    std::vector<double> effects;
-    std::vector<double> domcoeffs;
+    Array<Trait> traitids;
+    Array<Effect> effects;
+    Array<Effect> domcoeffs;
+
+    // Pleiotropic effects (sparse matrix of loci by other traits)
+    std::vector<size_t> pleiostarts;
+    Array<Trait> pleiotraits;
+    Array<Effect> pleioeffects;
+    Array<Effect> pleiodomcoeffs;
+
+    // Note: The effects of locus i on traits other than its own are entries
+    // pleiostarts[i] to pleiostarts[i + 1] (excluded) of the last three vectors
+    // (compressed sparse rows). The row offsets may be empty if there are none.
 
     // Edge-specific parameters
-    std::vector<size_t> from;
-    std::vector<size_t> to;
-    std::vector<double> weights;
+    Array<Locus> from;
+    Array<Locus> to;
+    Array<Effect> weights;
+
+    // Start and end loci of the edges compressed into a stream of bytes (see packing.hpp)
+    Array<std::uint8_t> packed;
+
+    // Note: When the edges are packed, from and to are empty and the loci
+    // are decoded from the stream, a block at a time, whenever needed. The
+    // weights are kept as they are, as they do not compress.
+
+    // Hyperedge-specific parameters (interactions between more than two loci)
+    std::vector<size_t> hyperstarts;
+    Array<Locus> hyperloci;
+    Array<Effect> hyperweights;
+
+    // Note: The loci of hyperedge h are entries hyperstarts[h] to hyperstarts[h + 1]
+    // (excluded) of hyperloci, and their number is the order of the hyperedge.
+    // Hyperedges are grouped by order, so that trait values can be computed
+    // with one specialized loop per order. The offsets are empty if there are none.
+
+    // Note: The arrays above can point into a binary architecture file mapped
+    // into memory instead of holding copies of its contents, in which case
+    // they are only copied if changed (see array.hpp).
 
     // Internals
     std::vector<size_t> nlocipertrait;
     std::vector<size_t> nedgespertrait;
+    std::vector<size_t> nhyperpertrait;
 
 };
 
+// Null models of gene networks
+namespace net {
+
+    std::vector<size_t> select(const size_t&, const size_t&, rnd::Generator&);
+    std::pair<size_t, size_t> unrank(const size_t&);
+    size_t nsubsets(const size_t&, const size_t&);
+    void random(std::vector<std::pair<size_t, size_t> >&, const size_t&, const size_t&, rnd::Generator&);
+    bool configuration(std::vector<std::pair<size_t, size_t> >&, const size_t&, const size_t&, const double&, rnd::Generator&);
+    void blocks(std::vector<std::pair<size_t, size_t> >&, const size_t&, const size_t&, const size_t&, const double&, rnd::Generator&);
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+#ifndef ARCHGEN_ARRAY_HPP
+#define ARCHGEN_ARRAY_HPP
+
+// This is the header for the Array class. It is a container of values
+// that behaves like a vector, except that it can also point to values
+// held in memory it does not own (e.g. a file mapped into memory), which
+// it then keeps alive.
+
+// Note: Viewed values are read-only. They are copied into the array the
+// first time they are accessed for writing (copy on write), so that the
+// memory they come from is never modified. Reading them through a const
+// array never copies them, which is what lets processes mapping the same
+// file share its pages.
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+#include <cstddef>
+
+template <typename T>
+class Array {
+
+public:
+
+    // Types (as in standard containers)
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    // Constructors
+    Array() : values(), start(nullptr), length(0u), owner() {}
+    explicit Array(const size_t &n, const T &x = T()) : values(n, x) { sync(); }
+    Array(std::initializer_list<T> x) : values(x) { sync(); }
+    Array(const std::vector<T> &x) : values(x) { sync(); }
+    Array(std::vector<T> &&x) : values(std::move(x)) { sync(); }
+    template <typename I> requires (!std::is_integral_v<I>) Array(I first, I last) : values(first, last) { sync(); }
+
+    // Copy and move (views stay views of the same memory)
+    Array(const Array &x) : values(x.values), start(x.start), length(x.length), owner(x.owner) { if (!owner) sync(); }
+    Array(Array &&x) noexcept : Array() { swap(x); }
+    Array& operator=(Array x) noexcept { swap(x); return *this; }
+
+    // Function to view values owned by something else, kept alive by the array
+    void view(const T *x, const size_t &n, std::shared_ptr<const void> keep) {
+
+        // x: start of the values
+        // n: number of values
+        // keep: owner of the memory the values are in
+
+        // Release owned values
+        std::vector<T>().swap(values);
+
+        // Point to the viewed ones
+        start = x;
+        length = n;
+        owner = std::move(keep);
+
+    }
+
+    // Function to tell if the values are viewed rather than owned
+    bool isview() const { return owner != nullptr; }
+
+    // Read-only access (never copies viewed values)
+    size_t size() const { return length; }
+    bool empty() const { return length == 0u; }
+    const T* data() const { return start; }
+    const T& operator[](const size_t &i) const { return start[i]; }
+    const T& front() const { return start[0u]; }
+    const T& back() const { return start[length - 1u]; }
+    const_iterator begin() const { return start; }
+    const_iterator end() const { return start + length; }
+
+    // Read-write access (copies viewed values first)
+    T* data() { own(); return values.data(); }
+    T& operator[](const size_t &i) { own(); return values[i]; }
+    T& front() { own(); return values.front(); }
+    T& back() { own(); return values.back(); }
+    iterator begin() { own(); return values.data(); }
+    iterator end() { own(); return values.data() + length; }
+
+    // Functions to change the values (as for vectors)
+    void clear() { drop(); values.clear(); sync(); }
+    void resize(const size_t &n) { own(); values.resize(n); sync(); }
+    void resize(const size_t &n, const T &x) { own(); values.resize(n, x); sync(); }
+    void reserve(const size_t &n) { own(); values.reserve(n); sync(); }
+    void shrink_to_fit() { own(); values.shrink_to_fit(); sync(); }
+    void assign(const size_t &n, const T &x) { drop(); values.assign(n, x); sync(); }
+    template <typename I> void assign(I first, I last) { std::vector<T> x(first, last); drop(); values.swap(x); sync(); }
+    void push_back(const T &x) { own(); values.push_back(x); sync(); }
+    template <typename... A> void emplace_back(A&&... x) { own(); values.emplace_back(std::forward<A>(x)...); sync(); }
+    void pop_back() { own(); values.pop_back(); sync(); }
+    template <typename I> void insert(const_iterator pos, I first, I last) {
+
+        // Note: The inserted values are copied first, in case they come from
+        // this very array.
+
+        const size_t i = pos - start;
+        std::vector<T> x(first, last);
+        own();
+        values.insert(values.begin() + i, x.begin(), x.end());
+        sync();
+
+    }
+
+    // Function to swap contents with another array
+    void swap(Array &x) noexcept {
+        values.swap(x.values);
+        std::swap(start, x.start);
+        std::swap(length, x.length);
+        owner.swap(x.owner);
+    }
+
+    // Comparison
+    bool operator==(const Array &x) const { return std::equal(begin(), end(), x.begin(), x.end()); }
+
+private:
+
+    // Values, if owned
+    std::vector<T> values;
+
+    // Start and number of the values (owned or viewed)
+    const T *start;
+    size_t length;
+
+    // Owner of the viewed values (none if they are owned)
+    std::shared_ptr<const void> owner;
+
+    // Function to point to the owned values
+    void sync() { start = values.data(); length = values.size(); }
+
+    // Function to stop viewing values without copying them
+    void drop() { if (owner) { owner.reset(); sync(); } }
+
+    // Function to copy viewed values so they can be changed
+    void own() { if (owner) { values.assign(start, start + length); owner.reset(); sync(); } }
+
+};
+
+#endif
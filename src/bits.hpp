@@ -0,0 +1,183 @@
+#ifndef ARCHGEN_BITS_HPP
+#define ARCHGEN_BITS_HPP
+
+// This is the header for the bit namespace. It contains small helpers
+// to read and write whole 64-bit words at arbitrary positions of the
+// matrix of alleles, which is stored as a vector of 64-bit bitsets.
+
+// Note: These allow processing 64 alleles at once even when the rows
+// of the matrix (individuals) do not start at a bitset boundary.
+
+#include <bitset>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <bit>
+
+namespace bit {
+
+    // Number of bits per bitset
+    constexpr size_t nbits = 64u;
+
+    // Function to read the 64 bits starting at a given position
+    inline std::uint64_t get(const std::vector<std::bitset<64u> > &words, const size_t &pos) {
+
+        // words: vector of bitsets
+        // pos: position of the first bit to read
+
+        // Locate the first bit
+        const size_t j = pos / nbits;
+        const size_t k = pos % nbits;
+
+        // Check
+        assert(j < words.size());
+
+        // Read the lower part
+        std::uint64_t value = words[j].to_ullong() >> k;
+
+        // Read the upper part from the next bitset if needed
+        if (k > 0u && j + 1u < words.size())
+            value |= words[j + 1u].to_ullong() << (nbits - k);
+
+        // Exit
+        return value;
+
+    }
+
+    // Function to flip the bits set in a word, starting at a given position
+    inline void flip(std::vector<std::bitset<64u> > &words, const size_t &pos, const std::uint64_t &value) {
+
+        // words: vector of bitsets
+        // pos: position of the first bit to flip
+        // value: word whose set bits are to be flipped
+
+        // Locate the first bit
+        const size_t j = pos / nbits;
+        const size_t k = pos % nbits;
+
+        // Check
+        assert(j < words.size());
+
+        // Flip the lower part
+        words[j] ^= std::bitset<64u>(value << k);
+
+        // Flip the upper part in the next bitset if needed
+        if (k > 0u && j + 1u < words.size())
+            words[j + 1u] ^= std::bitset<64u>(value >> (nbits - k));
+
+    }
+
+    // Function to spread 32 bits onto the even bits of a word
+    inline std::uint64_t spread(std::uint64_t value) {
+
+        // value: word whose lower 32 bits are to be spread
+
+        // Move bits apart by halving distances
+        value &= 0x00000000FFFFFFFFull;
+        value = (value | (value << 16u)) & 0x0000FFFF0000FFFFull;
+        value = (value | (value << 8u)) & 0x00FF00FF00FF00FFull;
+        value = (value | (value << 4u)) & 0x0F0F0F0F0F0F0F0Full;
+        value = (value | (value << 2u)) & 0x3333333333333333ull;
+        value = (value | (value << 1u)) & 0x5555555555555555ull;
+
+        // Exit
+        return value;
+
+        // Note: Bit i ends up at bit 2i, which maps one allele per locus
+        // onto the interleaved layout of the matrix of alleles.
+
+    }
+
+    // Function to deposit the lower bits of a word every P bits
+    template <size_t P>
+    inline std::uint64_t deposit(const std::uint64_t &value) {
+
+        // value: word whose lower 64 / P bits are to be deposited
+
+        // Depending on the stride...
+        if constexpr (P == 1u) return value;
+        else if constexpr (P == 2u) return spread(value);
+        else if constexpr (P == 4u) return spread(spread(value & 0xFFFFull));
+        else {
+
+            // Otherwise move one bit at a time
+            std::uint64_t result = 0u;
+            for (size_t j = 0u; j < nbits / P; ++j)
+                result |= ((value >> j) & 1u) << (P * j);
+
+            // Exit
+            return result;
+
+        }
+
+        // Note: Bit j ends up at bit P * j, which maps one allele per locus
+        // onto the layout of the matrix of alleles for a given ploidy.
+
+    }
+
+    // Function to count the set bits within each field of P bits of a word
+    template <size_t P>
+    inline std::uint64_t dosages(const std::uint64_t &word) {
+
+        // word: word made of 64 / P fields of P bits (one per locus)
+
+        // Depending on the field width...
+        if constexpr (P == 1u) return word;
+        else if constexpr (P == 2u) return (word & 0x5555555555555555ull) + ((word >> 1u) & 0x5555555555555555ull);
+        else if constexpr (P == 4u) {
+
+            // Sum bits in pairs, then pairs in nibbles
+            const std::uint64_t pairs = word - ((word >> 1u) & 0x5555555555555555ull);
+            return (pairs & 0x3333333333333333ull) + ((pairs >> 2u) & 0x3333333333333333ull);
+
+        } else {
+
+            // Mask of a field
+            const std::uint64_t field = (1ull << P) - 1u;
+
+            // Otherwise count the bits of one field at a time
+            std::uint64_t result = 0u;
+            for (size_t j = 0u; j < nbits / P; ++j)
+                result |= static_cast<std::uint64_t>(std::popcount((word >> (P * j)) & field)) << (P * j);
+
+            // Exit
+            return result;
+
+        }
+
+        // Note: Each field of the result holds the number of 1-alleles (the
+        // dosage) of its locus. When P divides 64 this uses the first steps
+        // of a SWAR popcount, decoding all the loci of a word at once.
+
+    }
+
+    // Function to transpose a 64-by-64 matrix of bits
+    inline void transpose(std::array<std::uint64_t, 64u> &rows) {
+
+        // rows: matrix where bit j of row i is entry (i, j)
+
+        // Mask selecting the lower half of each block
+        std::uint64_t mask = 0x00000000FFFFFFFFull;
+
+        // For blocks of decreasing width...
+        for (size_t w = 32u; w > 0u; w >>= 1u, mask ^= mask << w) {
+
+            // For each pair of rows to swap blocks between...
+            for (size_t i = 0u; i < nbits; i = ((i | w) + 1u) & ~w) {
+
+                // Swap the upper block of one row with the lower block of the other
+                const std::uint64_t swap = ((rows[i] >> w) ^ rows[i | w]) & mask;
+                rows[i] ^= swap << w;
+                rows[i | w] ^= swap;
+
+            }
+        }
+
+        // Note: This is the recursive block-swapping algorithm, which
+        // transposes the matrix in six passes of 64 word operations.
+
+    }
+}
+
+#endif
@@ -0,0 +1,261 @@
+// This is the implementation for the Cache class.
+
+#include "cache.hpp"
+#include "architecture.hpp"
+#include "parameters.hpp"
+#include "mapping.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+#include <cassert>
+
+// Version of the keys (to change whenever generation changes)
+constexpr std::uint64_t cacheversion = 2u;
+
+// Constructor
+Cache::Cache(const std::string &dir, const size_t &megabytes) :
+    directory(dir),
+    limit(megabytes),
+    hits(0u),
+    misses(0u),
+    evicted(0u)
+{
+
+    // dir: directory of the cache
+    // megabytes: maximum size of the cache
+
+    // Check
+    assert(!directory.empty());
+    assert(limit > 0u);
+
+}
+
+// Function to compute the key of the architecture of a replicate
+std::string Cache::key(const Parameters &pars, const size_t &k) const {
+
+    // pars: general hyperparameters
+    // k: replicate number (starting from zero)
+
+    // Prepare to collect the bytes of everything that matters
+    std::vector<char> bytes;
+
+    // Function to add a value
+    auto add = [&](const auto &x) {
+        const char *p = reinterpret_cast<const char*>(&x);
+        bytes.insert(bytes.end(), p, p + sizeof x);
+    };
+
+    // Function to add a list of values
+    auto addall = [&](const auto &xs) {
+        add(static_cast<std::uint64_t>(xs.size()));
+        for (const auto &x : xs) add(x);
+    };
+
+    // Format of the stored architectures
+    add(cacheversion);
+    add(static_cast<std::uint64_t>(sizeof(Architecture::Locus)));
+    add(static_cast<std::uint64_t>(sizeof(Architecture::Trait)));
+    add(static_cast<std::uint64_t>(sizeof(Architecture::Effect)));
+
+    // Parameters of the architecture
+    addall(pars.nlocipertrait);
+    addall(pars.nedgespertrait);
+    addall(pars.nhyperpertrait);
+    add(pars.hyperorder);
+    addall(pars.skew);
+    add(pars.sdeffects);
+    add(pars.sddomcoeffs);
+    add(pars.sdweights);
+    add(pars.standard);
+    add(pars.network);
+    add(pars.nblocks);
+    add(pars.crossblocks);
+    add(pars.pleiotropy);
+    add(pars.pleiocorr);
+
+    // Random streams it is drawn from
+    add(pars.rng);
+    add(pars.seed);
+    add(static_cast<std::uint64_t>(k));
+
+    // Note: The number of threads is left out as it does not change the result.
+
+    // Hash it all
+    const std::uint64_t h = checksum(bytes.data(), bytes.size());
+
+    // Write the hash in hexadecimal
+    char hex[17];
+    std::snprintf(hex, sizeof hex, "%016llx", static_cast<unsigned long long>(h));
+
+    // Exit
+    return hex;
+
+}
+
+// Function to find the file of a key
+std::string Cache::path(const std::string &key) const {
+
+    // key: key of the architecture
+
+    return (std::filesystem::path(directory) / (key + ".dat")).string();
+
+}
+
+// Function to load an architecture from the cache if it is there
+bool Cache::fetch(Architecture &arch, const std::string &key) {
+
+    // arch: architecture to load into
+    // key: key of the architecture
+
+    // File of the architecture
+    const std::string file = path(key);
+
+    // Error code (to not throw on file system errors)
+    std::error_code error;
+
+    // If the file is there...
+    if (std::filesystem::exists(file, error)) {
+
+        try {
+
+            // Read it
+            arch.readbinary(file);
+
+            // Mark it as recently used
+            std::filesystem::last_write_time(file, std::filesystem::file_time_type::clock::now(), error);
+
+            // Count the hit
+            ++hits;
+
+            // Exit
+            return true;
+
+        } catch (const std::exception&) {
+
+            // Remove the file if it could not be read (e.g. damaged or from an older version)
+            std::filesystem::remove(file, error);
+
+        }
+    }
+
+    // Count the miss
+    ++misses;
+
+    // Exit
+    return false;
+
+}
+
+// Function to store an architecture in the cache
+void Cache::store(const Architecture &arch, const std::string &key) {
+
+    // arch: architecture to store
+    // key: key of the architecture
+
+    // Error code
+    std::error_code error;
+
+    // Make sure the directory exists
+    std::filesystem::create_directories(directory, error);
+
+    // File of the architecture
+    const std::string file = path(key);
+
+    // Temporary file unique to this process
+    const std::string temp = file + '.' + std::to_string(std::random_device()()) + ".tmp";
+
+    // Write the architecture into it
+    arch.savebinary(temp);
+
+    // Move it into place
+    std::filesystem::rename(temp, file, error);
+
+    // Note: Renaming is atomic, so other processes sharing the cache never
+    // see a partly written file. If they stored the same key at the same
+    // time, one of the (identical) files simply replaces the other.
+
+    // Clean up if that failed
+    if (error) std::filesystem::remove(temp, error);
+
+    // Make room if needed
+    evict(key);
+
+}
+
+// Function to remove the least recently used architectures if the cache is too big
+void Cache::evict(const std::string &keep) {
+
+    // keep: key of an architecture to keep (e.g. the one just stored)
+
+    // Error code
+    std::error_code error;
+
+    // Prepare to list the files of the cache
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path> > files;
+
+    // Total size of the cache (in bytes)
+    std::uintmax_t total = 0u;
+
+    // For each file in the directory...
+    for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+
+        // Skip other than stored architectures
+        if (!entry.is_regular_file(error) || entry.path().extension() != ".dat") continue;
+
+        // Add its size
+        total += entry.file_size(error);
+
+        // Remember it unless it must be kept
+        if (entry.path().stem() != keep) files.emplace_back(entry.last_write_time(error), entry.path());
+
+    }
+
+    // Maximum size in bytes
+    const std::uintmax_t maximum = static_cast<std::uintmax_t>(limit) << 20u;
+
+    // Stop if the cache is small enough
+    if (total <= maximum) return;
+
+    // Sort the files from the least to the most recently used
+    std::sort(files.begin(), files.end());
+
+    // Remove files until the cache is small enough
+    for (size_t i = 0u; i < files.size() && total > maximum; ++i) {
+
+        // Size of the file
+        const std::uintmax_t size = std::filesystem::file_size(files[i].second, error);
+
+        // Skip if it has gone already (e.g. removed by another process)
+        if (error) continue;
+
+        // Remove it
+        if (std::filesystem::remove(files[i].second, error)) {
+            total -= size;
+            ++evicted;
+        }
+    }
+}
+
+// Function to read the number of architectures found in the cache
+size_t Cache::nhits() const {
+
+    return hits;
+
+}
+
+// Function to read the number of architectures not found in the cache
+size_t Cache::nmisses() const {
+
+    return misses;
+
+}
+
+// Function to read the number of architectures removed from the cache
+size_t Cache::nevicted() const {
+
+    return evicted;
+
+}
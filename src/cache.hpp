@@ -0,0 +1,54 @@
+#ifndef ARCHGEN_CACHE_HPP
+#define ARCHGEN_CACHE_HPP
+
+// This is the header for the Cache class. It keeps generated genetic
+// architectures on disk, under a key computed from everything that
+// determines them, so they can be loaded instead of generated again.
+
+// Note: Architectures are stored in the binary format, one file per key,
+// in a directory that can be shared by several processes. When the files
+// take more room than allowed, the least recently used ones are removed.
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+struct Parameters;
+struct Architecture;
+
+class Cache {
+
+public:
+
+    // Constructor
+    Cache(const std::string& = "archcache", const size_t& = 1024u);
+
+    // Functions
+    std::string key(const Parameters&, const size_t&) const;
+    bool fetch(Architecture&, const std::string&);
+    void store(const Architecture&, const std::string&);
+    void evict(const std::string& = "");
+    std::string path(const std::string&) const;
+
+    // Statistics
+    size_t nhits() const;
+    size_t nmisses() const;
+    size_t nevicted() const;
+
+private:
+
+    // Directory of the cache
+    std::string directory;
+
+    // Maximum size of the cache (in megabytes)
+    size_t limit;
+
+    // Counters
+    size_t hits;
+    size_t misses;
+    size_t evicted;
+
+};
+
+#endif
@@ -1,13 +1,44 @@
 #ifndef ARCHGEN_CHECKER_HPP
 #define ARCHGEN_CHECKER_HPP
 
-// This is the header for the chk (checker) namespace.
+// This is the header for the chk (checker) namespace. It also holds
+// the level of validation of internal consistency (see check functions).
 
 #include <vector>
 #include <string>
+#include <cstddef>
+
+// Highest level of validation compiled in (full in debug builds, none otherwise)
+#ifndef ARCHGEN_VALIDATION
+#ifdef NDEBUG
+#define ARCHGEN_VALIDATION 0
+#else
+#define ARCHGEN_VALIDATION 2
+#endif
+#endif
 
 namespace chk {
 
+    // Levels of validation
+    enum Level : size_t { none, cheap, full };
+
+    // Level of validation in use (can be lowered at runtime)
+    inline size_t validation = ARCHGEN_VALIDATION;
+
+    // Function to tell whether checks of a given level should run
+    inline bool validates(const size_t &level) {
+
+        // level: level of the checks
+
+        return ARCHGEN_VALIDATION >= level && validation >= level;
+
+        // Note: The first condition is known at compile time, so checks
+        // above the compiled-in level are removed from the program, loops
+        // and all. Cheap checks take time proportional to the number of
+        // traits, and full checks to the numbers of loci and edges.
+
+    }
+
     // Function to check that a value is a proportion
     template <typename T> 
     std::string proportion(const T &x) { 
@@ -32,13 +63,53 @@ namespace chk {
 
     }
 
-    // Function to check that a value is between 0 and 4
+    // Function to check that a value is at least 2
+    template <typename T>
+    std::string atleasttwo(const T &x) {
+
+        return x < 2.0 ? "must be at least 2" : "";
+
+    }
+
+    // Function to check that a value is between 0 and 2
+    template <typename T>
+    std::string zerototwo(const T &x) {
+
+        return x < 0.0 || x > 2.0 ? "must be between 0 and 2" : "";
+
+    }
+
+    // Function to check that a value is between 0 and 3
     template <typename T>
     std::string zerotothree(const T &x) {
 
         return x < 0.0 || x > 3.0 ? "must be between 0 and 3" : "";
 
     }
+
+    // Function to check that a value is between 0 and 4
+    template <typename T>
+    std::string zerotofour(const T &x) {
+
+        return x < 0.0 || x > 4.0 ? "must be between 0 and 4" : "";
+
+    }
+
+    // Function to check that a value is between 0 and 5
+    template <typename T>
+    std::string zerotofive(const T &x) {
+
+        return x < 0.0 || x > 5.0 ? "must be between 0 and 5" : "";
+
+    }
+
+    // Function to check that a value is a supported ploidy level
+    template <typename T>
+    std::string ploidy(const T &x) {
+
+        return x != 1 && x != 2 && x != 4 && x != 6 ? "must be 1, 2, 4 or 6" : "";
+
+    }
 }
 
 #endif
\ No newline at end of file
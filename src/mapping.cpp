@@ -0,0 +1,213 @@
+// This is the implementation for the Mapping class.
+
+#include "mapping.hpp"
+#include <stdexcept>
+#include <fstream>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ARCHGEN_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define ARCHGEN_MMAP 0
+#endif
+
+// Constructor
+Mapping::Mapping(const std::string &name) :
+    filename(""),
+    start(nullptr),
+    length(0u),
+    mapped(false),
+    buffer()
+{
+
+    // name: name of the file to map (none if empty)
+
+    // Map the file if needed
+    if (name != "") open(name);
+
+}
+
+// Destructor
+Mapping::~Mapping() {
+
+    // Release the contents
+    close();
+
+}
+
+// Function to map a file into memory
+void Mapping::open(const std::string &name) {
+
+    // name: name of the file to map
+
+    // Release any previous file
+    close();
+
+#if ARCHGEN_MMAP
+
+    // Open the file
+    const int fd = ::open(name.c_str(), O_RDONLY);
+
+    // Check
+    if (fd < 0) throw std::runtime_error("Unable to open file " + name);
+
+    // Find its size
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to open file " + name);
+    }
+
+    // Record the length
+    length = static_cast<size_t>(info.st_size);
+
+    // Nothing to map if the file is empty
+    if (length == 0u) {
+        ::close(fd);
+        filename = name;
+        return;
+    }
+
+    // Map the whole file, read-only and shared with other processes
+    void *address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+
+    // Note: The mapping stays valid after the file is closed.
+    ::close(fd);
+
+    // Check
+    if (address == MAP_FAILED) {
+        length = 0u;
+        throw std::runtime_error("Unable to map file " + name);
+    }
+
+    // Tell the system the whole file will be needed
+    ::madvise(address, length, MADV_WILLNEED);
+
+    // Note: Files are read from start to end (e.g. for a checksum), but binary
+    // architectures then keep reading their arrays from the mapping, in any
+    // order, so the pages should not be dropped as soon as they are read.
+
+    // Keep the mapping
+    start = static_cast<const char*>(address);
+    mapped = true;
+
+    // Remember the file
+    filename = name;
+
+#else
+
+    // Open the file
+    std::ifstream file(name, std::ios::binary | std::ios::ate);
+
+    // Check
+    if (!file.is_open()) throw std::runtime_error("Unable to open file " + name);
+
+    // Read it whole
+    length = static_cast<size_t>(file.tellg());
+    buffer.resize(length);
+    file.seekg(0);
+    file.read(buffer.data(), length);
+
+    // Check
+    if (!file) {
+        close();
+        throw std::runtime_error("Unable to read file " + name);
+    }
+
+    // Point to the buffer
+    start = buffer.data();
+
+    // Remember the file
+    filename = name;
+
+#endif
+
+}
+
+// Function to release the contents of the file
+void Mapping::close() {
+
+#if ARCHGEN_MMAP
+
+    // Unmap if needed
+    if (mapped) ::munmap(const_cast<char*>(start), length);
+
+#endif
+
+    // Reset
+    filename = "";
+    start = nullptr;
+    length = 0u;
+    mapped = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+
+}
+
+// Function to tell if a file is open
+bool Mapping::isopen() const {
+
+    return filename != "";
+
+}
+
+// Function to access the contents
+const char* Mapping::data() const {
+
+    return start;
+
+}
+
+// Function to read the number of bytes
+size_t Mapping::size() const {
+
+    return length;
+
+}
+
+// Function to compute the checksum of a block of memory
+std::uint64_t checksum(const char *data, const size_t &n) {
+
+    // data: start of the block
+    // n: number of bytes
+
+    // Offset basis and prime of the FNV-1a hash
+    std::uint64_t h = 14695981039346656037ull;
+    const std::uint64_t prime = 1099511628211ull;
+
+    // Number of whole words
+    const size_t nwords = n / 8u;
+
+    // For each word...
+    for (size_t i = 0u; i < nwords; ++i) {
+
+        // Read the word (wherever it is aligned)
+        std::uint64_t word;
+        std::memcpy(&word, data + 8u * i, 8u);
+
+        // Mix it in
+        h = (h ^ word) * prime;
+
+    }
+
+    // Mix in the remaining bytes, if any, padded with zeros
+    if (n % 8u != 0u) {
+        std::uint64_t word = 0u;
+        std::memcpy(&word, data + 8u * nwords, n % 8u);
+        h = (h ^ word) * prime;
+    }
+
+    // Mix in the length
+    h = (h ^ n) * prime;
+
+    // Note: This is FNV-1a on 64-bit words rather than on single bytes, which
+    // is about eight times faster. Each step is invertible, so any single
+    // changed word always changes the result.
+
+    return h;
+
+}
@@ -0,0 +1,59 @@
+#ifndef ARCHGEN_MAPPING_HPP
+#define ARCHGEN_MAPPING_HPP
+
+// This is the header for the Mapping class. It gives read-only access
+// to the contents of a file by mapping it into memory, as needed to
+// load binary genetic architectures without parsing them.
+
+// Note: The file is mapped read-only and shared, so processes mapping
+// the same file use the same pages of memory, as long as they read the
+// values where they are instead of copying them (see array.hpp). Where
+// memory mapping is not available, the file is read into a buffer instead.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class Mapping {
+
+public:
+
+    // Constructor and destructor
+    Mapping(const std::string& = "");
+    ~Mapping();
+
+    // A mapping cannot be copied
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    // Functions
+    void open(const std::string&);
+    void close();
+    bool isopen() const;
+    const char* data() const;
+    size_t size() const;
+
+private:
+
+    // Name of the mapped file
+    std::string filename;
+
+    // Start and length of the contents
+    const char *start;
+    size_t length;
+
+    // Whether the contents are mapped (or else buffered)
+    bool mapped;
+
+    // Contents of the file if they could not be mapped
+    std::vector<char> buffer;
+
+};
+
+// Function to compute the checksum of a block of memory
+std::uint64_t checksum(const char*, const size_t&);
+
+#endif
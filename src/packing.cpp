@@ -0,0 +1,279 @@
+// This is the implementation for the Packer and Unpacker classes.
+
+#include "packing.hpp"
+#include <algorithm>
+#include <cstring>
+#include <bit>
+#include <limits>
+#include <cassert>
+
+// Largest number of bits of a difference between two loci (zigzag-encoded)
+constexpr size_t maxwidth = 33u;
+
+// Function to map a signed difference onto an unsigned number (zigzag)
+inline std::uint64_t zig(const std::int64_t &x) {
+
+    // x: difference to encode
+
+    return (static_cast<std::uint64_t>(x) << 1u) ^ static_cast<std::uint64_t>(x >> 63u);
+
+    // Note: This maps 0, -1, 1, -2, 2... onto 0, 1, 2, 3, 4...
+
+}
+
+// Function to map an unsigned number back onto a signed difference
+inline std::int64_t unzig(const std::uint64_t &z) {
+
+    // z: number to decode
+
+    return static_cast<std::int64_t>(z >> 1u) ^ -static_cast<std::int64_t>(z & 1u);
+
+}
+
+// Constructor
+Packer::Packer(std::vector<std::uint8_t> &stream) :
+    bytes(stream),
+    source(0u)
+{
+
+    // stream: stream of bytes to append to (can already hold packed edges)
+
+}
+
+// Function to append a number to the stream
+void Packer::put(std::uint64_t x) {
+
+    // x: number to write
+
+    // Write seven bits at a time, flagging every byte but the last
+    while (x >= 0x80u) {
+        bytes.push_back(static_cast<std::uint8_t>(x | 0x80u));
+        x >>= 7u;
+    }
+
+    // Write the last byte
+    bytes.push_back(static_cast<std::uint8_t>(x));
+
+}
+
+// Function to append a list of edges to the stream
+void Packer::add(const std::uint32_t *from, const std::uint32_t *to, const size_t &n) {
+
+    // from: start loci of the edges
+    // to: end loci of the edges
+    // n: number of edges
+
+    // For each run of edges with the same start locus...
+    for (size_t first = 0u, last = 0u; first < n; first = last) {
+
+        // Find the end of the run
+        for (last = first + 1u; last < n && from[last] == from[first]; ++last);
+
+        // Write where it starts, relative to the previous run
+        put(zig(static_cast<std::int64_t>(from[first]) - source));
+        source = from[first];
+
+        // Write its number of edges
+        put(last - first);
+
+        // Function to compute the difference between an end locus and the previous one
+        auto difference = [&](const size_t &e) {
+            return zig(static_cast<std::int64_t>(to[e]) - (e == first ? source : to[e - 1u]));
+        };
+
+        // Find the number of bits needed by the largest difference
+        size_t width = 0u;
+        for (size_t e = first; e < last; ++e) width = std::max<size_t>(width, std::bit_width(difference(e)));
+
+        // Write it
+        bytes.push_back(static_cast<std::uint8_t>(width));
+
+        // Make room for the differences
+        const size_t start = bytes.size();
+        bytes.resize(start + ((last - first) * width + 7u) / 8u, 0u);
+
+        // For each edge...
+        for (size_t e = first, bit = 0u; e < last; ++e, bit += width) {
+
+            // Write the bits of its difference, lowest first, from the current bit onwards
+            std::uint64_t z = difference(e);
+            for (size_t b = start + bit / 8u, shift = bit % 8u; z > 0u; ++b, shift = 0u) {
+                bytes[b] |= static_cast<std::uint8_t>(z << shift);
+                z >>= 8u - shift;
+            }
+        }
+    }
+
+    // Note: Edges can be added in several calls, e.g. one chunk at a time as
+    // they are generated. A run cut across two calls simply becomes two runs.
+
+}
+
+// Constructor
+Unpacker::Unpacker(const std::uint8_t *data, const size_t &n) :
+    position(data),
+    end(data + n),
+    source(0u),
+    target(0u),
+    left(0u),
+    bits(data),
+    width(0u),
+    offset(0u),
+    broken(false)
+{
+
+    // data: start of the stream of bytes
+    // n: number of bytes
+
+}
+
+// Function to read a number from the stream
+bool Unpacker::get(std::uint64_t &x) {
+
+    // x: number read
+
+    // Read seven bits at a time until the last byte
+    x = 0u;
+    for (size_t shift = 0u; position != end && shift < 64u; shift += 7u) {
+        const std::uint8_t byte = *position++;
+        x |= static_cast<std::uint64_t>(byte & 0x7fu) << shift;
+        if (byte < 0x80u) return true;
+    }
+
+    // Fail if the stream ended in the middle of a number or if it is too long
+    return false;
+
+}
+
+// Function to decode the next edges
+size_t Unpacker::next(std::uint32_t *from, std::uint32_t *to, const size_t &n) {
+
+    // from: where to write the start loci
+    // to: where to write the end loci
+    // n: maximum number of edges to decode
+
+    // Largest locus index
+    constexpr std::uint64_t maximum = std::numeric_limits<std::uint32_t>::max();
+
+    // Whether whole words can be read at once
+    constexpr bool little = std::endian::native == std::endian::little;
+
+    // Number of edges decoded
+    size_t k = 0u;
+
+    // Until enough edges are decoded...
+    while (k < n && !broken) {
+
+        // If the current run is over...
+        if (left == 0u) {
+
+            // Stop at the end of the stream
+            if (position == end) break;
+
+            // Read where the next run starts, its number of edges and the width of its differences
+            std::uint64_t z, count;
+            if (!get(z) || !get(count) || count == 0u || position == end || *position > maxwidth) { broken = true; break; }
+            width = *position++;
+
+            // Find its start locus
+            const std::int64_t s = source + unzig(z);
+            if (static_cast<std::uint64_t>(s) > maximum) { broken = true; break; }
+
+            // Check that its differences are within the stream
+            const size_t nbytes = end - position;
+            if (width > 0u && count > nbytes * 8u / width) { broken = true; break; }
+
+            // Start the run
+            source = target = static_cast<std::uint32_t>(s);
+            left = count;
+            bits = position;
+            offset = 0u;
+            position += (count * width + 7u) / 8u;
+
+        }
+
+        // Number of edges to decode from the current run
+        const size_t m = std::min<std::uint64_t>(left, n - k);
+
+        // Mask of the bits of a difference
+        const std::uint64_t mask = (1ull << width) - 1u;
+
+        // Last bit from which a whole word can be read (eight bytes before the end)
+        const size_t last = end - bits >= 8 ? (end - bits - 8) * 8u : 0u;
+
+        // Number of differences that can be read a whole word at a time
+        const size_t room = end - bits >= 8 && offset <= last ? (last - offset) / std::max<size_t>(width, 1u) + 1u : 0u;
+        const size_t quick = little ? std::min(m, room) : 0u;
+
+        // Work on local copies of the state (which the edges written cannot alias)
+        const std::uint32_t s = source;
+        std::uint32_t t = target;
+        size_t e = 0u;
+
+        // For each of those...
+        for (size_t bit = offset; e < quick; ++e, bit += width) {
+
+            // Read the difference from the word starting at its first byte
+            std::uint64_t word;
+            std::memcpy(&word, bits + bit / 8u, 8u);
+            const std::uint64_t z = (word >> (bit % 8u)) & mask;
+
+            // Find the end locus
+            const std::int64_t x = t + unzig(z);
+            if (static_cast<std::uint64_t>(x) > maximum) { broken = true; break; }
+            t = static_cast<std::uint32_t>(x);
+
+            // Record the edge
+            from[k + e] = s;
+            to[k + e] = t;
+
+        }
+
+        // For each of the others (near the end of the stream)...
+        for (size_t bit = offset + e * width; e < m && !broken; ++e, bit += width) {
+
+            // Read the difference a byte at a time
+            std::uint64_t z = 0u;
+            for (size_t b = bit / 8u, shift = 0u; shift < width + bit % 8u; ++b, shift += 8u)
+                z |= static_cast<std::uint64_t>(bits[b]) << shift;
+            z = (z >> (bit % 8u)) & mask;
+
+            // Find the end locus
+            const std::int64_t x = t + unzig(z);
+            if (static_cast<std::uint64_t>(x) > maximum) { broken = true; break; }
+            t = static_cast<std::uint32_t>(x);
+
+            // Record the edge
+            from[k + e] = s;
+            to[k + e] = t;
+
+        }
+
+        // Move on
+        target = t;
+        offset += e * width;
+        k += e;
+        left -= e;
+
+    }
+
+    // Note: Fewer edges than requested are only returned at the end of the
+    // stream or if it is malformed, which failed() tells apart.
+
+    return k;
+
+}
+
+// Function to tell if the whole stream has been decoded
+bool Unpacker::done() const {
+
+    return !broken && left == 0u && position == end;
+
+}
+
+// Function to tell if the stream was found to be malformed
+bool Unpacker::failed() const {
+
+    return broken;
+
+}
@@ -0,0 +1,86 @@
+#ifndef ARCHGEN_PACKING_HPP
+#define ARCHGEN_PACKING_HPP
+
+// This is the header for the Packer and Unpacker classes. They compress
+// the start and end loci of a list of edges into a stream of bytes and
+// decode them back, in the order the edges were added.
+
+// Note: Consecutive edges with the same start locus form a run, as when a
+// new vertex connects to several others under preferential attachment. Each
+// run is stored as the difference between its start locus and that of the
+// previous run and its number of edges (both with seven bits per byte, as
+// varints), followed by the differences between the end loci of consecutive
+// edges (the first from the start locus), bit-packed with as many bits each
+// as the largest of them needs. Differences are zigzag-encoded, so that
+// small negative ones stay small.
+
+// Note: Within a run, every difference has the same width, so each one is
+// found at a known position and decoded without waiting for the previous
+// one, which is much faster than reading a varint per edge.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class Packer {
+
+public:
+
+    // Constructor
+    Packer(std::vector<std::uint8_t>&);
+
+    // Functions
+    void add(const std::uint32_t*, const std::uint32_t*, const size_t&);
+
+private:
+
+    // Stream of bytes to append to
+    std::vector<std::uint8_t> &bytes;
+
+    // Start locus of the previous run
+    std::uint32_t source;
+
+    // Function to append a number
+    void put(std::uint64_t);
+
+};
+
+class Unpacker {
+
+public:
+
+    // Constructor
+    Unpacker(const std::uint8_t*, const size_t&);
+
+    // Functions
+    size_t next(std::uint32_t*, std::uint32_t*, const size_t&);
+    bool done() const;
+    bool failed() const;
+
+private:
+
+    // Bytes left to decode
+    const std::uint8_t *position;
+    const std::uint8_t *end;
+
+    // State of the current run
+    std::uint32_t source;
+    std::uint32_t target;
+    std::uint64_t left;
+
+    // Packed differences of the current run, their width and the next one to read (in bits)
+    const std::uint8_t *bits;
+    size_t width;
+    size_t offset;
+
+    // Whether the stream was found to be malformed
+    bool broken;
+
+    // Function to read a number
+    bool get(std::uint64_t&);
+
+};
+
+#endif
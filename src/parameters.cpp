@@ -4,7 +4,10 @@
 #include "readpars.hpp"
 #include "architecture.hpp"
 #include "checker.hpp"
+#include "random.hpp"
 #include <chrono>
+#include <algorithm>
+#include <numeric>
 
 // Create a default seed based on clock
 size_t clockseed() {
@@ -19,7 +22,9 @@ size_t clockseed() {
 // Constructor
 Parameters::Parameters(const std::string& filename) :
     nrepl(1u),
+    replicates(),
     popsize(10u),
+    ploidy(2u),
     mutation(0.0),
     sdeffects(0.0),
     sddomcoeffs(0.0),
@@ -27,22 +32,50 @@ Parameters::Parameters(const std::string& filename) :
     ntraits(1u),
     nlocipertrait(ntraits, 10u),
     nedgespertrait(ntraits, 0u),
+    nhyperpertrait(ntraits, 0u),
+    hyperorder(3u),
     skew(ntraits, 1.0),
     epistasis(ntraits, 0.0),
     dominance(ntraits, 0.0),
     envnoise(ntraits, 0.0),
+    network(0u),
+    nblocks(2u),
+    crossblocks(0.1),
+    pleiotropy(0.0),
+    pleiocorr(0.0),
     sampling(0u),
     ratio(0.25),
+    spectrum(0u),
+    shapes(2u, 1.0),
+    minfreq(0.01),
+    nfounders(10u),
+    switchrate(0.01),
+    ndemes(1u),
+    demesizes(),
+    fst(0.0),
+    ngenerations(0u),
+    recombination(0.5),
+    lastonly(true),
     seed(clockseed()),
+    rng(0u),
+    nthreads(0u),
+    validation(ARCHGEN_VALIDATION),
     import(false),
     standard(false),
     loadarch(false),
     savearch(true),
+    binarch(false),
+    streamarch(false),
+    packedges(false),
+    patcharch(false),
+    archcache(false),
+    cachesize(1024u),
     savepars(true),
     binary(false),
     verbose(true),
     nloci(0u),
-    nedges(0u)
+    nedges(0u),
+    nhyper(0u)
 {
 
     // filename: optional parameter input file
@@ -64,10 +97,24 @@ void Parameters::update() {
     // Reset
     nloci = 0u;
     nedges = 0u;
+    nhyper = 0u;
+
+    // Fit the default of no hyperedges to the number of traits
+    if (std::all_of(nhyperpertrait.begin(), nhyperpertrait.end(), [](const size_t &n) { return n == 0u; }))
+        nhyperpertrait.assign(ntraits, 0u);
+
+    // Note: Hyperedges are optional, so they need not be given whenever
+    // the number of traits changes.
 
     // Count
     for (size_t n : nlocipertrait) nloci += n;
     for (size_t n : nedgespertrait) nedges += n;
+    for (size_t n : nhyperpertrait) nhyper += n;
+
+    // Split the population evenly between demes if sizes are not given
+    if (demesizes.empty() && ndemes <= popsize)
+        for (size_t d = 0u; d < ndemes; ++d)
+            demesizes.push_back(popsize / ndemes + (d < popsize % ndemes));
 
 }
 
@@ -82,6 +129,13 @@ void Parameters::read(const std::string &filename) {
     // Open the file
     reader.open();
 
+    // Forget deme sizes unless given in the file
+    demesizes.clear();
+
+    // Forget replicates to run unless given in the file
+    std::vector<std::pair<size_t, size_t> > ranges;
+    replicates.clear();
+
     // For each line in the file...
     while (!reader.iseof()) {
 
@@ -103,7 +157,9 @@ void Parameters::read(const std::string &filename) {
 
         // Read the parameter value(s)
         if (name == "nrepl") reader.readvalue<size_t>(nrepl, chk::strictpos<size_t>);
+        else if (name == "replicates") reader.readranges<size_t>(ranges, chk::strictpos<size_t>);
         else if (name == "popsize") reader.readvalue<size_t>(popsize, chk::strictpos<size_t>);
+        else if (name == "ploidy") reader.readvalue<size_t>(ploidy, chk::ploidy<size_t>);
         else if (name == "mutation") reader.readvalue<double>(mutation, chk::proportion<double>);
         else if (name == "sdeffects") reader.readvalue<double>(sdeffects, chk::positive<double>);
         else if (name == "sddomcoeffs") reader.readvalue<double>(sddomcoeffs, chk::positive<double>);
@@ -111,17 +167,44 @@ void Parameters::read(const std::string &filename) {
         else if (name == "ntraits") reader. readvalue<size_t>(ntraits, chk::strictpos<size_t>);
         else if (name == "nlocipertrait") reader.readvalues<size_t>(nlocipertrait, ntraits, chk::strictpos<size_t>);
         else if (name == "nedgespertrait") reader.readvalues<size_t>(nedgespertrait, ntraits);
+        else if (name == "nhyperpertrait") reader.readvalues<size_t>(nhyperpertrait, ntraits);
+        else if (name == "hyperorder") reader.readvalue<size_t>(hyperorder, chk::atleasttwo<size_t>);
         else if (name == "skew") reader.readvalues<double>(skew, ntraits);
         else if (name == "epistasis") reader.readvalues<double>(epistasis, ntraits, chk::proportion<double>);
         else if (name == "dominance") reader.readvalues<double>(dominance, ntraits, chk::positive<double>);
         else if (name == "envnoise") reader.readvalues<double>(envnoise, ntraits, chk::positive<double>);
-        else if (name == "sampling") reader.readvalue<size_t>(sampling, chk::zerotothree<size_t>);
+        else if (name == "network") reader.readvalue<size_t>(network, chk::zerotothree<size_t>);
+        else if (name == "nblocks") reader.readvalue<size_t>(nblocks, chk::strictpos<size_t>);
+        else if (name == "crossblocks") reader.readvalue<double>(crossblocks, chk::proportion<double>);
+        else if (name == "pleiotropy") reader.readvalue<double>(pleiotropy, chk::proportion<double>);
+        else if (name == "pleiocorr") reader.readvalue<double>(pleiocorr, chk::proportion<double>);
+        else if (name == "sampling") reader.readvalue<size_t>(sampling, chk::zerotofive<size_t>);
         else if (name == "ratio") reader.readvalue<double>(ratio, chk::proportion<double>);
+        else if (name == "spectrum") reader.readvalue<size_t>(spectrum, chk::zerotothree<size_t>);
+        else if (name == "shapes") reader.readvalues<double>(shapes, 2u, chk::strictpos<double>);
+        else if (name == "minfreq") reader.readvalue<double>(minfreq, chk::strictpos<double>);
+        else if (name == "nfounders") reader.readvalue<size_t>(nfounders, chk::strictpos<size_t>);
+        else if (name == "switchrate") reader.readvalue<double>(switchrate, chk::proportion<double>);
+        else if (name == "ndemes") reader.readvalue<size_t>(ndemes, chk::strictpos<size_t>);
+        else if (name == "demesizes") reader.readvalues<size_t>(demesizes, ndemes, chk::strictpos<size_t>);
+        else if (name == "fst") reader.readvalue<double>(fst, chk::proportion<double>);
+        else if (name == "ngenerations") reader.readvalue<size_t>(ngenerations);
+        else if (name == "recombination") reader.readvalue<double>(recombination, chk::proportion<double>);
+        else if (name == "lastonly") reader.readvalue<bool>(lastonly);
         else if (name == "seed") reader.readvalue<size_t>(seed);
+        else if (name == "rng") reader.readvalue<size_t>(rng, chk::zerotothree<size_t>);
+        else if (name == "nthreads") reader.readvalue<size_t>(nthreads);
+        else if (name == "validation") reader.readvalue<size_t>(validation, chk::zerototwo<size_t>);
         else if (name == "import") reader.readvalue<bool>(import);
         else if (name == "standard") reader.readvalue<bool>(standard);
         else if (name == "loadarch") reader.readvalue<bool>(loadarch);
         else if (name == "savearch") reader.readvalue<bool>(savearch);
+        else if (name == "binarch") reader.readvalue<bool>(binarch);
+        else if (name == "streamarch") reader.readvalue<bool>(streamarch);
+        else if (name == "packedges") reader.readvalue<bool>(packedges);
+        else if (name == "patcharch") reader.readvalue<bool>(patcharch);
+        else if (name == "archcache") reader.readvalue<bool>(archcache);
+        else if (name == "cachesize") reader.readvalue<size_t>(cachesize, chk::strictpos<size_t>);
         else if (name == "savepars") reader.readvalue<bool>(savepars);
         else if (name == "binary") reader.readvalue<bool>(binary);
         else if (name == "verbose") reader.readvalue<bool>(verbose);
@@ -142,6 +225,56 @@ void Parameters::read(const std::string &filename) {
     // Update internals
     update();
 
+    // Find the last replicate to run
+    size_t last = 0u;
+    for (auto &range : ranges) last = std::max(last, range.second);
+
+    // Check that the replicates to run exist (before expanding the ranges)
+    if (last > nrepl)
+        throw std::runtime_error("Replicate " + std::to_string(last) + " is out of bounds in file " + filename);
+
+    // Expand the ranges of replicates to run
+    for (auto &range : ranges)
+        for (size_t i = range.first; i <= range.second; ++i) replicates.push_back(i);
+
+    // Sort the replicates to run and remove duplicates
+    std::sort(replicates.begin(), replicates.end());
+    replicates.erase(std::unique(replicates.begin(), replicates.end()), replicates.end());
+
+    // Check that reproduction is possible
+    if (ngenerations > 0u && ploidy != 2u)
+        throw std::runtime_error("Reproduction is only available for diploids in file " + filename);
+
+    // Check that there are not more demes than individuals
+    if (ndemes > popsize)
+        throw std::runtime_error("Parameter ndemes must not exceed popsize in file " + filename);
+
+    // Check that deme sizes add up to the population size
+    if (std::accumulate(demesizes.begin(), demesizes.end(), size_t(0u)) != popsize)
+        throw std::runtime_error("Deme sizes must add up to popsize in file " + filename);
+
+    // Check that architectures can be cached
+    if (archcache && rng != rnd::counter)
+        throw std::runtime_error("Parameter archcache requires the counter-based engine (rng 3) in file " + filename);
+
+    // Note: Other engines draw the architecture from the same sequence as the rest
+    // of the simulation, which would then change depending on whether the
+    // architecture was found in the cache.
+
+    // Check that streamed architectures are generated
+    if (streamarch && loadarch)
+        throw std::runtime_error("Parameter streamarch cannot be used with loadarch in file " + filename);
+    if (streamarch && archcache)
+        throw std::runtime_error("Parameter streamarch cannot be used with archcache in file " + filename);
+
+    // Check that the architecture to patch is read from file
+    if (patcharch && !loadarch)
+        throw std::runtime_error("Parameter patcharch requires loadarch in file " + filename);
+
+    // Check that the neutral spectrum is defined
+    if (minfreq >= 0.5)
+        throw std::runtime_error("Parameter minfreq must be smaller than 0.5 in file " + filename);
+
     // Note: Here the number of traits cannot be greater than the number
     // of loci, so no need to check for that.
 
@@ -159,6 +292,10 @@ void Parameters::read(const std::string &filename) {
         // Note: This does not guarantee that all edges will be made. See the implementation
         // the genetic architecture for more details.
 
+        // Check that there are enough distinct sets of loci for the hyperedges
+        if (nhyperpertrait[i] > net::nsubsets(nlocipertrait[i], hyperorder))
+            throw std::runtime_error("Too many hyperedges for the number of loci for trait " + std::to_string(i + 1u) + " in file " + filename);
+
     }
 
     // Check
@@ -176,6 +313,8 @@ void Parameters::override(const Architecture &arch) {
     nedges = arch.nedges;
     nlocipertrait = arch.nlocipertrait;
     nedgespertrait = arch.nedgespertrait;
+    nhyper = arch.nhyper;
+    nhyperpertrait = arch.nhyperpertrait;
 
     // Check
     check();
@@ -188,6 +327,7 @@ void Parameters::checkinternal() const {
     // Prepare
     size_t nl = 0u;
     size_t ne = 0u;
+    size_t nh = 0u;
 
     // For each trait...
     for (size_t i = 0u; i < ntraits; ++i) {
@@ -195,24 +335,31 @@ void Parameters::checkinternal() const {
         // Count
         nl += nlocipertrait[i];
         ne += nedgespertrait[i];
+        nh += nhyperpertrait[i];
         
     }
 
     // Check
     assert(nl == nloci);
     assert(ne == nedges);
+    assert(nh == nhyper);
 
 }
 
 // Function to check that parameters are valid
 void Parameters::check() const {
 
+    // Skip if no validation
+    if (!chk::validates(chk::cheap)) return;
+
     // Check internal consistency
     checkinternal();
 
     // Check validity
     assert(nrepl > 0u);
+    assert(std::is_sorted(replicates.begin(), replicates.end()));
     assert(popsize > 0u);
+    assert(chk::ploidy(ploidy).empty());
     assert(ntraits > 0u);
     assert(ntraits <= nloci);
     assert(mutation >= 0.0 && mutation <= 1.0);
@@ -221,24 +368,46 @@ void Parameters::check() const {
     assert(sdweights >= 0.0);
     assert(nlocipertrait.size() == ntraits);
     assert(nedgespertrait.size() == ntraits);
+    assert(nhyperpertrait.size() == ntraits);
+    assert(hyperorder >= 2u);
     assert(skew.size() == ntraits);
     assert(epistasis.size() == ntraits);
     assert(dominance.size() == ntraits);
     assert(envnoise.size() == ntraits);
-    assert(sampling < 4u);
+    assert(network < 4u);
+    assert(nblocks > 0u);
+    assert(crossblocks >= 0.0 && crossblocks <= 1.0);
+    assert(pleiotropy >= 0.0 && pleiotropy <= 1.0);
+    assert(pleiocorr >= 0.0 && pleiocorr <= 1.0);
+    assert(sampling < 6u);
     assert(ratio >= 0.0 && ratio <= 1.0);
+    assert(spectrum < 4u);
+    assert(shapes.size() == 2u);
+    assert(minfreq > 0.0 && minfreq < 0.5);
+    assert(nfounders > 0u);
+    assert(switchrate >= 0.0 && switchrate <= 1.0);
+    assert(ndemes > 0u && ndemes <= popsize);
+    assert(demesizes.size() == ndemes);
+    assert(std::accumulate(demesizes.begin(), demesizes.end(), size_t(0u)) == popsize);
+    assert(fst >= 0.0 && fst <= 1.0);
+    assert(recombination >= 0.0 && recombination <= 1.0);
+    assert(rng < 4u);
+    assert(validation < 3u);
 
     // Vectors
+    for (size_t i : replicates) assert(i > 0u && i <= nrepl);
     for (size_t i : nlocipertrait) assert(i > 0u);
     for (double x : epistasis) assert(x >= 0.0 && x <= 1.0);
     for (double x : dominance) assert(x >= 0.0);
     for (double x : envnoise) assert(x >= 0.0);
+    for (double x : shapes) assert(x > 0.0);
 
     // For each trait...
     for (size_t i = 0u; i < ntraits; ++i) {
 
         // Check
         assert(nedgespertrait[i] <= nlocipertrait[i] * (nlocipertrait[i] - 1u) / 2u);
+        assert(nhyperpertrait[i] <= net::nsubsets(nlocipertrait[i], hyperorder));
 
     }
 }
@@ -257,7 +426,28 @@ void Parameters::save(const std::string &filename) const {
 
     // Write parameters to the file
     file << "nrepl " << nrepl << '\n';
+
+    // Write the replicates to run as ranges, if any
+    if (!replicates.empty()) {
+
+        // For each run of consecutive replicates...
+        file << "replicates";
+        for (size_t i = 0u, j = 0u; i < replicates.size(); i = j) {
+
+            // Find the end of the run
+            for (j = i + 1u; j < replicates.size() && replicates[j] == replicates[j - 1u] + 1u; ++j);
+
+            // Write it as a single value or a range
+            file << ' ' << replicates[i];
+            if (j - 1u > i) file << '-' << replicates[j - 1u];
+
+        }
+        file << '\n';
+
+    }
+
     file << "popsize " << popsize << '\n';    
+    file << "ploidy " << ploidy << '\n';
     file << "mutation " << mutation << '\n';
     file << "sdeffects " << sdeffects << '\n';
     file << "sddomcoeffs " << sddomcoeffs << '\n';
@@ -269,6 +459,10 @@ void Parameters::save(const std::string &filename) const {
     file << "nedgespertrait";
     for (size_t i : nedgespertrait) file << ' ' << i;
     file << '\n';
+    file << "nhyperpertrait";
+    for (size_t i : nhyperpertrait) file << ' ' << i;
+    file << '\n';
+    file << "hyperorder " << hyperorder << '\n';
     file << "skew";
     for (double x : skew) file << ' ' << x;
     file << '\n';
@@ -281,13 +475,44 @@ void Parameters::save(const std::string &filename) const {
     file << "envnoise";
     for (double x : envnoise) file << ' ' << x;
     file << '\n';    
+    file << "network " << network << '\n';
+    file << "nblocks " << nblocks << '\n';
+    file << "crossblocks " << crossblocks << '\n';
+    file << "pleiotropy " << pleiotropy << '\n';
+    file << "pleiocorr " << pleiocorr << '\n';
     file << "sampling " << sampling << '\n';
     file << "ratio " << ratio << '\n';
+    file << "spectrum " << spectrum << '\n';
+    file << "shapes";
+    for (double x : shapes) file << ' ' << x;
+    file << '\n';
+    file << "minfreq " << minfreq << '\n';
+    file << "nfounders " << nfounders << '\n';
+    file << "switchrate " << switchrate << '\n';
+    file << "ndemes " << ndemes << '\n';
+    if (ndemes > 1u) {
+        file << "demesizes";
+        for (size_t i : demesizes) file << ' ' << i;
+        file << '\n';
+    }
+    file << "fst " << fst << '\n';
+    file << "ngenerations " << ngenerations << '\n';
+    file << "recombination " << recombination << '\n';
+    file << "lastonly " << lastonly << '\n';
     file << "seed " << seed << '\n';
+    file << "rng " << rng << '\n';
+    file << "nthreads " << nthreads << '\n';
+    file << "validation " << validation << '\n';
     file << "import " << import << '\n';
     file << "standard " << standard << '\n';
     file << "loadarch " << loadarch << '\n';
     file << "savearch " << savearch << '\n';
+    file << "binarch " << binarch << '\n';
+    file << "streamarch " << streamarch << '\n';
+    file << "packedges " << packedges << '\n';
+    file << "patcharch " << patcharch << '\n';
+    file << "archcache " << archcache << '\n';
+    file << "cachesize " << cachesize << '\n';
     file << "savepars " << savepars << '\n';
     file << "binary " << binary << '\n';
     file << "verbose " << verbose << '\n';
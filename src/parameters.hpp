@@ -30,7 +30,9 @@ struct Parameters {
 
     // Parameters
     size_t nrepl;                           // number of replicates
+    std::vector<size_t> replicates;         // replicates to run (all if empty)
     size_t popsize;                         // population size
+    size_t ploidy;                          // number of alleles per locus
     double mutation;                        // mutation rate
     double sdeffects;                       // standard deviation of additive effect sizes of loci
     double sddomcoeffs;                     // standard deviation of dominance coefficients of loci
@@ -38,17 +40,44 @@ struct Parameters {
     size_t ntraits;                         // number of traits
     std::vector<size_t> nlocipertrait;      // number of loci affecting each trait
     std::vector<size_t> nedgespertrait;     // number of edges affecting each trait
+    std::vector<size_t> nhyperpertrait;     // number of hyperedges (higher-order interactions) affecting each trait
+    size_t hyperorder;                      // number of loci interacting in each generated hyperedge
     std::vector<double> skew;               // skewness of the degree distributions of each trait network
     std::vector<double> epistasis;          // scaling parameters for the importance of interactions in trait development
     std::vector<double> dominance;          // scaling parameters for the importance of dominance effects in trait development
     std::vector<double> envnoise;           // scaling parameters for the importance of environmental effects in trait development
+    size_t network;                         // model of gene networks
+    size_t nblocks;                         // number of blocks of loci in block networks
+    double crossblocks;                     // proportion of edges between blocks in block networks
+    double pleiotropy;                      // probability that a locus also affects each other trait
+    double pleiocorr;                       // correlation between the effects of a locus on different traits
     size_t sampling;                        // sampling mode for mutations
     double ratio;                           // density of mutations below which to shuffle only partially
+    size_t spectrum;                        // distribution of allele frequencies across loci
+    std::vector<double> shapes;             // shape parameters of the beta distribution of allele frequencies
+    double minfreq;                         // lowest allele frequency in the neutral spectrum
+    size_t nfounders;                       // number of founder haplotypes to copy blocks from
+    double switchrate;                      // probability to switch founder between consecutive loci
+    size_t ndemes;                          // number of demes (subpopulations)
+    std::vector<size_t> demesizes;          // number of individuals in each deme
+    double fst;                             // fixation index between demes
+    size_t ngenerations;                    // number of generations of reproduction
+    double recombination;                   // probability of crossover between consecutive loci
+    bool lastonly;                          // whether to save trait values of the last generation only
     size_t seed;                            // random seed
+    size_t rng;                             // engine of the random number generator
+    size_t nthreads;                        // maximum number of threads (all cores if zero)
+    size_t validation;                      // level of validation of internal consistency
     bool import;                            // whether to import the matrix of alleles from file
     bool standard;                          // whether to standardize generated architecture parameters
     bool loadarch;                          // whether to read the genetic architecture from file
     bool savearch;                          // whether to save the genetic architecture to file
+    bool binarch;                           // whether to save the genetic architecture in binary (if not, text)
+    bool streamarch;                        // whether to write generated architectures to file as they are made, without simulating
+    bool packedges;                         // whether to store the edges of the genetic architecture compressed
+    bool patcharch;                         // whether to update the trait values of a previous run for edits to its architecture
+    bool archcache;                         // whether to keep generated architectures in a cache directory
+    size_t cachesize;                       // maximum size of the architecture cache (in megabytes)
     bool savepars;                          // whether to save the parameters to file
     bool binary;                            // whether to save the matrix of alleles in binary (if not, CSV)
     bool verbose;                           // print progress to screen
@@ -56,6 +85,7 @@ struct Parameters {
     // Internal
     size_t nloci;                           // number of loci
     size_t nedges;                          // number of edges across all trait networks
+    size_t nhyper;                          // number of hyperedges across all traits
 
 };
 
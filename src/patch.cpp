@@ -0,0 +1,135 @@
+// This is the implementation for the Patch class.
+
+#include "patch.hpp"
+#include "readpars.hpp"
+#include "checker.hpp"
+#include <unordered_set>
+#include <stdexcept>
+#include <cassert>
+
+// Constructor
+Patch::Patch(const std::string &patchfile) :
+    nloci(0u),
+    nedges(0u),
+    loci(),
+    effects(),
+    domcoeffs(),
+    edges(),
+    weights()
+{
+
+    // patchfile: (optional) name of the file to read from
+
+    // Read from file if needed
+    if (patchfile != "") read(patchfile);
+
+}
+
+// Function to read a patch from a file
+void Patch::read(const std::string &filename) {
+
+    // filename: name of the file to read from
+
+    // Create a reader
+    ReadPars reader(filename);
+
+    // Open it
+    reader.open();
+
+    // For each line in the file...
+    while (!reader.iseof()) {
+
+        // Read a line
+        reader.readline();
+
+        // Skip empty line
+        if (reader.isempty()) continue;
+
+        // Skip if comment line
+        if (reader.iscomment()) continue;
+
+        // Current parameter name
+        std::string name = reader.getname();
+
+        // Read the parameter value(s)
+        if (name == "nloci") reader.readvalue<size_t>(nloci);
+        else if (name == "loci") reader.readvalues<size_t>(loci, nloci, chk::strictpos<size_t>);
+        else if (name == "effects") reader.readvalues<Architecture::Effect>(effects, nloci);
+        else if (name == "domcoeffs") reader.readvalues<Architecture::Effect>(domcoeffs, nloci);
+        else if (name == "nedges") reader.readvalue<size_t>(nedges);
+        else if (name == "edges") reader.readvalues<size_t>(edges, nedges, chk::strictpos<size_t>);
+        else if (name == "weights") reader.readvalues<Architecture::Effect>(weights, nedges);
+        else
+            reader.readerror();
+
+        // Check that we have reached the end of the line
+        assert(reader.iseol());
+
+    }
+
+    // Close the file
+    reader.close();
+
+    // Check that all vectors have the right size
+    if (loci.size() != nloci) throw std::runtime_error("Number of patched loci does not match nloci in file " + filename);
+    if (!effects.empty() && effects.size() != nloci) throw std::runtime_error("Number of effects does not match number of patched loci in file " + filename);
+    if (!domcoeffs.empty() && domcoeffs.size() != nloci) throw std::runtime_error("Number of dominance effects does not match number of patched loci in file " + filename);
+    if (edges.size() != nedges) throw std::runtime_error("Number of patched edges does not match nedges in file " + filename);
+    if (weights.size() != nedges) throw std::runtime_error("Number of interaction weights does not match number of patched edges in file " + filename);
+
+    // Note: Effects and dominance coefficients may be left out, in which case
+    // they remain as they are, but patched edges can only change their weights.
+
+    // Make the indices zero-based
+    for (size_t &l : loci) --l;
+    for (size_t &e : edges) --e;
+
+    // Check that nothing is patched twice
+    if (std::unordered_set<size_t>(loci.begin(), loci.end()).size() != nloci)
+        throw std::runtime_error("Some loci are patched more than once in file " + filename);
+    if (std::unordered_set<size_t>(edges.begin(), edges.end()).size() != nedges)
+        throw std::runtime_error("Some edges are patched more than once in file " + filename);
+
+}
+
+// Function to check that the patch fits an architecture
+void Patch::test(const Architecture &arch) const {
+
+    // arch: architecture to be patched
+
+    // Error if a patched locus does not exist
+    for (size_t l : loci)
+        if (l >= arch.nloci)
+            throw std::runtime_error("Patched locus " + std::to_string(l + 1u) + " is out of bounds of the architecture");
+
+    // Error if a patched edge does not exist
+    for (size_t e : edges)
+        if (e >= arch.nedges)
+            throw std::runtime_error("Patched edge " + std::to_string(e + 1u) + " is out of bounds of the architecture");
+
+}
+
+// Function to make the edits to an architecture
+void Patch::apply(Architecture &arch) const {
+
+    // arch: architecture to patch
+
+    // Check
+    test(arch);
+
+    // For each patched locus...
+    for (size_t i = 0u; i < nloci; ++i) {
+
+        // Replace its parameters if needed
+        if (!effects.empty()) arch.effects[loci[i]] = effects[i];
+        if (!domcoeffs.empty()) arch.domcoeffs[loci[i]] = domcoeffs[i];
+
+    }
+
+    // Replace the weights of the patched edges
+    for (size_t i = 0u; i < nedges; ++i) arch.weights[edges[i]] = weights[i];
+
+    // Check
+    arch.check();
+
+}
@@ -0,0 +1,43 @@
+#ifndef ARCHGEN_PATCH_HPP
+#define ARCHGEN_PATCH_HPP
+
+// This is the header for the Patch class. It holds edits to be made to
+// a genetic architecture: new effects and dominance coefficients for some
+// loci and new interaction weights for some edges, so that trait values
+// can be updated for the touched loci and edges only.
+
+#pragma once
+
+#include "architecture.hpp"
+#include <string>
+#include <vector>
+
+struct Patch {
+
+    // Constructor
+    Patch(const std::string& = "");
+
+    // Functions
+    void read(const std::string&);
+    void test(const Architecture&) const;
+    void apply(Architecture&) const;
+
+    // Hyperparameters
+    size_t nloci;
+    size_t nedges;
+
+    // Patched loci and their new parameters (empty if unchanged)
+    std::vector<size_t> loci;
+    std::vector<Architecture::Effect> effects;
+    std::vector<Architecture::Effect> domcoeffs;
+
+    // Patched edges and their new weights
+    std::vector<size_t> edges;
+    std::vector<Architecture::Effect> weights;
+
+    // Note: Loci and edges are indexed from zero here, in the order in which
+    // they come in the architecture, but from one in patch files.
+
+};
+
+#endif
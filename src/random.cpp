@@ -3,5 +3,5 @@
 #include "random.hpp"
 
 // Random number generator
-std::mt19937_64 rnd::rng;
+rnd::Generator rnd::rng;
 
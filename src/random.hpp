@@ -3,7 +3,9 @@
 
 // This is the header for the namespace rnd (random). It contains aliases for
 // various kinds of probability distributions as well as a random number
-// generator.
+// generator. The generator can run on one of several engines, selected
+// at runtime (see the rng parameter). Each engine can also be used on its
+// own wherever a standard random number engine is expected.
 
 // Example usage:
 //
@@ -18,6 +20,10 @@
 
 #include <stddef.h>
 #include <random>
+#include <cstdint>
+#include <cmath>
+#include <bit>
+#include <array>
 
 namespace rnd
 {
@@ -34,8 +40,489 @@ namespace rnd
     typedef std::gamma_distribution<double> gamma;
     typedef std::bernoulli_distribution bernoulli;
 
+    // Available engines
+    enum engines : size_t { mersenne = 0u, xoshiro = 1u, pcg = 2u, counter = 3u };
+
+    // Phases of the simulation that draw from their own counter-based streams
+    enum phases : std::uint64_t { sequential = 0u, frequencies = 1u, mutation = 2u, effects = 3u, shuffle = 4u, network = 5u, noise = 6u, founders = 7u, haplotypes = 8u, demes = 9u, reproduction = 10u, pleiotropy = 11u, hyperedges = 12u };
+
+    // Function to scramble a 64-bit state into a well-mixed output
+    inline std::uint64_t splitmix(std::uint64_t &state) {
+
+        // state: state to advance
+
+        // Advance the state and mix it
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31u);
+
+        // Note: This is SplitMix64, used to seed the engines below from a
+        // single 64-bit seed.
+
+    }
+
+    // Xoshiro256++ engine
+    class Xoshiro {
+
+    public:
+
+        typedef std::uint64_t result_type;
+
+        // Constructor
+        Xoshiro(const std::uint64_t &s = 0u) { seed(s); }
+
+        // Function to seed the engine
+        void seed(std::uint64_t s) { for (std::uint64_t &x : state) x = splitmix(s); }
+
+        // Range of the output
+        static constexpr result_type min() { return 0u; }
+        static constexpr result_type max() { return ~result_type(0u); }
+
+        // Function to draw the next number
+        result_type operator()() {
+
+            // Compute output
+            const result_type result = std::rotl(state[0u] + state[3u], 23) + state[0u];
+
+            // Advance the state
+            const result_type t = state[1u] << 17u;
+            state[2u] ^= state[0u];
+            state[3u] ^= state[1u];
+            state[1u] ^= state[2u];
+            state[0u] ^= state[3u];
+            state[2u] ^= t;
+            state[3u] = std::rotl(state[3u], 45);
+
+            // Exit
+            return result;
+
+        }
+
+    private:
+
+        // Internal state (256 bits)
+        result_type state[4u];
+
+    };
+
+    // PCG64 engine (XSL-RR output on a 128-bit linear congruential state)
+    class PCG {
+
+    public:
+
+        typedef std::uint64_t result_type;
+
+        // Constructor
+        PCG(const std::uint64_t &s = 0u) { seed(s); }
+
+        // Function to seed the engine
+        void seed(std::uint64_t s) {
+
+            // Derive the initial state from the seed
+            const std::uint64_t hi = splitmix(s);
+            const std::uint64_t lo = splitmix(s);
+
+            // Reset, step, add the initial state and step again
+            high = 0u;
+            low = 0u;
+            step();
+            add(hi, lo);
+            step();
+
+        }
+
+        // Range of the output
+        static constexpr result_type min() { return 0u; }
+        static constexpr result_type max() { return ~result_type(0u); }
+
+        // Function to draw the next number
+        result_type operator()() {
+
+            // Advance the state
+            step();
+
+            // Fold the state into 64 bits and rotate by its top bits
+            return std::rotr(high ^ low, static_cast<int>(high >> 58u));
+
+        }
+
+    private:
+
+        // Internal state (upper and lower 64 bits)
+        std::uint64_t high;
+        std::uint64_t low;
+
+        // Function to compute the upper 64 bits of a 64-by-64-bit product
+        static std::uint64_t mulhi(const std::uint64_t &a, const std::uint64_t &b) {
+
+            #if defined(__SIZEOF_INT128__)
+
+            // Use native 128-bit arithmetic if available
+            return static_cast<std::uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64u);
+
+            #else
+
+            // Otherwise multiply 32-bit halves
+            const std::uint64_t a0 = a & 0xFFFFFFFFu, a1 = a >> 32u;
+            const std::uint64_t b0 = b & 0xFFFFFFFFu, b1 = b >> 32u;
+            const std::uint64_t mid = a1 * b0 + ((a0 * b0) >> 32u);
+            return a1 * b1 + (mid >> 32u) + (((mid & 0xFFFFFFFFu) + a0 * b1) >> 32u);
+
+            #endif
+
+        }
+
+        // Function to add a 128-bit number to the state
+        void add(const std::uint64_t &hi, const std::uint64_t &lo) {
+
+            // Add with carry
+            low += lo;
+            high += hi + (low < lo);
+
+        }
+
+        // Function to advance the state
+        void step() {
+
+            // Multiplier of the reference implementation
+            const std::uint64_t mhi = 0x2360ED051FC65DA4ull;
+            const std::uint64_t mlo = 0x4385DF649FCCF645ull;
+
+            // Multiply the state (modulo 2^128)
+            high = mulhi(low, mlo) + low * mhi + high * mlo;
+            low = low * mlo;
+
+            // Add the increment of the reference implementation
+            add(0x5851F42D4C957F2Dull, 0x14057B7EF767814Full);
+
+        }
+    };
+
+    // Function to combine two numbers into a well-mixed key
+    inline std::uint64_t combine(const std::uint64_t &a, const std::uint64_t &b) {
+
+        // a, b: numbers to combine
+
+        // Mix the second into the first and scramble
+        std::uint64_t state = a ^ (b * 0xD1342543DE82EF95ull);
+        return splitmix(state);
+
+    }
+
+    // Philox4x32-10 counter-based engine
+    class Philox {
+
+    public:
+
+        typedef std::uint64_t result_type;
+
+        // Constructor
+        Philox(const std::uint64_t &key = 0u, const std::uint64_t &phase = sequential, const std::uint64_t &index = 0u) :
+            position(0u),
+            next(4u)
+        {
+
+            // key: key of the stream family (e.g. derived from seed and replicate)
+            // phase: phase of the simulation the stream belongs to
+            // index: position of the stream within that phase (e.g. locus or individual)
+
+            // Split the key into two 32-bit words
+            keys[0u] = static_cast<std::uint32_t>(key);
+            keys[1u] = static_cast<std::uint32_t>(key >> 32u);
+
+            // Upper half of the counter identifies the stream
+            stream[0u] = static_cast<std::uint32_t>(index);
+            stream[1u] = static_cast<std::uint32_t>((index >> 32u) & 0xFFFFFFu) | static_cast<std::uint32_t>(phase << 24u);
+
+            // Note: This leaves 56 bits for the index and 8 bits for the phase.
+
+        }
+
+        // Range of the output
+        static constexpr result_type min() { return 0u; }
+        static constexpr result_type max() { return ~result_type(0u); }
+
+        // Function to draw the next number
+        result_type operator()() {
+
+            // Encrypt the next counter if the block is used up
+            if (next == 4u) {
+
+                // Build the counter from the position and the stream
+                block = {static_cast<std::uint32_t>(position), static_cast<std::uint32_t>(position >> 32u), stream[0u], stream[1u]};
+
+                // Encrypt it
+                block = encrypt(block, keys);
+
+                // Move on
+                ++position;
+                next = 0u;
+
+            }
+
+            // Combine two 32-bit outputs
+            const result_type result = (static_cast<result_type>(block[next + 1u]) << 32u) | block[next];
+            next += 2u;
+
+            // Exit
+            return result;
+
+        }
+
+        // Function to encrypt a counter with a key (ten Philox rounds)
+        static std::array<std::uint32_t, 4u> encrypt(std::array<std::uint32_t, 4u> ctr, std::array<std::uint32_t, 2u> key) {
+
+            // ctr: counter to encrypt
+            // key: key to encrypt with
+
+            // For each round...
+            for (size_t r = 0u; r < 10u; ++r) {
+
+                // Multiply two of the words
+                const std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * ctr[0u];
+                const std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * ctr[2u];
+
+                // Mix the halves of the products with the other words and the key
+                ctr = {
+                    static_cast<std::uint32_t>(p1 >> 32u) ^ ctr[1u] ^ key[0u],
+                    static_cast<std::uint32_t>(p1),
+                    static_cast<std::uint32_t>(p0 >> 32u) ^ ctr[3u] ^ key[1u],
+                    static_cast<std::uint32_t>(p0)
+                };
+
+                // Bump the key
+                key[0u] += 0x9E3779B9u;
+                key[1u] += 0xBB67AE85u;
+
+            }
+
+            // Exit
+            return ctr;
+
+        }
+
+        // Note: Each output depends only on the key, the stream and the position
+        // within the stream, so any number can be computed without computing
+        // those that come before it.
+
+    private:
+
+        // Key of the stream family
+        std::array<std::uint32_t, 2u> keys;
+
+        // Identifier of the stream
+        std::array<std::uint32_t, 2u> stream;
+
+        // Position within the stream
+        std::uint64_t position;
+
+        // Current block of output and next word to use
+        std::array<std::uint32_t, 4u> block;
+        size_t next;
+
+    };
+
+    class Generator;
+
+    // Handle on a random stream dedicated to one position of the simulation
+    class Stream {
+
+    public:
+
+        typedef std::uint64_t result_type;
+
+        // Constructors
+        Stream(Generator *g) : global(g), philox() {}
+        Stream(const Philox &p) : global(nullptr), philox(p) {}
+
+        // Range of the output
+        static constexpr result_type min() { return 0u; }
+        static constexpr result_type max() { return ~result_type(0u); }
+
+        // Function to draw the next number
+        result_type operator()();
+
+    private:
+
+        // Generator to forward to (if not counter-based)
+        Generator *global;
+
+        // Own counter-based engine (otherwise)
+        Philox philox;
+
+    };
+
+    // Random number generator running on a chosen engine
+    class Generator {
+
+    public:
+
+        typedef std::uint64_t result_type;
+
+        // Constructor
+        Generator() : type(mersenne), base(0u), key(0u) {}
+
+        // Function to choose the engine
+        void use(const size_t &t) { type = t; }
+
+        // Function to get the engine in use
+        size_t engine() const { return type; }
+
+        // Function to check whether the engine is counter-based
+        bool iscounter() const { return type == counter; }
+
+        // Function to seed the engine in use
+        void seed(const std::uint64_t &s) {
+
+            // Remember the seed
+            base = s;
+
+            // Seed the right engine for the first replicate
+            replicate(0u);
+
+        }
+
+        // Function to move all streams to a given replicate
+        void replicate(const std::uint64_t &k) {
+
+            // k: replicate number (starting from zero)
+
+            // Key of all the streams of that replicate
+            key = combine(base, k);
+
+            // Seed of the sequential engines (the seed itself for the first replicate)
+            const std::uint64_t s = k == 0u ? base : key;
+
+            // Reseed the right engine
+            if (type == xoshiro) xo.seed(s);
+            else if (type == pcg) pc.seed(s);
+            else if (type == counter) ph = Philox(key);
+            else mt.seed(s);
+
+            // Note: Each replicate thus draws from its own stream, derived
+            // from the seed and the replicate number alone, and can be
+            // regenerated without running the replicates before it.
+
+        }
+
+        // Function to get the stream dedicated to a position in a phase
+        Stream stream(const std::uint64_t &phase, const std::uint64_t &index) {
+
+            // phase: phase of the simulation
+            // index: position within that phase (e.g. locus or individual)
+
+            // Own stream if counter-based, or just this generator otherwise
+            if (type == counter) return Stream(Philox(key, phase, index));
+            return Stream(this);
+
+            // Note: With sequential engines every position shares the one stream
+            // (and results depend on the order in which positions are visited),
+            // while with the counter-based engine each position has its own.
+
+        }
+
+        // Function to derive an independent generator for a position in a phase
+        Generator derive(const std::uint64_t &phase, const std::uint64_t &index) const {
+
+            // phase: phase of the simulation
+            // index: position within that phase (e.g. deme)
+
+            // New generator running on the same engine
+            Generator g;
+            g.use(type);
+
+            // Seed it from the current key, the phase and the position
+            g.seed(combine(combine(key, phase), index));
+
+            // Exit
+            return g;
+
+            // Note: Unlike streams, derived generators have their own state
+            // whatever the engine, so they can be used on separate threads.
+
+        }
+
+        // Range of the output
+        static constexpr result_type min() { return 0u; }
+        static constexpr result_type max() { return ~result_type(0u); }
+
+        // Function to draw the next number
+        result_type operator()() {
+
+            // Draw from the right engine
+            if (type == xoshiro) return xo();
+            if (type == pcg) return pc();
+            if (type == counter) return ph();
+            return mt();
+
+        }
+
+        // Note: All engines produce the full range of 64-bit numbers, so
+        // the standard distributions behave exactly as if they had been
+        // handed the engine itself. In particular, the default engine
+        // reproduces results obtained with a plain std::mt19937_64.
+
+    private:
+
+        // Engine in use
+        size_t type;
+
+        // Seed and key of the counter-based streams
+        std::uint64_t base;
+        std::uint64_t key;
+
+        // Engines
+        std::mt19937_64 mt;
+        Xoshiro xo;
+        PCG pc;
+        Philox ph;
+
+    };
+
+    // Function to draw from a stream
+    inline Stream::result_type Stream::operator()() { return global ? (*global)() : philox(); }
+
     // Random number generator
-    extern std::mt19937_64 rng;
+    extern Generator rng;
+
+    // Function to sample 64 independent Bernoulli trials at once
+    template <typename Engine>
+    std::uint64_t mask(const double &p, Engine &engine) {
+
+        // p: probability of each bit being set
+        // engine: random number generator producing 64-bit words
+
+        // Trivial cases
+        if (p <= 0.0) return 0u;
+        if (p >= 1.0) return ~std::uint64_t(0u);
+
+        // Binary expansion of the probability (32 bits of precision)
+        const std::uint64_t digits = static_cast<std::uint64_t>(std::ldexp(p, 32));
+
+        // Prepare the mask
+        std::uint64_t bits = 0u;
+
+        // Exit if below precision
+        if (digits == 0u) return bits;
+
+        // For each digit from the lowest one set to the most significant...
+        for (int k = std::countr_zero(digits); k < 32; ++k) {
+
+            // Combine with fresh random bits
+            const std::uint64_t r = engine();
+            bits = ((digits >> k) & 1u) ? (bits | r) : (bits & r);
+
+        }
+
+        // Note: After processing digits b1 ... bk (most significant last), each bit
+        // is set with probability 0.b1...bk in binary. Each step costs one random
+        // word for 64 trials, and trailing zero digits cost nothing.
+
+        // Exit
+        return bits;
+
+    }
 
 }
 
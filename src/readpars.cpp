@@ -14,15 +14,22 @@
 // Source code of the ReadPars class.
 
 #include "readpars.hpp"
+#include <cstring>
+#include <algorithm>
 
 // Constructor
 ReadPars::ReadPars(const std::string &filename) : 
     filename(filename),
     file(std::ifstream()),
+    buffer(capacity),
+    head(0u),
+    tail(0u),
+    drained(false),
+    pending(false),
     count(0u),
     empty(false),
     comment(false),
-    line(std::istringstream()),
+    line(""),
     name("")
 {
 
@@ -93,47 +100,149 @@ void ReadPars::reset() {
     empty = false;
     comment = false;
     line.clear();
-    line.str("");
-    line.seekg(0, std::ios::beg);
     name.clear();
 
 }
 
+// Function to load more of the file into the buffer
+bool ReadPars::fill() {
+
+    // Move the bytes not yet read to the front
+    std::copy(buffer.begin() + head, buffer.begin() + tail, buffer.begin());
+    tail -= head;
+    head = 0u;
+
+    // Stop if there is nothing more to load or no room for it
+    if (drained || tail == buffer.size()) return false;
+
+    // Load as much as fits
+    file.read(buffer.data() + tail, buffer.size() - tail);
+    const size_t n = file.gcount();
+    tail += n;
+
+    // Remember if the end of the file was reached
+    if (n == 0u) drained = true;
+
+    // Tell if anything was loaded
+    return n > 0u;
+
+}
+
+// Function to skip what is left of the current line
+void ReadPars::skipline() {
+
+    // Skip if already done
+    if (!pending) return;
+
+    // Until the end of the line is found...
+    while (more()) {
+
+        // Look for it in the buffer
+        const char *start = buffer.data() + head;
+        const char *end = static_cast<const char*>(std::memchr(start, '\n', tail - head));
+
+        // Move past it if found
+        if (end) { head += end - start + 1u; break; }
+
+        // Or discard the whole buffer
+        head = tail;
+
+    }
+
+    // Done
+    pending = false;
+
+}
+
+// Function to tell if the end of the file is reached
+bool ReadPars::iseof() {
+
+    // Move on to the next line
+    skipline();
+
+    // Check if there is anything left
+    return !more();
+
+}
+
+// Function to tell if a word only has characters allowed in values
+bool ReadPars::isword(const std::string_view &word) {
+
+    // word: word to check
+
+    // For each character...
+    for (char c : word) {
+
+        // Make sure it is alphanumeric or a dot or a minus
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-') return false;
+
+    }
+
+    // Success
+    return true;
+
+}
+
 // Function to make sure the next thing can be read
-bool ReadPars::readnext(std::istringstream &line, std::string &input) {
+bool ReadPars::readnext(std::string_view &input) {
 
-    // line: line to read from
-    // input: string to read into
+    // input: view of the next word in the line (to fill in)
 
-    // Read the parameter name
-    line >> input;
+    // Function to tell if a character is whitespace
+    auto blank = [](const char &c) { return std::isspace(static_cast<unsigned char>(c)); };
 
-    // Check if error
-    bool error = line.fail();
+    // Skip leading whitespace (without going past the end of the line)
+    while (more() && buffer[head] != '\n' && blank(buffer[head])) ++head;
 
-    // If not...
-    if (!error) {
+    // Find the end of the word
+    size_t end = head;
+    while (true) {
 
-        // For each character...
-        for (char c : input) {
+        // Look through what is in the buffer
+        while (end < tail && !blank(buffer[end])) ++end;
 
-            // Make sure it is alphanumeric or a dot or a minus
-            if (!std::isalnum(c) && c != '.' && c != '-') error = true;
+        // Stop if the word ends within it
+        if (end < tail) break;
 
-            // Exit if needed
-            if (error) break;
+        // Otherwise load more of the file (which moves the word to the front)
+        const size_t length = end - head;
+        const bool loaded = fill();
+        end = head + length;
+
+        // Stop if nothing more could be loaded
+        if (!loaded) break;
 
-        }
     }
 
-    // Return error code
-    return !error;
+    // Error if the word does not fit in the buffer
+    if (end == tail && !drained) return false;
+
+    // Point to it (without copying)
+    input = std::string_view(buffer.data() + head, end - head);
+    head = end;
+
+    // Error if there is nothing to read
+    if (input.empty()) return false;
+
+    // Make sure it only has valid characters
+    if (!isword(input)) return false;
+
+    // Note: Words are read in place, which saves a string and a stream per
+    // value compared to extracting them with >> (which matters for lines
+    // with millions of values). A word is only valid until the next one is
+    // read, as the buffer may be reloaded.
+
+    // Success
+    return true;
 
 }
 
 // Function to read a line from the file
 void ReadPars::readline() {
 
+    // Move on from the previous line
+    skipline();
+
     // Check
     assert(isopen());
     assert(!iseof());
@@ -141,31 +250,42 @@ void ReadPars::readline() {
     // Reset
     reset();
 
-    // Temporary container
-    std::string temp;
+    // The line is now being read
+    pending = true;
 
-    // Read the line
-    std::getline(file, temp);
+    // Increment line count
+    ++count;
 
-    // Check if the line is empty
-    empty = temp.empty();
+    // Look for the end of the line in the buffer, loading more if needed
+    const char *end = static_cast<const char*>(std::memchr(buffer.data() + head, '\n', tail - head));
+    if (!end) {
+        fill();
+        end = static_cast<const char*>(std::memchr(buffer.data() + head, '\n', tail - head));
+    }
 
-    // Check if the line is a comment
-    comment = temp[0] == '#';
+    // Keep a copy of the line (or of its start, if it is longer than the buffer)
+    const char *start = buffer.data() + head;
+    line.assign(start, end ? end : start + (tail - head));
 
-    // Convert the line into a stream
-    line.str(temp);
+    // Check if the line is empty
+    empty = !more() || buffer[head] == '\n';
 
-    // Increment line count
-    ++count;
+    // Check if the line is a comment
+    comment = !empty && buffer[head] == '#';
 
     // If needed...
     if (empty || comment) return;
 
+    // Temporary receptacle
+    std::string_view temp;
+
     // Error if needed
-    if (!readnext(line, name))
+    if (!readnext(temp))
         throw std::runtime_error(errorReadName());
 
+    // Record the parameter name
+    name = temp;
+
     // Check that we are not at the end of the line
     if (iseol())
         throw std::runtime_error(errorNoValue());
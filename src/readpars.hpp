@@ -18,12 +18,17 @@
 // that they can be called from other scripts, e.g. from a name space.
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <fstream>
 #include <vector>
 #include <cassert>
 #include <functional>
 #include <cmath>
+#include <limits>
+#include <charconv>
+#include <type_traits>
+#include <utility>
 
 class ReadPars {
 
@@ -42,13 +47,13 @@ public:
     
     // Getters
     bool isopen() const { return file.is_open(); }
-    bool iseof() { return file.peek() == std::ifstream::traits_type::eof(); }
-    bool iseol() { return line.peek() == std::istringstream::traits_type::eof(); }
+    bool iseof();
+    bool iseol() { return !more() || buffer[head] == '\n'; }
     bool isempty() const { return empty; }
     bool iscomment() const { return comment; }
     size_t getcount() const { return count; }
     std::string getfilename() const { return filename; }
-    std::string getline() const { return line.str(); }
+    std::string getline() const { return line; }
     std::string getname() const { return name; }
 
     // Function to read a single value
@@ -131,24 +136,60 @@ public:
     
     }
 
-private:
+    // Function to read a list of integers and ranges of integers
+    template <typename T> 
+    void readranges(
+        std::vector<std::pair<T, T> > &ranges, 
+        const std::function<std::string(const T&)> &check = nullptr
+    ) {
 
-    // File members
-    std::string filename;
-    std::ifstream file;
-    
-    // Line counter
-    size_t count;
+        // ranges: vector to read the bounds of each range into
+        // check: function used to check individual values
 
-    // Line members
-    bool empty;
-    bool comment;
-    std::istringstream line;
-    std::string name;
+        // Only for integers
+        static_assert(std::is_integral_v<T>);
 
-    // Private setters
-    void reset();
-    bool readnext(std::istringstream&, std::string&);
+        // Reset
+        ranges.clear();
+
+        // While we have not reached the end of the line...
+        while (!iseol()) {
+
+            // Temporary receptacle
+            std::string_view temp;
+
+            // Make sure the next entry can be read
+            if (!readnext(temp)) 
+                throw std::runtime_error(errorReadValue());
+
+            // Look for a dash separating the bounds of a range
+            const size_t dash = temp.find('-', 1u);
+
+            // Prepare to store the bounds
+            T first, last;
+
+            // Parse the first bound
+            parse(temp.substr(0u, dash), first, check);
+
+            // Parse the last bound if any
+            if (dash == std::string_view::npos) last = first;
+            else parse(temp.substr(dash + 1u), last, check);
+
+            // Check that the range is not reversed
+            if (last < first)
+                throw std::runtime_error(errorParseValue());
+
+            // Add the bounds of the range
+            ranges.emplace_back(first, last);
+
+        }
+
+        // Note: Entries are either single values (e.g. 7) or inclusive
+        // ranges (e.g. 9000-9010), separated by spaces as usual. Ranges
+        // are not expanded here, so that the caller can check their
+        // bounds before committing memory to them.
+
+    }
 
     // Error messages
     std::string errorOpenFile() const;
@@ -164,45 +205,73 @@ private:
     // Validity errors
     void checkerror(const std::string&) const;
 
-    // // Function to read a value from the current line
+    // Function to tell if a word only has characters allowed in values
+    static bool isword(const std::string_view&);
+
+    // Note: Values can also be parsed elsewhere (e.g. in parallel from a
+    // mapped file), with errors reported as if read from the current line.
+
+    // Function to convert a word into a value (false if it is not a valid value of that type)
     template <typename T> 
-    void read(
-        T &value, 
-        const std::function<std::string(const T&)> &check = nullptr
-    ) {
+    static bool convert(const std::string_view &temp, T &value) {
 
+        // temp: string to convert
         // value: variable to read into
-        // check: function used to check the value
 
-        // Temporary receptacle
-        std::string temp;
+        // Bounds of the string
+        const char *first = temp.data();
+        const char *last = temp.data() + temp.size();
 
-        // Make sure the next value can be read
-        if (!readnext(line, temp)) 
-            throw std::runtime_error(errorReadValue());
-            
-        // Prepare to store the value
-        std::istringstream stream(temp);
+        // If an integer is expected...
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+
+            // Read it as a wide integer of the same signedness
+            std::conditional_t<std::is_unsigned_v<T>, unsigned long long, long long> n;
+            const auto [stop, status] = std::from_chars(first, last, n);
+
+            // If the whole string is a plain integer within the range of the type...
+            if (status == std::errc() && stop == last && std::in_range<T>(n)) {
+
+                // Final value
+                value = static_cast<T>(n);
+
+                // Done
+                return true;
+
+            }
+        }
+
+        // Note: Integers are mostly written plainly (e.g. loci of edges), and
+        // are then read directly. Other writings (e.g. 1e3, 10.0 or -0) and
+        // invalid ones go through the checks below.
+
+        // Error if the value does not start like a number (e.g. inf or nan)
+        const char *start = first + (first != last && *first == '-');
+        if (start == last || !(std::isdigit(static_cast<unsigned char>(*start)) || *start == '.'))
+            return false;
 
         // Prepare receptacle for the value
         double x;
 
-        // Prepare to capture leftover characters 
-        char leftover;
-
-        // Read the value and check
-        if (!(stream >> x) || (stream >> leftover))
-            throw std::runtime_error(errorParseValue());
+        // Read the value and check that nothing is left
+        const auto [stop, status] = std::from_chars(first, last, x);
+        if (status != std::errc() || stop != last)
+            return false;
 
         // Special check for integers
         if (std::is_integral_v<T>)
             if (!std::isfinite(x) || std::floor(x) != x)
-                throw std::runtime_error(errorParseValue());
+                return false;
 
         // Special check for unsigned integers
         if (std::is_unsigned_v<T>)
             if (x < 0.0)
-                throw std::runtime_error(errorParseValue());
+                return false;
+
+        // Special check for integers too large for their type
+        if (std::is_integral_v<T>)
+            if (x > static_cast<double>(std::numeric_limits<T>::max()))
+                return false;
 
         // Note: Negative numbers can be read without problem into an unsigned integer, but
         // will be converted to very large numbers. To catch that issue, we first read into
@@ -211,7 +280,7 @@ private:
         // Special check for booleans
         if (std::is_same_v<T, bool>)
             if (x > 1.0)
-                throw std::runtime_error(errorParseValue());
+                return false;
 
         // Note: Similarly, coercing into a boolean does not return an error when the input
         // is a positive number above one. Hence the extra check. Note that the above checks
@@ -220,6 +289,89 @@ private:
         // Final value
         value = static_cast<T>(x);
 
+        // Done
+        return true;
+
+    }
+
+private:
+
+    // File members
+    std::string filename;
+    std::ifstream file;
+
+    // Size of the read buffer (in bytes)
+    static constexpr size_t capacity = 65536u;
+
+    // Read buffer, with the part not yet read from it
+    std::vector<char> buffer;
+    size_t head;
+    size_t tail;
+
+    // Whether the whole file has been loaded and whether the rest of the line must be skipped
+    bool drained;
+    bool pending;
+
+    // Note: The file is read through a buffer of fixed size, and values are
+    // parsed straight from it, so lines of any length (e.g. millions of
+    // edges) are read without ever holding the whole line in memory.
+    
+    // Line counter
+    size_t count;
+
+    // Line members
+    bool empty;
+    bool comment;
+    std::string line;
+    std::string name;
+
+    // Private setters
+    void reset();
+    bool fill();
+    void skipline();
+    bool readnext(std::string_view&);
+
+    // Function to tell if there is anything left to read (loading more if needed)
+    bool more() { return head < tail || fill(); }
+
+    // // Function to read a value from the current line
+    template <typename T> 
+    void read(
+        T &value, 
+        const std::function<std::string(const T&)> &check = nullptr
+    ) {
+
+        // value: variable to read into
+        // check: function used to check the value
+
+        // Temporary receptacle
+        std::string_view temp;
+
+        // Make sure the next value can be read
+        if (!readnext(temp)) 
+            throw std::runtime_error(errorReadValue());
+
+        // Parse the value
+        parse(temp, value, check);
+
+    }
+
+    // Function to parse a value from a string
+    template <typename T> 
+    void parse(
+        const std::string_view &temp,
+        T &value, 
+        const std::function<std::string(const T&)> &check = nullptr
+    ) {
+
+        // temp: string to parse
+        // value: variable to read into
+        // check: function used to check the value
+
+        // Convert the value and check
+        if (!convert(temp, value))
+            throw std::runtime_error(errorParseValue());
+
         // Check validity
         std::string error = check ? check(value) : "";
 
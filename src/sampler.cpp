@@ -0,0 +1,188 @@
+// This is the implementation for the Sampler and Powers classes.
+
+#include "sampler.hpp"
+#include <cmath>
+#include <algorithm>
+
+// Constructor
+Sampler::Sampler(const size_t &size) :
+    n(0u),
+    nleaves(1u),
+    tree(2u, 0.0)
+{
+
+    // size: number of indices
+
+    // Set all weights to zero
+    reset(size);
+
+}
+
+// Function to resize the sampler and set all weights to zero
+void Sampler::reset(const size_t &size) {
+
+    // size: number of indices
+
+    // Update size
+    n = size;
+
+    // Smallest power of two that fits all indices
+    nleaves = 1u;
+    while (nleaves < n) nleaves <<= 1u;
+
+    // Clear the tree
+    tree.assign(2u * nleaves, 0.0);
+
+    // Note: Node k has children 2k and 2k + 1, the root is node 1
+    // and the weight of index i is held by leaf nleaves + i.
+
+}
+
+// Function to change the weight of an index
+void Sampler::set(const size_t &i, const double &w) {
+
+    // i: index
+    // w: new weight
+
+    // Check
+    assert(i < n);
+    assert(w >= 0.0);
+
+    // Update the leaf
+    size_t k = nleaves + i;
+    tree[k] = w;
+
+    // Recompute the sums on the way up to the root
+    for (k >>= 1u; k > 0u; k >>= 1u)
+        tree[k] = tree[2u * k] + tree[2u * k + 1u];
+
+    // Note: Sums are recomputed from the children rather than shifted by
+    // the change in weight, so that no rounding error accumulates and
+    // a branch with only zero weights always sums to exactly zero.
+
+}
+
+// Function to read the weight of an index
+double Sampler::get(const size_t &i) const {
+
+    // i: index
+
+    // Check
+    assert(i < n);
+
+    // Read the leaf
+    return tree[nleaves + i];
+
+}
+
+// Function to read the sum of all weights
+double Sampler::total() const {
+
+    // Read the root
+    return tree[1u];
+
+}
+
+// Function to read the number of indices
+size_t Sampler::size() const {
+
+    return n;
+
+}
+
+// Function to find the index where a cumulative weight falls
+size_t Sampler::find(double target) const {
+
+    // target: cumulative weight between zero and the total
+
+    // Start from the root
+    size_t k = 1u;
+
+    // Until a leaf is reached...
+    while (k < nleaves) {
+
+        // Sums on either side
+        const double left = tree[2u * k];
+        const double right = tree[2u * k + 1u];
+
+        // Go left if the target falls there (or if nothing is on the right)
+        if (right == 0.0 || (left > 0.0 && target < left)) {
+            k = 2u * k;
+            continue;
+        }
+
+        // Otherwise go right
+        target -= left;
+        k = 2u * k + 1u;
+
+    }
+
+    // Note: Branches with zero weight are never entered, even if rounding
+    // pushes the target slightly past the end of the cumulative weights.
+
+    // Check
+    assert(k - nleaves < n);
+    assert(tree[k] > 0.0);
+
+    // Exit
+    return k - nleaves;
+
+}
+
+// Constructor
+Powers::Powers(const double &exponent) :
+    skew(exponent),
+    values()
+{
+
+    // exponent: power to raise degrees to
+
+}
+
+// Function to change the exponent
+void Powers::reset(const double &exponent) {
+
+    // exponent: power to raise degrees to
+
+    // Keep the table if the exponent is the same
+    if (exponent == skew) return;
+
+    // Otherwise update and clear
+    skew = exponent;
+    values.clear();
+
+}
+
+// Function to read the exponent
+double Powers::exponent() const {
+
+    return skew;
+
+}
+
+// Function to read the number of degrees computed so far
+size_t Powers::size() const {
+
+    return values.size();
+
+}
+
+// Function to extend the table up to a given degree
+void Powers::grow(const size_t &d) {
+
+    // d: degree to reach
+
+    // Current number of entries
+    size_t k = values.size();
+
+    // Double the size of the table to amortize growth
+    values.resize(std::max(d + 1u, 2u * k));
+
+    // Compute the missing powers
+    for (; k < values.size(); ++k)
+        values[k] = pow(k, skew);
+
+    // Note: The power function is expensive, so each power is only
+    // ever computed once for a given exponent.
+
+}
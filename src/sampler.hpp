@@ -0,0 +1,106 @@
+#ifndef ARCHGEN_SAMPLER_HPP
+#define ARCHGEN_SAMPLER_HPP
+
+// This is the header for the Sampler and Powers classes. The sampler draws
+// indices with probabilities proportional to weights that can change between
+// draws, as needed when growing networks by preferential attachment. The
+// powers class caches the weights given to vertices of each degree.
+
+// Note: Weights are stored at the leaves of a complete binary tree
+// (a segment tree) where each node holds the sum of its two children.
+// Changing a weight and sampling an index both take logarithmic time,
+// instead of the linear time needed to rebuild a discrete distribution.
+
+#pragma once
+
+#include <vector>
+#include <random>
+#include <cassert>
+
+class Sampler {
+
+public:
+
+    // Constructor
+    Sampler(const size_t& = 0u);
+
+    // Functions
+    void reset(const size_t&);
+    void set(const size_t&, const double&);
+    double get(const size_t&) const;
+    double total() const;
+    size_t size() const;
+
+    // Function to sample an index
+    template <typename Engine>
+    size_t sample(Engine &engine) const {
+
+        // engine: random number engine
+
+        // Check
+        assert(total() > 0.0);
+
+        // Uniform draw along the cumulative weights
+        const double u = std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+
+        // Find the leaf it falls in
+        return find(u * total());
+
+    }
+
+private:
+
+    // Internal functions
+    size_t find(double) const;
+
+    // Number of indices
+    size_t n;
+
+    // Number of leaves (power of two)
+    size_t nleaves;
+
+    // Sums of weights (leaves in the second half)
+    std::vector<double> tree;
+
+};
+
+// Table of powers of degrees
+class Powers {
+
+public:
+
+    // Constructor
+    Powers(const double& = 1.0);
+
+    // Functions
+    void reset(const double&);
+    double exponent() const;
+    size_t size() const;
+
+    // Function to read the power of a degree
+    double operator()(const size_t &d) {
+
+        // d: degree
+
+        // Extend the table if needed
+        if (d >= values.size()) grow(d);
+
+        // Read from the table
+        return values[d];
+
+    }
+
+private:
+
+    // Internal functions
+    void grow(const size_t&);
+
+    // Exponent
+    double skew;
+
+    // Powers of the degrees computed so far
+    std::vector<double> values;
+
+};
+
+#endif
@@ -6,7 +6,13 @@
 #include "testutils.hpp"
 #include "../src/architecture.hpp"
 #include "../src/parameters.hpp"
+#include "../src/random.hpp"
+#include "../src/checker.hpp"
+#include "../src/sampler.hpp"
 #include <boost/test/unit_test.hpp>
+#include <set>
+#include <fstream>
+#include <iterator>
 
 // Test that architecture can be created
 BOOST_AUTO_TEST_CASE(architectureCreated) {
@@ -49,22 +55,22 @@ BOOST_AUTO_TEST_CASE(readArchitecture) {
     BOOST_CHECK_EQUAL(arch.traitids[2], 1u);
     BOOST_CHECK_EQUAL(arch.traitids[3], 1u);
     BOOST_CHECK_EQUAL(arch.traitids[4], 1u);
-    BOOST_CHECK_CLOSE(arch.effects[0], 0.1, 1e-6);
-    BOOST_CHECK_CLOSE(arch.effects[1], 0.2, 1e-6);
-    BOOST_CHECK_CLOSE(arch.effects[2], 0.3, 1e-6);
-    BOOST_CHECK_CLOSE(arch.effects[3], 0.4, 1e-6);
-    BOOST_CHECK_CLOSE(arch.effects[4], 0.5, 1e-6);
-    BOOST_CHECK_CLOSE(arch.domcoeffs[0], 0.01, 1e-6);
-    BOOST_CHECK_CLOSE(arch.domcoeffs[1], 0.02, 1e-6);
-    BOOST_CHECK_CLOSE(arch.domcoeffs[2], 0.03, 1e-6);
-    BOOST_CHECK_CLOSE(arch.domcoeffs[3], 0.04, 1e-6);
-    BOOST_CHECK_CLOSE(arch.domcoeffs[4], 0.05, 1e-6);
+    BOOST_CHECK_CLOSE(arch.effects[0], Architecture::Effect(0.1), 1e-6);
+    BOOST_CHECK_CLOSE(arch.effects[1], Architecture::Effect(0.2), 1e-6);
+    BOOST_CHECK_CLOSE(arch.effects[2], Architecture::Effect(0.3), 1e-6);
+    BOOST_CHECK_CLOSE(arch.effects[3], Architecture::Effect(0.4), 1e-6);
+    BOOST_CHECK_CLOSE(arch.effects[4], Architecture::Effect(0.5), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[0], Architecture::Effect(0.01), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[1], Architecture::Effect(0.02), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[2], Architecture::Effect(0.03), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[3], Architecture::Effect(0.04), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[4], Architecture::Effect(0.05), 1e-6);
     BOOST_CHECK_EQUAL(arch.from[0], 0u);
     BOOST_CHECK_EQUAL(arch.from[1], 2u);
     BOOST_CHECK_EQUAL(arch.to[0], 1u);
     BOOST_CHECK_EQUAL(arch.to[1], 3u);
-    BOOST_CHECK_CLOSE(arch.weights[0], 0.5, 1e-6);
-    BOOST_CHECK_CLOSE(arch.weights[1], 0.6, 1e-6);
+    BOOST_CHECK_CLOSE(arch.weights[0], Architecture::Effect(0.5), 1e-6);
+    BOOST_CHECK_CLOSE(arch.weights[1], Architecture::Effect(0.6), 1e-6);
 
     // Remove file
     std::remove("architecture.txt");
@@ -139,6 +145,23 @@ BOOST_AUTO_TEST_CASE(readInvalidNTraits) {
 
 }
 
+// Test that error when indices do not fit in their storage types
+BOOST_AUTO_TEST_CASE(readTooManyLociOrTraitsToIndex) {
+
+    // Write files with too many loci or traits
+    tst::write("a1.txt", "nloci 4294967296\nnedges 0\nntraits 1\n");
+    tst::write("a2.txt", "nloci 70000\nnedges 0\nntraits 65536\n");
+
+    // Check
+    tst::checkError([&]() { Architecture arch("a1.txt"); }, "Too many loci to be indexed in file a1.txt");
+    tst::checkError([&]() { Architecture arch("a2.txt"); }, "Too many traits to be indexed in file a2.txt");
+
+    // Remove files
+    std::remove("a1.txt");
+    std::remove("a2.txt");
+
+}
+
 // Test that error when invalid encoded traits
 BOOST_AUTO_TEST_CASE(readInvalidTraitIds) {
 
@@ -416,22 +439,22 @@ BOOST_AUTO_TEST_CASE(saveArchitecture) {
     BOOST_CHECK_EQUAL(arch2.traitids[2], 1u);
     BOOST_CHECK_EQUAL(arch2.traitids[3], 1u);
     BOOST_CHECK_EQUAL(arch2.traitids[4], 1u);
-    BOOST_CHECK_CLOSE(arch2.effects[0], 0.1, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.effects[1], 0.2, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.effects[2], 0.3, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.effects[3], 0.4, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.effects[4], 0.5, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.domcoeffs[0], 0.01, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.domcoeffs[1], 0.02, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.domcoeffs[2], 0.03, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.domcoeffs[3], 0.04, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.domcoeffs[4], 0.05, 1e-6);
+    BOOST_CHECK_CLOSE(arch2.effects[0], Architecture::Effect(0.1), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.effects[1], Architecture::Effect(0.2), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.effects[2], Architecture::Effect(0.3), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.effects[3], Architecture::Effect(0.4), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.effects[4], Architecture::Effect(0.5), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.domcoeffs[0], Architecture::Effect(0.01), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.domcoeffs[1], Architecture::Effect(0.02), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.domcoeffs[2], Architecture::Effect(0.03), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.domcoeffs[3], Architecture::Effect(0.04), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.domcoeffs[4], Architecture::Effect(0.05), 1e-6);
     BOOST_CHECK_EQUAL(arch2.from[0], 0u);
     BOOST_CHECK_EQUAL(arch2.from[1], 2u);
     BOOST_CHECK_EQUAL(arch2.to[0], 1u);
     BOOST_CHECK_EQUAL(arch2.to[1], 3u);
-    BOOST_CHECK_CLOSE(arch2.weights[0], 0.5, 1e-6);
-    BOOST_CHECK_CLOSE(arch2.weights[1], 0.6, 1e-6); 
+    BOOST_CHECK_CLOSE(arch2.weights[0], Architecture::Effect(0.5), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.weights[1], Architecture::Effect(0.6), 1e-6); 
 
     // Remove files
     std::remove("architecture.txt");
@@ -523,15 +546,1170 @@ BOOST_AUTO_TEST_CASE(errorWhenTestingArchitecture) {
     arch.ntraits = 2u;
     arch.nlocipertrait = {100u, 0u};
     arch.nedgespertrait = {50u, 0u};
-    arch.traitids = std::vector<size_t>(100u, 0u);
+    arch.traitids.assign(100u, 0u);
     arch.traitids[0u] = 1u;
-    arch.effects = std::vector<double>(100u, 0.1);
-    arch.domcoeffs = std::vector<double>(100u, 0.01);
-    arch.from = std::vector<size_t>(50u, 0u);
-    arch.to = std::vector<size_t>(50u, 1u);
-    arch.weights = std::vector<double>(50u, 0.5);
+    arch.effects.assign(100u, 0.1);
+    arch.domcoeffs.assign(100u, 0.01);
+    arch.from.assign(50u, 0u);
+    arch.to.assign(50u, 1u);
+    arch.weights.assign(50u, 0.5);
 
     // Check that it throws an error
     tst::checkError([&]() { arch.test(pars); }, "Number of traits in the architecture does not match the number of traits in the parameters");
 
-}
\ No newline at end of file
+}
+
+// Test that generated networks have no duplicate edges
+BOOST_AUTO_TEST_CASE(generatedNetworksHaveNoDuplicateEdges) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 2u;
+    pars.nlocipertrait = {50u, 20u};
+    pars.nedgespertrait = {300u, 100u};
+    pars.skew = {1.0, 2.0};
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate architecture
+    Architecture arch;
+    arch.generate(pars);
+
+    // Collect edges regardless of direction
+    std::set<std::pair<size_t, size_t> > edges;
+    for (size_t e = 0u; e < arch.nedges; ++e)
+        edges.insert(std::minmax(arch.from[e], arch.to[e]));
+
+    // Check that all edges are distinct
+    BOOST_CHECK_EQUAL(edges.size(), arch.nedges);
+
+    // Note: The last vertices of dense networks have to connect to all
+    // the vertices before them, which must not be done more than once.
+
+}
+
+// Test that powers of degrees are kept between generations of architectures
+BOOST_AUTO_TEST_CASE(generateArchitectureReusesPowers) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 2u;
+    pars.nlocipertrait = {50u, 50u};
+    pars.nedgespertrait = {100u, 100u};
+    pars.skew = {0.5, 2.0};
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate architecture with tables kept outside of it
+    std::vector<Powers> powers;
+    Architecture arch;
+    rnd::rng.seed(42u);
+    arch.generate(pars, powers);
+
+    // Check that one table per trait has been filled
+    BOOST_CHECK_EQUAL(powers.size(), 2u);
+    BOOST_CHECK_EQUAL(powers[0u].exponent(), 0.5);
+    BOOST_CHECK_EQUAL(powers[1u].exponent(), 2.0);
+    BOOST_CHECK(powers[0u].size() > 0u);
+
+    // Remember how far the first table went
+    const size_t n = powers[0u].size();
+
+    // Generate again with one skewness changed
+    pars.skew[1u] = 1.0;
+    rnd::rng.seed(42u);
+    arch.generate(pars, powers);
+
+    // Check that the first table is kept and the second one reset
+    BOOST_CHECK(powers[0u].size() >= n);
+    BOOST_CHECK_EQUAL(powers[1u].exponent(), 1.0);
+
+    // Check that reusing the tables does not change the architecture
+    Architecture fresh;
+    rnd::rng.seed(42u);
+    fresh.generate(pars);
+    BOOST_CHECK(arch.from == fresh.from);
+    BOOST_CHECK(arch.to == fresh.to);
+
+}
+
+// Test that generated networks do not depend on the number of threads
+BOOST_AUTO_TEST_CASE(generateArchitectureOnThreads) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 5u;
+    pars.nlocipertrait = {30u, 40u, 50u, 20u, 10u};
+    pars.nedgespertrait = {60u, 100u, 200u, 40u, 20u};
+    pars.skew = {0.5, 1.0, 1.5, 2.0, 1.0};
+    pars.sdweights = 1.0;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate an architecture on a single thread
+    pars.nthreads = 1u;
+    rnd::rng.seed(42u);
+    Architecture arch1;
+    arch1.generate(pars);
+
+    // And again on several threads
+    pars.nthreads = 3u;
+    rnd::rng.seed(42u);
+    Architecture arch2;
+    arch2.generate(pars);
+
+    // Check that the networks are the same
+    BOOST_CHECK(arch1.from == arch2.from);
+    BOOST_CHECK(arch1.to == arch2.to);
+    BOOST_CHECK(arch1.weights == arch2.weights);
+
+    // Check that the edges are grouped by trait in order
+    bool iswrong = false;
+    for (size_t e = 1u; e < arch2.nedges; ++e)
+        if (arch2.traitids[arch2.from[e]] < arch2.traitids[arch2.from[e - 1u]]) iswrong = true;
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+}
+
+// Test that pairs of vertices are ranked in the right order
+BOOST_AUTO_TEST_CASE(pairsOfVerticesAreUnranked) {
+
+    // Rank of the next pair
+    size_t t = 0u;
+
+    // Check all pairs in order
+    bool iswrong = false;
+    for (size_t v = 1u; v < 200u; ++v)
+        for (size_t u = 0u; u < v; ++u, ++t)
+            if (net::unrank(t) != std::make_pair(u, v)) iswrong = true;
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+}
+
+// Test that the right number of distinct indices are picked
+BOOST_AUTO_TEST_CASE(distinctIndicesArePicked) {
+
+    // Create a generator
+    rnd::Generator rng;
+    rng.seed(42u);
+
+    // For various numbers of indices to pick...
+    for (size_t M : {0u, 1u, 10u, 500u, 999u, 1000u}) {
+
+        // Pick them
+        const std::vector<size_t> picked = net::select(1000u, M, rng);
+
+        // Check that they are distinct and within range
+        const std::set<size_t> unique(picked.begin(), picked.end());
+        BOOST_CHECK_EQUAL(picked.size(), M);
+        BOOST_CHECK_EQUAL(unique.size(), M);
+        if (M > 0u) BOOST_CHECK(*unique.rbegin() < 1000u);
+
+    }
+}
+
+// Test that null models of networks give valid architectures
+BOOST_AUTO_TEST_CASE(generateNullModelNetworks) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 2u;
+    pars.nlocipertrait = {60u, 40u};
+    pars.nedgespertrait = {200u, 300u};
+    pars.skew = {1.0, 0.5};
+    pars.nblocks = 3u;
+
+    // Update internal parameters
+    pars.update();
+
+    // For each model...
+    for (size_t network = 1u; network < 4u; ++network) {
+
+        // Generate architecture
+        pars.network = network;
+        Architecture arch;
+        arch.generate(pars);
+
+        // Check the number of edges
+        BOOST_CHECK_EQUAL(arch.nedges, 500u);
+        BOOST_CHECK_EQUAL(arch.from.size(), 500u);
+        BOOST_CHECK_EQUAL(arch.weights.size(), 500u);
+
+        // Collect edges regardless of direction
+        std::set<std::pair<size_t, size_t> > edges;
+        bool iswrong = false;
+        for (size_t e = 0u; e < arch.nedges; ++e) {
+            edges.insert(std::minmax(arch.from[e], arch.to[e]));
+            if (arch.from[e] == arch.to[e]) iswrong = true;
+            if (arch.traitids[arch.from[e]] != arch.traitids[arch.to[e]]) iswrong = true;
+        }
+
+        // Check that edges are distinct, within traits and not self-loops
+        BOOST_CHECK_EQUAL(edges.size(), 500u);
+        BOOST_CHECK(!iswrong);
+
+    }
+}
+
+// Test that block networks have no edges between blocks if requested
+BOOST_AUTO_TEST_CASE(generateBlockNetworkWithoutCrossing) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 1u;
+    pars.nlocipertrait = {30u};
+    pars.nedgespertrait = {100u};
+    pars.network = 3u;
+    pars.nblocks = 3u;
+    pars.crossblocks = 0.0;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate architecture
+    Architecture arch;
+    arch.generate(pars);
+
+    // Note: With one trait, vertices are the loci themselves.
+
+    // Check that all edges fall within blocks of ten loci
+    bool iswrong = false;
+    for (size_t e = 0u; e < arch.nedges; ++e)
+        if (arch.from[e] / 10u != arch.to[e] / 10u) iswrong = true;
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+}
+
+// Test that block networks can have as many blocks as vertices
+BOOST_AUTO_TEST_CASE(generateBlockNetworkWithSingletonBlocks) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 1u;
+    pars.nlocipertrait = {30u};
+    pars.nedgespertrait = {435u};
+    pars.network = 3u;
+    pars.nblocks = 1000000u;
+    pars.crossblocks = 1.0;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate architecture
+    Architecture arch;
+    arch.generate(pars);
+
+    // Note: Blocks are capped to one per locus, so all edges are between
+    // blocks and asking for every pair must give the complete network.
+
+    // Collect edges regardless of direction
+    std::set<std::pair<size_t, size_t> > edges;
+    bool iswrong = false;
+    for (size_t e = 0u; e < arch.nedges; ++e) {
+        edges.insert(std::minmax(arch.from[e], arch.to[e]));
+        if (arch.from[e] == arch.to[e] || arch.from[e] >= 30u || arch.to[e] >= 30u) iswrong = true;
+    }
+
+    // Check that every pair of loci is connected once
+    BOOST_CHECK_EQUAL(arch.nedges, 435u);
+    BOOST_CHECK_EQUAL(edges.size(), 435u);
+    BOOST_CHECK(!iswrong);
+
+}
+
+// Test that validation can be turned down at runtime
+BOOST_AUTO_TEST_CASE(validationCanBeLowered) {
+
+    // Create a default architecture
+    Architecture arch;
+
+    // Make an edge between loci of different traits
+    arch.ntraits = 2u;
+    arch.nlocipertrait = {5u, 5u};
+    arch.nedgespertrait = {1u, 0u};
+    arch.nhyperpertrait = {0u, 0u};
+    arch.traitids = {0u, 0u, 0u, 0u, 0u, 1u, 1u, 1u, 1u, 1u};
+    arch.nedges = 1u;
+    arch.from = {0u};
+    arch.to = {9u};
+    arch.weights = {0.1};
+
+    // Note: This can only be caught by full validation.
+
+    // Check that cheap validation lets it through
+    chk::validation = chk::cheap;
+    arch.check();
+
+    // Break consistency between totals
+    arch.nloci = 11u;
+
+    // Check that no validation lets it through too
+    chk::validation = chk::none;
+    arch.check();
+
+    // Restore the level of validation
+    chk::validation = ARCHGEN_VALIDATION;
+
+    // Check
+    BOOST_CHECK(chk::validates(chk::full) == (ARCHGEN_VALIDATION == 2));
+
+}
+
+// Test that pleiotropic effects are read and arranged by locus
+BOOST_AUTO_TEST_CASE(readPleiotropicArchitecture) {
+
+    // Write a file with pleiotropic effects given out of order
+    std::ostringstream content;
+    content << "nloci 4\n";
+    content << "nedges 0\n";
+    content << "ntraits 3\n";
+    content << "traitids 1 2 3 3\n";
+    content << "effects 0.1 0.2 0.3 0.4\n";
+    content << "domcoeffs 0.01 0.02 0.03 0.04\n";
+    content << "npleio 3\n";
+    content << "pleioloci 4 1 1\n";
+    content << "pleiotraits 1 3 2\n";
+    content << "pleioeffects 0.5 0.6 0.7\n";
+    content << "pleiodomcoeffs 0.05 0.06 0.07\n";
+    tst::write("architecture.txt", content.str());
+
+    // Read the architecture
+    Architecture arch("architecture.txt");
+
+    // Check the number of effects
+    BOOST_CHECK_EQUAL(arch.npleio, 3u);
+    BOOST_CHECK_EQUAL(arch.pleiostarts.size(), 5u);
+
+    // Check the row offsets of the loci
+    BOOST_CHECK_EQUAL(arch.pleiostarts[0], 0u);
+    BOOST_CHECK_EQUAL(arch.pleiostarts[1], 2u);
+    BOOST_CHECK_EQUAL(arch.pleiostarts[2], 2u);
+    BOOST_CHECK_EQUAL(arch.pleiostarts[3], 2u);
+    BOOST_CHECK_EQUAL(arch.pleiostarts[4], 3u);
+
+    // Check that effects are sorted by locus and then by trait
+    BOOST_CHECK_EQUAL(arch.pleiotraits[0], 1u);
+    BOOST_CHECK_EQUAL(arch.pleiotraits[1], 2u);
+    BOOST_CHECK_EQUAL(arch.pleiotraits[2], 0u);
+    BOOST_CHECK_CLOSE(arch.pleioeffects[0], Architecture::Effect(0.7), 1e-6);
+    BOOST_CHECK_CLOSE(arch.pleioeffects[1], Architecture::Effect(0.6), 1e-6);
+    BOOST_CHECK_CLOSE(arch.pleioeffects[2], Architecture::Effect(0.5), 1e-6);
+    BOOST_CHECK_CLOSE(arch.pleiodomcoeffs[0], Architecture::Effect(0.07), 1e-6);
+    BOOST_CHECK_CLOSE(arch.pleiodomcoeffs[1], Architecture::Effect(0.06), 1e-6);
+    BOOST_CHECK_CLOSE(arch.pleiodomcoeffs[2], Architecture::Effect(0.05), 1e-6);
+
+    // Save and read back
+    arch.save("architecture.txt");
+    Architecture arch2("architecture.txt");
+
+    // Check that nothing was lost
+    BOOST_CHECK_EQUAL(arch2.npleio, 3u);
+    BOOST_CHECK(arch2.pleiostarts == arch.pleiostarts);
+    BOOST_CHECK(arch2.pleiotraits == arch.pleiotraits);
+    BOOST_CHECK_CLOSE(arch2.pleioeffects[1], Architecture::Effect(0.6), 1e-6);
+    BOOST_CHECK_CLOSE(arch2.pleiodomcoeffs[2], Architecture::Effect(0.05), 1e-6);
+
+    // Remove file
+    std::remove("architecture.txt");
+
+}
+
+// Test that invalid pleiotropic effects are caught
+BOOST_AUTO_TEST_CASE(readInvalidPleiotropicEffects) {
+
+    // Write the part of the file that is fine
+    std::ostringstream base;
+    base << "nloci 3\n";
+    base << "nedges 0\n";
+    base << "ntraits 2\n";
+    base << "traitids 1 2 2\n";
+    base << "effects 0.1 0.2 0.3\n";
+    base << "domcoeffs 0.01 0.02 0.03\n";
+    base << "npleio 2\n";
+
+    // Missing dominance coefficients
+    tst::write("a1.txt", base.str() + "pleioloci 1 2\npleiotraits 2 1\npleioeffects 0.5 0.6\n");
+
+    // Locus out of bounds
+    tst::write("a2.txt", base.str() + "pleioloci 1 4\npleiotraits 2 1\npleioeffects 0.5 0.6\npleiodomcoeffs 0 0\n");
+
+    // Trait out of bounds
+    tst::write("a3.txt", base.str() + "pleioloci 1 2\npleiotraits 3 1\npleioeffects 0.5 0.6\npleiodomcoeffs 0 0\n");
+
+    // Trait already encoded by the locus
+    tst::write("a4.txt", base.str() + "pleioloci 1 2\npleiotraits 2 2\npleioeffects 0.5 0.6\npleiodomcoeffs 0 0\n");
+
+    // Same effect given twice
+    tst::write("a5.txt", base.str() + "pleioloci 2 2\npleiotraits 1 1\npleioeffects 0.5 0.6\npleiodomcoeffs 0 0\n");
+
+    // Check
+    tst::checkError([&]() { Architecture arch("a1.txt"); }, "Number of pleiotropic dominance effects does not match number of pleiotropic effects in file a1.txt");
+    tst::checkError([&]() { Architecture arch("a2.txt"); }, "Locus 4 of pleiotropic effect 2 is out of bounds in file a2.txt");
+    tst::checkError([&]() { Architecture arch("a3.txt"); }, "Trait 3 of pleiotropic effect 1 is out of bounds in file a3.txt");
+    tst::checkError([&]() { Architecture arch("a4.txt"); }, "Pleiotropic effect 2 is on the trait already encoded by its locus in file a4.txt");
+    tst::checkError([&]() { Architecture arch("a5.txt"); }, "Locus 2 has more than one pleiotropic effect on trait 1 in file a5.txt");
+
+    // Remove files
+    std::remove("a1.txt");
+    std::remove("a2.txt");
+    std::remove("a3.txt");
+    std::remove("a4.txt");
+    std::remove("a5.txt");
+
+}
+
+// Test that pleiotropic effects are generated on other traits than the main one
+BOOST_AUTO_TEST_CASE(generatePleiotropicArchitecture) {
+
+    // Create parameters where every locus affects every trait
+    Parameters pars;
+    pars.ntraits = 3u;
+    pars.nlocipertrait = {10u, 10u, 10u};
+    pars.nedgespertrait = {0u, 0u, 0u};
+    pars.skew = {1.0, 1.0, 1.0};
+    pars.standard = false;
+    pars.pleiotropy = 1.0;
+    pars.pleiocorr = 1.0;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate an architecture
+    Architecture arch;
+    arch.generate(pars);
+
+    // Check that each locus affects the two other traits
+    BOOST_CHECK_EQUAL(arch.npleio, 60u);
+
+    // Flag
+    bool iswrong = false;
+
+    // For each locus...
+    for (size_t i = 0u; i < arch.nloci; ++i) {
+
+        // Check the number of other traits
+        if (arch.pleiostarts[i + 1u] - arch.pleiostarts[i] != 2u) iswrong = true;
+
+        // For each other trait...
+        for (size_t e = arch.pleiostarts[i]; e < arch.pleiostarts[i + 1u]; ++e) {
+
+            // Check that it is not the main trait
+            if (arch.pleiotraits[e] == arch.traitids[i]) iswrong = true;
+
+            // Fully correlated effects should be the same as the main ones
+            if (std::abs(arch.pleioeffects[e] - arch.effects[i]) > 1e-9) iswrong = true;
+            if (std::abs(arch.pleiodomcoeffs[e] - arch.domcoeffs[i]) > 1e-9) iswrong = true;
+
+        }
+    }
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+    // Without pleiotropy there should be none
+    pars.pleiotropy = 0.0;
+    Architecture arch2;
+    arch2.generate(pars);
+    BOOST_CHECK_EQUAL(arch2.npleio, 0u);
+    BOOST_CHECK(arch2.pleiostarts.empty());
+
+}
+
+// Test that architecture can be saved to and read from a binary file
+BOOST_AUTO_TEST_CASE(saveArchitectureInBinary) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 3u;
+    pars.nlocipertrait = {50u, 40u, 30u};
+    pars.nedgespertrait = {60u, 50u, 40u};
+    pars.nhyperpertrait = {20u, 0u, 10u};
+    pars.skew = {0.5, 1.0, 1.5};
+    pars.pleiotropy = 0.2;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate architecture
+    Architecture arch;
+    arch.generate(pars);
+
+    // Save it in binary
+    arch.savebinary("architecture.dat");
+
+    // Check that the format is recognized
+    BOOST_CHECK(Architecture::isbinary("architecture.dat"));
+
+    // Read it back
+    Architecture arch2("architecture.dat");
+
+    // Check that nothing was lost
+    BOOST_CHECK_EQUAL(arch2.nloci, arch.nloci);
+    BOOST_CHECK_EQUAL(arch2.nedges, arch.nedges);
+    BOOST_CHECK_EQUAL(arch2.ntraits, arch.ntraits);
+    BOOST_CHECK_EQUAL(arch2.npleio, arch.npleio);
+    BOOST_CHECK(arch2.nlocipertrait == arch.nlocipertrait);
+    BOOST_CHECK(arch2.nedgespertrait == arch.nedgespertrait);
+    BOOST_CHECK(arch2.traitids == arch.traitids);
+    BOOST_CHECK(arch2.effects == arch.effects);
+    BOOST_CHECK(arch2.domcoeffs == arch.domcoeffs);
+    BOOST_CHECK(arch2.from == arch.from);
+    BOOST_CHECK(arch2.to == arch.to);
+    BOOST_CHECK(arch2.weights == arch.weights);
+    BOOST_CHECK(arch2.pleiostarts == arch.pleiostarts);
+    BOOST_CHECK(arch2.pleiotraits == arch.pleiotraits);
+    BOOST_CHECK(arch2.pleioeffects == arch.pleioeffects);
+    BOOST_CHECK(arch2.pleiodomcoeffs == arch.pleiodomcoeffs);
+    BOOST_CHECK_EQUAL(arch2.nhyper, arch.nhyper);
+    BOOST_CHECK(arch2.nhyperpertrait == arch.nhyperpertrait);
+    BOOST_CHECK(arch2.hyperstarts == arch.hyperstarts);
+    BOOST_CHECK(arch2.hyperloci == arch.hyperloci);
+    BOOST_CHECK(arch2.hyperweights == arch.hyperweights);
+
+    // Note: Values are compared exactly, since they are saved as they are.
+
+    // Check that text files are not taken for binary ones
+    arch.save("architecture.txt");
+    BOOST_CHECK(!Architecture::isbinary("architecture.txt"));
+    BOOST_CHECK(!Architecture::isbinary("missing.dat"));
+
+    // Remove files
+    std::remove("architecture.dat");
+    std::remove("architecture.txt");
+
+}
+
+// Test that binary architectures are read in place from the mapped file
+BOOST_AUTO_TEST_CASE(readBinaryArchitectureInPlace) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 2u;
+    pars.nlocipertrait = {50u, 40u};
+    pars.nedgespertrait = {60u, 50u};
+    pars.nhyperpertrait = {10u, 0u};
+    pars.skew = {0.5, 1.0};
+    pars.pleiotropy = 0.2;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate and save an architecture
+    Architecture arch;
+    arch.generate(pars);
+    arch.savebinary("architecture.dat");
+
+    // Read it back
+    Architecture arch2("architecture.dat");
+
+    // Check that its arrays point into the file instead of being copied
+    BOOST_CHECK(arch2.traitids.isview());
+    BOOST_CHECK(arch2.effects.isview());
+    BOOST_CHECK(arch2.domcoeffs.isview());
+    BOOST_CHECK(arch2.from.isview());
+    BOOST_CHECK(arch2.to.isview());
+    BOOST_CHECK(arch2.weights.isview());
+    BOOST_CHECK(arch2.pleiotraits.isview());
+    BOOST_CHECK(arch2.pleioeffects.isview());
+    BOOST_CHECK(arch2.hyperloci.isview());
+    BOOST_CHECK(arch2.hyperweights.isview());
+
+    // Check that a copy of it points into the file too
+    const Architecture arch3 = arch2;
+    BOOST_CHECK(arch3.effects.isview());
+    BOOST_CHECK_EQUAL(arch3.effects.data(), std::as_const(arch2).effects.data());
+
+    // Change one effect
+    arch2.effects[0u] = arch.effects[0u] + 1.0;
+
+    // Check that only that array is copied, and the file not touched
+    BOOST_CHECK(!arch2.effects.isview());
+    BOOST_CHECK(arch2.domcoeffs.isview());
+    BOOST_CHECK(arch3.effects == arch.effects);
+    BOOST_CHECK(Architecture("architecture.dat").effects == arch.effects);
+
+    // Save the changed architecture over the file it was read from
+    arch2.savebinary("architecture.dat");
+
+    // Check that the new file has the change and the old arrays are still valid
+    const Architecture arch4("architecture.dat");
+    BOOST_CHECK(arch4.effects == arch2.effects);
+    BOOST_CHECK(arch4.weights == arch.weights);
+    BOOST_CHECK(arch3.effects == arch.effects);
+    BOOST_CHECK(arch3.weights == arch.weights);
+
+    // Remove files
+    std::remove("architecture.dat");
+
+}
+
+// Test that damaged binary files are caught
+BOOST_AUTO_TEST_CASE(readInvalidBinaryArchitecture) {
+
+    // Create a small architecture
+    Architecture arch;
+    arch.nloci = 5u;
+    arch.nedges = 2u;
+    arch.ntraits = 2u;
+    arch.nlocipertrait = {2u, 3u};
+    arch.nedgespertrait = {1u, 1u};
+    arch.traitids = {0u, 0u, 1u, 1u, 1u};
+    arch.effects = {0.1, 0.2, 0.3, 0.4, 0.5};
+    arch.domcoeffs = {0.01, 0.02, 0.03, 0.04, 0.05};
+    arch.from = {0u, 2u};
+    arch.to = {1u, 3u};
+    arch.weights = {0.5, 0.6};
+
+    // Save it in binary
+    arch.savebinary("a1.dat");
+
+    // Read the bytes of the file
+    std::ifstream file("a1.dat", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // Write a truncated copy
+    std::ofstream("a2.dat", std::ios::binary) << bytes.substr(0u, bytes.size() - 64u);
+
+    // Write a copy with a changed byte
+    std::string changed = bytes;
+    changed[changed.size() - 1u] ^= 1;
+    std::ofstream("a3.dat", std::ios::binary) << changed;
+
+    // Write a copy from a later version of the format
+    std::string later = bytes;
+    later[8u] = 4;
+    std::ofstream("a4.dat", std::ios::binary) << later;
+
+    // Check
+    tst::checkError([&]() { Architecture arch2("a2.dat"); }, "Truncated binary architecture in file a2.dat");
+    tst::checkError([&]() { Architecture arch2("a3.dat"); }, "Checksum mismatch in binary architecture in file a3.dat");
+    tst::checkError([&]() { Architecture arch2("a4.dat"); }, "Unsupported version 4 of binary architecture in file a4.dat");
+
+    // Remove files
+    std::remove("a1.dat");
+    std::remove("a2.dat");
+    std::remove("a3.dat");
+    std::remove("a4.dat");
+
+}
+
+// Test that intact binary files with inconsistent contents are caught
+BOOST_AUTO_TEST_CASE(readInconsistentBinaryArchitecture) {
+
+    // Create a small architecture
+    Architecture arch;
+    arch.nloci = 5u;
+    arch.nedges = 2u;
+    arch.ntraits = 2u;
+    arch.nlocipertrait = {2u, 3u};
+    arch.nedgespertrait = {1u, 1u};
+    arch.nhyperpertrait = {0u, 0u};
+    arch.traitids = {0u, 0u, 1u, 1u, 1u};
+    arch.effects = {0.1, 0.2, 0.3, 0.4, 0.5};
+    arch.domcoeffs = {0.01, 0.02, 0.03, 0.04, 0.05};
+    arch.from = {0u, 2u};
+    arch.to = {1u, 3u};
+    arch.weights = {0.5, 0.6};
+
+    // Function to save a copy of the architecture with something changed
+    auto save = [&](const std::string &filename, const std::function<void(Architecture&)> &change) {
+        Architecture copy = arch;
+        change(copy);
+        copy.savebinary(filename);
+    };
+
+    // Save copies with encoded traits, edges or pleiotropic effects that do not fit
+    save("a1.dat", [](Architecture &a) { a.traitids[4u] = 2u; });
+    save("a2.dat", [](Architecture &a) { a.nlocipertrait = {3u, 2u}; });
+    save("a3.dat", [](Architecture &a) { a.to[1u] = 7u; });
+    save("a4.dat", [](Architecture &a) { a.to[1u] = 2u; });
+    save("a5.dat", [](Architecture &a) { a.to[1u] = 1u; });
+    save("a6.dat", [](Architecture &a) { a.nedgespertrait = {2u, 0u}; });
+    save("a7.dat", [](Architecture &a) { a.npleio = 1u; a.pleiostarts = {0u, 1u, 0u, 1u, 1u, 1u}; a.pleiotraits = {1u}; a.pleioeffects = {0.1}; a.pleiodomcoeffs = {0.0}; });
+    save("a8.dat", [](Architecture &a) { a.npleio = 1u; a.pleiostarts = {0u, 1u, 1u, 1u, 1u, 1u}; a.pleiotraits = {2u}; a.pleioeffects = {0.1}; a.pleiodomcoeffs = {0.0}; });
+
+    // Function to give the architecture a hyperedge of three loci
+    auto hyperedge = [](Architecture &a, const std::vector<Architecture::Locus> &loci, const std::vector<size_t> &counts) {
+        a.nhyper = 1u;
+        a.nhyperpertrait = counts;
+        a.hyperstarts = {0u, 3u};
+        a.hyperloci = loci;
+        a.hyperweights = {0.1};
+    };
+
+    // Save copies with hyperedges that do not fit
+    save("a9.dat", [&](Architecture &a) { hyperedge(a, {2u, 3u, 9u}, {0u, 1u}); });
+    save("a10.dat", [&](Architecture &a) { hyperedge(a, {2u, 3u, 1u}, {0u, 1u}); });
+    save("a11.dat", [&](Architecture &a) { hyperedge(a, {2u, 3u, 3u}, {0u, 1u}); });
+    save("a12.dat", [&](Architecture &a) { hyperedge(a, {2u, 3u, 4u}, {1u, 0u}); });
+
+    // Check that a fitting hyperedge is accepted
+    save("a13.dat", [&](Architecture &a) { hyperedge(a, {2u, 3u, 4u}, {0u, 1u}); });
+    BOOST_CHECK_NO_THROW(Architecture arch2("a13.dat"));
+    std::remove("a13.dat");
+
+    // Check
+    for (size_t i = 1u; i <= 12u; ++i) {
+        const std::string filename = "a" + std::to_string(i) + ".dat";
+        tst::checkError([&]() { Architecture arch2(filename); }, "Inconsistent binary architecture in file " + filename);
+        std::remove(filename.c_str());
+    }
+
+}
+
+// Test that an architecture with hyperedges can be read
+BOOST_AUTO_TEST_CASE(readHyperedgeArchitecture) {
+
+    // Write a file with hyperedges of mixed orders
+    std::ostringstream content;
+    content << "nloci 6\n";
+    content << "nedges 0\n";
+    content << "ntraits 2\n";
+    content << "traitids 1 1 1 1 2 2\n";
+    content << "effects 0.1 0.2 0.3 0.4 0.5 0.6\n";
+    content << "domcoeffs 0 0 0 0 0 0\n";
+    content << "nhyper 4\n";
+    content << "hyperorders 4 3 2 3\n";
+    content << "hyperloci 1 2 3 4 4 3 1 5 6 2 3 4\n";
+    content << "hyperweights 0.4 0.3 0.2 0.1\n";
+    tst::write("architecture.txt", content.str());
+
+    // Read the architecture
+    Architecture arch("architecture.txt");
+
+    // Check the numbers of hyperedges
+    BOOST_CHECK_EQUAL(arch.nhyper, 4u);
+    BOOST_CHECK_EQUAL(arch.nhyperpertrait[0], 3u);
+    BOOST_CHECK_EQUAL(arch.nhyperpertrait[1], 1u);
+
+    // Check that hyperedges are grouped by order, keeping their order otherwise
+    const std::vector<size_t> starts = {0u, 2u, 5u, 8u, 12u};
+    const std::vector<Architecture::Locus> loci = {4u, 5u, 3u, 2u, 0u, 1u, 2u, 3u, 0u, 1u, 2u, 3u};
+    BOOST_CHECK(arch.hyperstarts == starts);
+    BOOST_CHECK(arch.hyperloci == loci);
+    BOOST_CHECK_CLOSE(arch.hyperweights[0], Architecture::Effect(0.2), 1e-6);
+    BOOST_CHECK_CLOSE(arch.hyperweights[1], Architecture::Effect(0.3), 1e-6);
+    BOOST_CHECK_CLOSE(arch.hyperweights[2], Architecture::Effect(0.1), 1e-6);
+    BOOST_CHECK_CLOSE(arch.hyperweights[3], Architecture::Effect(0.4), 1e-6);
+
+    // Save and read back
+    arch.save("architecture.txt");
+    Architecture arch2("architecture.txt");
+
+    // Check that nothing was lost
+    BOOST_CHECK_EQUAL(arch2.nhyper, 4u);
+    BOOST_CHECK(arch2.hyperstarts == arch.hyperstarts);
+    BOOST_CHECK(arch2.hyperloci == arch.hyperloci);
+    BOOST_CHECK(arch2.nhyperpertrait == arch.nhyperpertrait);
+    BOOST_CHECK_CLOSE(arch2.hyperweights[3], Architecture::Effect(0.4), 1e-6);
+
+    // Remove file
+    std::remove("architecture.txt");
+
+}
+
+// Test that invalid hyperedges are caught
+BOOST_AUTO_TEST_CASE(readInvalidHyperedges) {
+
+    // Write the part of the file that is fine
+    std::ostringstream base;
+    base << "nloci 4\n";
+    base << "nedges 0\n";
+    base << "ntraits 2\n";
+    base << "traitids 1 1 1 2\n";
+    base << "effects 0.1 0.2 0.3 0.4\n";
+    base << "domcoeffs 0 0 0 0\n";
+    base << "nhyper 1\n";
+
+    // Order too low
+    tst::write("a1.txt", base.str() + "hyperorders 1\nhyperloci 1\nhyperweights 0.5\n");
+
+    // Missing weights
+    tst::write("a2.txt", base.str() + "hyperorders 3\nhyperloci 1 2 3\n");
+
+    // Locus out of bounds
+    tst::write("a3.txt", base.str() + "hyperorders 3\nhyperloci 1 2 5\nhyperweights 0.5\n");
+
+    // Loci affecting different traits
+    tst::write("a4.txt", base.str() + "hyperorders 3\nhyperloci 1 2 4\nhyperweights 0.5\n");
+
+    // Same locus twice
+    tst::write("a5.txt", base.str() + "hyperorders 3\nhyperloci 1 2 1\nhyperweights 0.5\n");
+
+    // Check
+    tst::checkError([&]() { Architecture arch("a1.txt"); }, "Parameter hyperorders must be at least 2 in line 8 of file a1.txt");
+    tst::checkError([&]() { Architecture arch("a2.txt"); }, "Number of hyperedge weights does not match number of hyperedges in file a2.txt");
+    tst::checkError([&]() { Architecture arch("a3.txt"); }, "Locus 5 of hyperedge 1 is out of bounds in file a3.txt");
+    tst::checkError([&]() { Architecture arch("a4.txt"); }, "Loci of hyperedge 1 affect different traits in file a4.txt");
+    tst::checkError([&]() { Architecture arch("a5.txt"); }, "Hyperedge 1 has the same locus more than once in file a5.txt");
+
+    // Remove files
+    std::remove("a1.txt");
+    std::remove("a2.txt");
+    std::remove("a3.txt");
+    std::remove("a4.txt");
+    std::remove("a5.txt");
+
+}
+
+// Test that hyperedges are generated between distinct loci of the same trait
+BOOST_AUTO_TEST_CASE(generateHyperedgeArchitecture) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 2u;
+    pars.nlocipertrait = {8u, 6u};
+    pars.nedgespertrait = {0u, 0u};
+    pars.nhyperpertrait = {30u, 20u};
+    pars.hyperorder = 3u;
+    pars.skew = {1.0, 1.0};
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate an architecture
+    Architecture arch;
+    arch.generate(pars);
+
+    // Check the numbers of hyperedges
+    BOOST_CHECK_EQUAL(arch.nhyper, 50u);
+    BOOST_CHECK_EQUAL(arch.hyperstarts.size(), 51u);
+    BOOST_CHECK_EQUAL(arch.hyperloci.size(), 150u);
+    BOOST_CHECK_EQUAL(arch.hyperweights.size(), 50u);
+
+    // Prepare to record the sets of loci
+    std::set<std::vector<size_t> > sets;
+
+    // Flag
+    bool iswrong = false;
+
+    // For each hyperedge...
+    for (size_t h = 0u; h < arch.nhyper; ++h) {
+
+        // Check its order
+        if (arch.hyperstarts[h + 1u] - arch.hyperstarts[h] != 3u) iswrong = true;
+
+        // Collect its loci
+        std::vector<size_t> loci(arch.hyperloci.begin() + arch.hyperstarts[h], arch.hyperloci.begin() + arch.hyperstarts[h + 1u]);
+
+        // Check that they are distinct and affect the same trait
+        for (size_t k = 1u; k < loci.size(); ++k) {
+            if (loci[k] <= loci[k - 1u]) iswrong = true;
+            if (arch.traitids[loci[k]] != arch.traitids[loci[0u]]) iswrong = true;
+        }
+
+        // Check that the set of loci is new
+        if (!sets.insert(loci).second) iswrong = true;
+
+    }
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+    // All the sets of three loci of the second trait can be used
+    pars.nhyperpertrait = {0u, 20u};
+    pars.update();
+    Architecture arch2;
+    arch2.generate(pars);
+    BOOST_CHECK_EQUAL(arch2.nhyper, 20u);
+
+    // But no more
+    pars.nhyperpertrait = {0u, 21u};
+    pars.update();
+    Architecture arch3;
+    tst::checkError([&]() { arch3.generate(pars); }, "Not all requested hyperedges could be made for trait 2 with the given parameters");
+
+}
+
+// Test that sets of vertices are counted
+BOOST_AUTO_TEST_CASE(subsetsAreCounted) {
+
+    // Known values
+    BOOST_CHECK_EQUAL(net::nsubsets(5u, 2u), 10u);
+    BOOST_CHECK_EQUAL(net::nsubsets(6u, 3u), 20u);
+    BOOST_CHECK_EQUAL(net::nsubsets(4u, 4u), 1u);
+    BOOST_CHECK_EQUAL(net::nsubsets(3u, 4u), 0u);
+    BOOST_CHECK_EQUAL(net::nsubsets(60u, 30u), 118264581564861424u);
+
+    // Too many to count
+    BOOST_CHECK_EQUAL(net::nsubsets(1000000u, 10u), std::numeric_limits<size_t>::max());
+
+}
+
+// Test that streaming an architecture to file gives the same file as saving it
+BOOST_AUTO_TEST_CASE(streamArchitectureToFile) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 3u;
+    pars.nlocipertrait = {30u, 20u, 25u};
+    pars.nedgespertrait = {50u, 0u, 40u};
+    pars.nhyperpertrait = {5u, 3u, 0u};
+    pars.skew = {0.5, 1.0, 1.5};
+    pars.sdweights = 1.0;
+    pars.pleiotropy = 0.2;
+
+    // Update internal parameters
+    pars.update();
+
+    // For each model of networks...
+    for (size_t network : {0u, 1u, 3u}) {
+
+        // Use it
+        pars.network = network;
+
+        // Generate an architecture and save it in both formats
+        Architecture arch;
+        rnd::rng.seed(42u);
+        arch.generate(pars);
+        arch.save("a1.txt");
+        arch.savebinary("a1.dat");
+
+        // Stream the same architecture in small chunks
+        Architecture arch2;
+        rnd::rng.seed(42u);
+        arch2.stream(pars, "a2.txt", false, 7u);
+        rnd::rng.seed(42u);
+        arch2.stream(pars, "a2.dat", true, 7u);
+
+        // Check that the files are the same
+        BOOST_CHECK(tst::readtext("a1.txt") == tst::readtext("a2.txt"));
+        BOOST_CHECK(tst::readtext("a1.dat") == tst::readtext("a2.dat"));
+
+        // Check that the edges were not kept
+        BOOST_CHECK_EQUAL(arch2.nedges, 0u);
+        BOOST_CHECK(arch2.from.empty());
+        BOOST_CHECK(arch2.effects == arch.effects);
+
+        // Check that no temporary files were left
+        BOOST_CHECK(!std::ifstream("a2.txt.from.tmp").good());
+        BOOST_CHECK(!std::ifstream("a2.dat.weights.tmp").good());
+
+    }
+
+    // Check that errors are passed on
+    tst::checkError([&]() { Architecture arch; arch.stream(pars, "missing/a3.txt"); }, "Unable to open file missing/a3.txt");
+
+    // Remove files
+    std::remove("a1.txt");
+    std::remove("a1.dat");
+    std::remove("a2.txt");
+    std::remove("a2.dat");
+
+}
+
+// Test that packed edges are the same as unpacked ones
+BOOST_AUTO_TEST_CASE(packArchitectureEdges) {
+
+    // Create parameters
+    Parameters pars;
+    pars.ntraits = 3u;
+    pars.nlocipertrait = {100u, 50u, 80u};
+    pars.nedgespertrait = {300u, 0u, 200u};
+    pars.skew = {0.5, 1.0, 1.5};
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate an architecture
+    Architecture arch;
+    rnd::rng.seed(42u);
+    arch.generate(pars);
+
+    // Generate the same one with its edges packed
+    Architecture arch2;
+    pars.packedges = true;
+    rnd::rng.seed(42u);
+    arch2.generate(pars);
+
+    // Check that the edges are packed
+    BOOST_CHECK(!arch2.packed.empty());
+    BOOST_CHECK(arch2.from.empty());
+    BOOST_CHECK(arch2.to.empty());
+    BOOST_CHECK(arch2.weights == arch.weights);
+
+    // Check that they take less room
+    BOOST_CHECK(arch2.packed.size() < arch.nedges * 2u * sizeof(Architecture::Locus));
+
+    // Check that they are saved as the same text
+    arch.save("a1.txt");
+    arch2.save("a2.txt");
+    BOOST_CHECK(tst::readtext("a1.txt") == tst::readtext("a2.txt"));
+
+    // Check that they remain packed through the binary format
+    arch2.savebinary("a2.dat");
+    Architecture arch3("a2.dat");
+    BOOST_CHECK(arch3.packed == arch2.packed);
+    BOOST_CHECK(arch3.from.empty());
+
+    // Check that they unpack into the original edges
+    arch3.unpack();
+    BOOST_CHECK(arch3.packed.empty());
+    BOOST_CHECK(arch3.from == arch.from);
+    BOOST_CHECK(arch3.to == arch.to);
+
+    // And pack back into the same stream
+    arch3.pack();
+    BOOST_CHECK(arch3.packed == arch2.packed);
+
+    // Remove files
+    std::remove("a1.txt");
+    std::remove("a2.txt");
+    std::remove("a2.dat");
+
+}
+
+// Test that damaged packed edges are caught
+BOOST_AUTO_TEST_CASE(readInvalidPackedEdges) {
+
+    // Create a small architecture
+    Architecture arch;
+    arch.nloci = 5u;
+    arch.nedges = 2u;
+    arch.ntraits = 2u;
+    arch.nlocipertrait = {2u, 3u};
+    arch.nedgespertrait = {1u, 1u};
+    arch.nhyperpertrait = {0u, 0u};
+    arch.traitids = {0u, 0u, 1u, 1u, 1u};
+    arch.effects = {0.1, 0.2, 0.3, 0.4, 0.5};
+    arch.domcoeffs = {0.01, 0.02, 0.03, 0.04, 0.05};
+    arch.from = {0u, 2u};
+    arch.to = {1u, 3u};
+    arch.weights = {0.5, 0.6};
+
+    // Pack its edges and save it
+    arch.pack();
+    arch.savebinary("a1.dat");
+
+    // Save it again with the second edge starting out of bounds (fifth byte, see packing.hpp)
+    arch.packed[4u] = 12u;
+    arch.savebinary("a2.dat");
+
+    // And with an edge missing
+    arch.packed.pop_back();
+    arch.savebinary("a3.dat");
+
+    // And with a single run of two self-loops (start locus 1, two edges, differences of zero bits)
+    arch.packed = {0x02u, 0x02u, 0x00u};
+    arch.savebinary("a4.dat");
+
+    // And with a run of zero bits claiming about a trillion edges
+    arch.packed = {0x02u, 0x80u, 0x80u, 0x80u, 0x80u, 0x80u, 0x20u, 0x00u};
+    arch.savebinary("a5.dat");
+
+    // Check
+    BOOST_CHECK_NO_THROW(Architecture arch2("a1.dat"));
+    tst::checkError([&]() { Architecture arch2("a2.dat"); }, "Inconsistent binary architecture in file a2.dat");
+    tst::checkError([&]() { Architecture arch2("a3.dat"); }, "Inconsistent binary architecture in file a3.dat");
+    tst::checkError([&]() { Architecture arch2("a4.dat"); }, "Inconsistent binary architecture in file a4.dat");
+    tst::checkError([&]() { Architecture arch2("a5.dat"); }, "Inconsistent binary architecture in file a5.dat");
+
+    // Remove files
+    std::remove("a1.dat");
+    std::remove("a2.dat");
+    std::remove("a3.dat");
+    std::remove("a4.dat");
+    std::remove("a5.dat");
+
+}
+
+// Test that long lines are read the same on several threads
+BOOST_AUTO_TEST_CASE(readLongLinesInParallel) {
+
+    // Create parameters for an architecture with lines of several megabytes
+    Parameters pars;
+    pars.ntraits = 2u;
+    pars.nlocipertrait = {100000u, 50000u};
+    pars.nedgespertrait = {300000u, 100000u};
+    pars.skew = {1.0, 1.0};
+    pars.sdeffects = 1.0;
+    pars.sddomcoeffs = 1.0;
+    pars.sdweights = 1.0;
+
+    // Update internal parameters
+    pars.update();
+
+    // Generate and save an architecture
+    Architecture arch;
+    arch.generate(pars);
+    arch.save("architecture.txt");
+
+    // Read it on one thread and on several
+    Architecture arch1("architecture.txt", 1u);
+    Architecture arch2("architecture.txt", 4u);
+
+    // Check that the results are the same
+    BOOST_CHECK(arch2.effects == arch1.effects);
+    BOOST_CHECK(arch2.domcoeffs == arch1.domcoeffs);
+    BOOST_CHECK(arch2.from == arch.from);
+    BOOST_CHECK(arch2.to == arch.to);
+    BOOST_CHECK(arch2.weights == arch1.weights);
+    BOOST_CHECK(arch2.nedgespertrait == arch.nedgespertrait);
+
+    // Remove file
+    std::remove("architecture.txt");
+
+}
+
+// Test that errors in long lines are the same on several threads
+BOOST_AUTO_TEST_CASE(readInvalidLongLines) {
+
+    // Number of edges (enough for lines of more than a megabyte)
+    const size_t n = 600000u;
+
+    // Function to make a long line of values, with one of them replaced
+    auto line = [&](const std::string &x, const size_t &i, const std::string &value) {
+        std::string result;
+        for (size_t e = 0u; e < n; ++e) result += ' ' + (e == i ? value : x);
+        return result;
+    };
+
+    // Function to write an architecture with a given line of start loci and number of edges
+    auto write = [&](const std::string &filename, const std::string &from, const size_t &nedges) {
+        std::ostringstream content;
+        content << "nloci 10\nnedges " << nedges << "\nntraits 1\n";
+        content << "traitids 1 1 1 1 1 1 1 1 1 1\n";
+        content << "effects 0 0 0 0 0 0 0 0 0 0\n";
+        content << "domcoeffs 0 0 0 0 0 0 0 0 0 0\n";
+        content << "from" << from << '\n';
+        content << "to" << line("2", n, "") << '\n';
+        content << "weights" << line("0.5", n, "") << '\n';
+        tst::write(filename, content.str());
+    };
+
+    // Write architectures with a problem at some point of a long line
+    write("a1.txt", line("1", 400000u, "0.5"), n);
+    write("a2.txt", line("1", 400000u, "0"), n);
+    write("a3.txt", line("1", 400000u, "#"), n);
+    write("a4.txt", line("1", n, ""), n + 1u);
+    write("a5.txt", line("1", n, ""), n - 1u);
+    write("a6.txt", line("1", n, "") + ' ', n);
+    write("a7.txt", line("1", 400000u, "11"), n);
+    write("a8.txt", line("1", n, ""), n);
+
+    // Check the errors, and that they are the same on one thread
+    for (size_t nthreads : {1u, 4u}) {
+        tst::checkError([&]() { Architecture arch("a1.txt", nthreads); }, "Invalid value type for parameter from in line 7 of file a1.txt");
+        tst::checkError([&]() { Architecture arch("a2.txt", nthreads); }, "Parameter from must be strictly positive in line 7 of file a2.txt");
+        tst::checkError([&]() { Architecture arch("a3.txt", nthreads); }, "Could not read value for parameter from in line 7 of file a3.txt");
+        tst::checkError([&]() { Architecture arch("a4.txt", nthreads); }, "Too few values for parameter from in line 7 of file a4.txt");
+        tst::checkError([&]() { Architecture arch("a5.txt", nthreads); }, "Too many values for parameter from in line 7 of file a5.txt");
+        tst::checkError([&]() { Architecture arch("a6.txt", nthreads); }, "Too many values for parameter from in line 7 of file a6.txt");
+        tst::checkError([&]() { Architecture arch("a7.txt", nthreads); }, "Start locus 11 of edge 400001 is out of bounds in file a7.txt");
+        BOOST_CHECK_NO_THROW(Architecture arch("a8.txt", nthreads));
+    }
+
+    // Remove files
+    for (size_t i = 1u; i <= 8u; ++i) std::remove(("a" + std::to_string(i) + ".txt").c_str());
+
+}
@@ -0,0 +1,76 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the arrays that can view memory they do not own.
+
+#include "testutils.hpp"
+#include "../src/array.hpp"
+#include <boost/test/unit_test.hpp>
+#include <memory>
+
+// Test that an array behaves like a vector when it owns its values
+BOOST_AUTO_TEST_CASE(arrayOwnsValues) {
+
+    // Create an array
+    Array<int> x = {1, 2, 3};
+
+    // Check
+    BOOST_CHECK(!x.isview());
+    BOOST_CHECK_EQUAL(x.size(), 3u);
+    BOOST_CHECK_EQUAL(x[1u], 2);
+
+    // Change it
+    x.push_back(4);
+    x[0u] = 5;
+    x.insert(x.end(), x.begin(), x.begin() + 2u);
+
+    // Check
+    const std::vector<int> expected = {5, 2, 3, 4, 5, 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(x.begin(), x.end(), expected.begin(), expected.end());
+
+    // Check that copies are independent
+    Array<int> y = x;
+    y[0u] = 0;
+    BOOST_CHECK_EQUAL(x[0u], 5);
+    BOOST_CHECK(!(x == y));
+
+}
+
+// Test that an array can view values without copying them
+BOOST_AUTO_TEST_CASE(arrayViewsValues) {
+
+    // Values owned by something else
+    const std::shared_ptr<std::vector<int> > values = std::make_shared<std::vector<int> >(std::vector<int>{1, 2, 3});
+
+    // View them
+    Array<int> x;
+    x.view(values->data(), values->size(), values);
+
+    // Check that they are read in place
+    const Array<int> &y = x;
+    BOOST_CHECK(x.isview());
+    BOOST_CHECK_EQUAL(y.data(), values->data());
+    BOOST_CHECK_EQUAL(y[2u], 3);
+    BOOST_CHECK_EQUAL(values.use_count(), 2);
+
+    // Check that copies view them too
+    Array<int> z = x;
+    BOOST_CHECK(z.isview());
+    BOOST_CHECK_EQUAL(std::as_const(z).data(), values->data());
+
+    // Change the array
+    x[0u] = 7;
+
+    // Check that the values were copied first
+    BOOST_CHECK(!x.isview());
+    BOOST_CHECK_EQUAL(x[0u], 7);
+    BOOST_CHECK_EQUAL((*values)[0u], 1);
+    BOOST_CHECK_EQUAL(std::as_const(z)[0u], 1);
+
+    // Check that clearing stops viewing
+    z.clear();
+    BOOST_CHECK(!z.isview());
+    BOOST_CHECK(z.empty());
+    BOOST_CHECK_EQUAL(values.use_count(), 1);
+
+}
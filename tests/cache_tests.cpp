@@ -0,0 +1,137 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the cache of generated architectures.
+
+#include "testutils.hpp"
+#include "../src/cache.hpp"
+#include "../src/architecture.hpp"
+#include "../src/parameters.hpp"
+#include "../src/random.hpp"
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+
+// Test that keys depend on what determines the architecture
+BOOST_AUTO_TEST_CASE(cacheKeysFollowParameters) {
+
+    // Create parameters
+    Parameters pars;
+    pars.rng = rnd::counter;
+    pars.seed = 42u;
+
+    // Create a cache
+    Cache cache("testcache");
+
+    // Key of the first replicate
+    const std::string key = cache.key(pars, 0u);
+
+    // Check that it is a file name of fixed length
+    BOOST_CHECK_EQUAL(key.size(), 16u);
+    BOOST_CHECK_EQUAL(cache.key(pars, 0u), key);
+
+    // Check that the replicate changes it
+    BOOST_CHECK(cache.key(pars, 1u) != key);
+
+    // Check that the number of threads does not
+    pars.nthreads = 3u;
+    BOOST_CHECK_EQUAL(cache.key(pars, 0u), key);
+
+    // Check that the seed and generating parameters do
+    pars.seed = 43u;
+    BOOST_CHECK(cache.key(pars, 0u) != key);
+    pars.seed = 42u;
+    pars.skew[0u] = 0.9;
+    BOOST_CHECK(cache.key(pars, 0u) != key);
+    pars.skew[0u] = 1.0;
+    pars.pleiotropy = 0.1;
+    BOOST_CHECK(cache.key(pars, 0u) != key);
+
+}
+
+// Test that stored architectures are found again
+BOOST_AUTO_TEST_CASE(cacheStoresAndFetchesArchitectures) {
+
+    // Create parameters
+    Parameters pars;
+    pars.rng = rnd::counter;
+    pars.seed = 42u;
+
+    // Seed the generator
+    rnd::rng.use(pars.rng);
+    rnd::rng.seed(pars.seed);
+
+    // Create a cache
+    Cache cache("testcache");
+    const std::string key = cache.key(pars, 0u);
+
+    // Check that there is nothing yet
+    Architecture arch;
+    BOOST_CHECK(!cache.fetch(arch, key));
+
+    // Generate and store an architecture
+    arch.generate(pars);
+    cache.store(arch, key);
+
+    // Check that it is found
+    Architecture arch2;
+    BOOST_CHECK(cache.fetch(arch2, key));
+
+    // Check that it is the same
+    BOOST_CHECK(arch2.traitids == arch.traitids);
+    BOOST_CHECK(arch2.effects == arch.effects);
+    BOOST_CHECK(arch2.from == arch.from);
+    BOOST_CHECK(arch2.to == arch.to);
+    BOOST_CHECK(arch2.weights == arch.weights);
+
+    // Check the counters
+    BOOST_CHECK_EQUAL(cache.nhits(), 1u);
+    BOOST_CHECK_EQUAL(cache.nmisses(), 1u);
+    BOOST_CHECK_EQUAL(cache.nevicted(), 0u);
+
+    // Damage the stored file
+    tst::write(cache.path(key), "not an architecture");
+
+    // Check that it counts as a miss and is removed
+    BOOST_CHECK(!cache.fetch(arch2, key));
+    BOOST_CHECK(!std::filesystem::exists(cache.path(key)));
+
+    // Remove the cache
+    std::filesystem::remove_all("testcache");
+
+}
+
+// Test that the least recently used architectures are removed
+BOOST_AUTO_TEST_CASE(cacheEvictsOldArchitectures) {
+
+    // Create parameters for an architecture bigger than a megabyte
+    Parameters pars;
+    pars.rng = rnd::counter;
+    pars.seed = 42u;
+    pars.nlocipertrait = {50000u};
+    pars.nedgespertrait = {100000u};
+    pars.update();
+
+    // Seed the generator
+    rnd::rng.use(pars.rng);
+    rnd::rng.seed(pars.seed);
+
+    // Create a cache of one megabyte
+    Cache cache("testcache", 1u);
+
+    // Store architectures of two replicates
+    Architecture arch;
+    for (size_t k = 0u; k < 2u; ++k) {
+        rnd::rng.replicate(k);
+        arch.generate(pars);
+        cache.store(arch, cache.key(pars, k));
+    }
+
+    // Check that only the last one is left
+    BOOST_CHECK(!std::filesystem::exists(cache.path(cache.key(pars, 0u))));
+    BOOST_CHECK(std::filesystem::exists(cache.path(cache.key(pars, 1u))));
+    BOOST_CHECK_EQUAL(cache.nevicted(), 1u);
+
+    // Remove the cache
+    std::filesystem::remove_all("testcache");
+
+}
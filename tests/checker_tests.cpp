@@ -43,6 +43,17 @@ BOOST_AUTO_TEST_CASE(isStrictPositive) {
 
 }
 
+// Test the zero to two checking function
+BOOST_AUTO_TEST_CASE(isZeroToTwo) {
+
+    // Known values
+    BOOST_CHECK_EQUAL(chk::zerototwo(0u), "");
+    BOOST_CHECK_EQUAL(chk::zerototwo(2u), "");
+    BOOST_CHECK_EQUAL(chk::zerototwo(3u), "must be between 0 and 2");
+    BOOST_CHECK_EQUAL(chk::zerototwo(-1), "must be between 0 and 2");
+
+}
+
 // Test the zero to three checking function
 BOOST_AUTO_TEST_CASE(isZeroToThree) {
 
@@ -55,4 +66,70 @@ BOOST_AUTO_TEST_CASE(isZeroToThree) {
     BOOST_CHECK_EQUAL(chk::zerotothree(5u), "must be between 0 and 3");
     BOOST_CHECK_EQUAL(chk::zerotothree(-1), "must be between 0 and 3");
 
-}
\ No newline at end of file
+}
+
+// Test the zero to four checking function
+BOOST_AUTO_TEST_CASE(isZeroToFour) {
+
+    // Known values
+    BOOST_CHECK_EQUAL(chk::zerotofour(0u), "");
+    BOOST_CHECK_EQUAL(chk::zerotofour(4u), "");
+    BOOST_CHECK_EQUAL(chk::zerotofour(5u), "must be between 0 and 4");
+    BOOST_CHECK_EQUAL(chk::zerotofour(-1), "must be between 0 and 4");
+
+}
+
+// Test the zero to five checking function
+BOOST_AUTO_TEST_CASE(isZeroToFive) {
+
+    // Known values
+    BOOST_CHECK_EQUAL(chk::zerotofive(0u), "");
+    BOOST_CHECK_EQUAL(chk::zerotofive(5u), "");
+    BOOST_CHECK_EQUAL(chk::zerotofive(6u), "must be between 0 and 5");
+    BOOST_CHECK_EQUAL(chk::zerotofive(-1), "must be between 0 and 5");
+
+}
+
+// Test the function checking for at least two
+BOOST_AUTO_TEST_CASE(isAtLeastTwo) {
+
+    // Known values
+    BOOST_CHECK_EQUAL(chk::atleasttwo(2u), "");
+    BOOST_CHECK_EQUAL(chk::atleasttwo(5u), "");
+    BOOST_CHECK_EQUAL(chk::atleasttwo(0u), "must be at least 2");
+    BOOST_CHECK_EQUAL(chk::atleasttwo(1u), "must be at least 2");
+
+}
+
+// Test the ploidy checking function
+BOOST_AUTO_TEST_CASE(isPloidy) {
+
+    // Known values
+    BOOST_CHECK_EQUAL(chk::ploidy(1u), "");
+    BOOST_CHECK_EQUAL(chk::ploidy(2u), "");
+    BOOST_CHECK_EQUAL(chk::ploidy(4u), "");
+    BOOST_CHECK_EQUAL(chk::ploidy(6u), "");
+    BOOST_CHECK_EQUAL(chk::ploidy(0u), "must be 1, 2, 4 or 6");
+    BOOST_CHECK_EQUAL(chk::ploidy(3u), "must be 1, 2, 4 or 6");
+    BOOST_CHECK_EQUAL(chk::ploidy(8u), "must be 1, 2, 4 or 6");
+
+}
+
+// Test that checks run up to the level of validation in use
+BOOST_AUTO_TEST_CASE(validationLevels) {
+
+    // No validation
+    chk::validation = chk::none;
+    BOOST_CHECK(chk::validates(chk::none));
+    BOOST_CHECK(!chk::validates(chk::cheap));
+    BOOST_CHECK(!chk::validates(chk::full));
+
+    // Cheap validation
+    chk::validation = chk::cheap;
+    BOOST_CHECK(chk::validates(chk::cheap) == (ARCHGEN_VALIDATION >= 1));
+    BOOST_CHECK(!chk::validates(chk::full));
+
+    // Restore
+    chk::validation = ARCHGEN_VALIDATION;
+
+}
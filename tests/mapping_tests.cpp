@@ -0,0 +1,89 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the mapping of files into memory.
+
+#include "testutils.hpp"
+#include "../src/mapping.hpp"
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+
+// Test that the contents of a file can be accessed
+BOOST_AUTO_TEST_CASE(fileIsMapped) {
+
+    // Write a file
+    tst::write("mapped.txt", "hello world");
+
+    // Map it
+    Mapping mapping("mapped.txt");
+
+    // Check
+    BOOST_CHECK(mapping.isopen());
+    BOOST_CHECK_EQUAL(mapping.size(), 11u);
+    BOOST_CHECK(std::memcmp(mapping.data(), "hello world", 11u) == 0);
+
+    // Release it
+    mapping.close();
+
+    // Check
+    BOOST_CHECK(!mapping.isopen());
+    BOOST_CHECK_EQUAL(mapping.size(), 0u);
+
+    // Remove file
+    std::remove("mapped.txt");
+
+}
+
+// Test that an empty file can be mapped
+BOOST_AUTO_TEST_CASE(emptyFileIsMapped) {
+
+    // Write an empty file
+    tst::write("mapped.txt", "");
+
+    // Map it
+    Mapping mapping("mapped.txt");
+
+    // Check
+    BOOST_CHECK(mapping.isopen());
+    BOOST_CHECK_EQUAL(mapping.size(), 0u);
+
+    // Remove file
+    std::remove("mapped.txt");
+
+}
+
+// Test that error when the file does not exist
+BOOST_AUTO_TEST_CASE(errorWhenMappingMissingFile) {
+
+    // Check
+    tst::checkError([&]() { Mapping mapping("missing.txt"); }, "Unable to open file missing.txt");
+
+}
+
+// Test that the checksum catches changes
+BOOST_AUTO_TEST_CASE(checksumCatchesChanges) {
+
+    // Some bytes
+    char data[21] = "abcdefghijklmnopqrst";
+
+    // Checksum them
+    const std::uint64_t h = checksum(data, 20u);
+
+    // Check that it does not change if the bytes do not
+    BOOST_CHECK_EQUAL(checksum(data, 20u), h);
+
+    // Check that it changes with the length
+    BOOST_CHECK(checksum(data, 19u) != h);
+
+    // Check that it changes with any byte, including the trailing ones
+    for (size_t i = 0u; i < 20u; ++i) {
+        data[i] ^= 1;
+        BOOST_CHECK(checksum(data, 20u) != h);
+        data[i] ^= 1;
+    }
+
+    // Check that swapping words changes it too
+    std::swap_ranges(data, data + 8u, data + 8u);
+    BOOST_CHECK(checksum(data, 20u) != h);
+
+}
@@ -0,0 +1,115 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the compression of edges into streams of bytes.
+
+#include "testutils.hpp"
+#include "../src/packing.hpp"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <limits>
+
+// Test that edges are decoded as they were added
+BOOST_AUTO_TEST_CASE(edgesArePackedAndUnpacked) {
+
+    // Some edges, in runs from the same start locus, with large jumps
+    const std::uint32_t maximum = std::numeric_limits<std::uint32_t>::max();
+    const std::vector<std::uint32_t> from = {5u, 5u, 5u, 0u, maximum, maximum, 7u, 5u};
+    const std::vector<std::uint32_t> to = {1u, 3u, 2u, maximum, 0u, 1u, 6u, 4u};
+
+    // Pack them
+    std::vector<std::uint8_t> bytes;
+    Packer packer(bytes);
+    packer.add(from.data(), to.data(), from.size());
+
+    // Unpack them, fewer at a time than there are
+    std::vector<std::uint32_t> from2(from.size()), to2(to.size());
+    Unpacker unpacker(bytes.data(), bytes.size());
+    const size_t n = unpacker.next(from2.data(), to2.data(), 5u);
+    const size_t m = unpacker.next(from2.data() + n, to2.data() + n, 5u);
+
+    // Check
+    BOOST_CHECK_EQUAL(n, 5u);
+    BOOST_CHECK_EQUAL(m, 3u);
+    BOOST_CHECK(from2 == from);
+    BOOST_CHECK(to2 == to);
+    BOOST_CHECK(unpacker.done());
+    BOOST_CHECK(!unpacker.failed());
+
+    // Check that nothing is left
+    BOOST_CHECK_EQUAL(unpacker.next(from2.data(), to2.data(), 5u), 0u);
+
+}
+
+// Test that edges can be added a chunk at a time
+BOOST_AUTO_TEST_CASE(edgesArePackedInChunks) {
+
+    // Edges of a small preferential attachment network
+    const std::vector<std::uint32_t> from = {1u, 2u, 2u, 3u, 3u, 3u, 4u, 4u};
+    const std::vector<std::uint32_t> to = {0u, 1u, 0u, 0u, 2u, 1u, 3u, 0u};
+
+    // Pack them in chunks that cut through runs
+    std::vector<std::uint8_t> bytes;
+    Packer packer(bytes);
+    packer.add(from.data(), to.data(), 2u);
+    packer.add(from.data() + 2u, to.data() + 2u, 3u);
+    packer.add(from.data() + 5u, to.data() + 5u, 3u);
+
+    // Check that each run takes three bytes of header and one of differences
+    BOOST_CHECK_EQUAL(bytes.size(), 6u * 4u);
+
+    // Unpack them in one go
+    std::vector<std::uint32_t> from2(10u), to2(10u);
+    Unpacker unpacker(bytes.data(), bytes.size());
+
+    // Check
+    BOOST_CHECK_EQUAL(unpacker.next(from2.data(), to2.data(), 10u), 8u);
+    BOOST_CHECK(std::equal(from.begin(), from.end(), from2.begin()));
+    BOOST_CHECK(std::equal(to.begin(), to.end(), to2.begin()));
+    BOOST_CHECK(unpacker.done());
+
+}
+
+// Test that malformed streams are caught
+BOOST_AUTO_TEST_CASE(malformedStreamsAreCaught) {
+
+    // Room to decode into
+    std::vector<std::uint32_t> from(4u), to(4u);
+
+    // A stream cut in the middle of a run (two differences of eight bits announced, one given)
+    const std::vector<std::uint8_t> cut = {2u, 2u, 8u, 1u};
+    Unpacker unpacker1(cut.data(), cut.size());
+    BOOST_CHECK_EQUAL(unpacker1.next(from.data(), to.data(), 4u), 0u);
+    BOOST_CHECK(unpacker1.failed());
+    BOOST_CHECK(!unpacker1.done());
+
+    // A stream going below locus zero
+    const std::vector<std::uint8_t> negative = {1u, 1u, 0u};
+    Unpacker unpacker2(negative.data(), negative.size());
+    BOOST_CHECK_EQUAL(unpacker2.next(from.data(), to.data(), 4u), 0u);
+    BOOST_CHECK(unpacker2.failed());
+
+    // A stream with an empty run
+    const std::vector<std::uint8_t> empty = {0u, 0u};
+    Unpacker unpacker3(empty.data(), empty.size());
+    BOOST_CHECK_EQUAL(unpacker3.next(from.data(), to.data(), 4u), 0u);
+    BOOST_CHECK(unpacker3.failed());
+
+    // Differences wider than any between two loci
+    const std::vector<std::uint8_t> wide = {0u, 1u, 34u, 0u, 0u, 0u, 0u, 0u};
+    Unpacker unpacker6(wide.data(), wide.size());
+    BOOST_CHECK_EQUAL(unpacker6.next(from.data(), to.data(), 4u), 0u);
+    BOOST_CHECK(unpacker6.failed());
+
+    // A number that never ends
+    const std::vector<std::uint8_t> endless(12u, 0xffu);
+    Unpacker unpacker4(endless.data(), endless.size());
+    BOOST_CHECK_EQUAL(unpacker4.next(from.data(), to.data(), 4u), 0u);
+    BOOST_CHECK(unpacker4.failed());
+
+    // An empty stream is fine
+    Unpacker unpacker5(nullptr, 0u);
+    BOOST_CHECK_EQUAL(unpacker5.next(from.data(), to.data(), 4u), 0u);
+    BOOST_CHECK(unpacker5.done());
+
+}
@@ -27,7 +27,9 @@ BOOST_AUTO_TEST_CASE(readParameters)
 
     // Add lines
     content << "nrepl 1\n";
+    content << "replicates 1\n";
     content << "popsize 10\n";
+    content << "ploidy 2\n";
     content << "ntraits 3\n";
     content << "mutation 0.1\n";
     content << "sdeffects 0.5\n";
@@ -35,17 +37,44 @@ BOOST_AUTO_TEST_CASE(readParameters)
     content << "sdweights 0.3\n";
     content << "nlocipertrait 5 10 15\n";
     content << "nedgespertrait 0 0 0\n";
+    content << "nhyperpertrait 0 4 2\n";
+    content << "hyperorder 4\n";
     content << "skew 0.5 1.0 1.5\n";
     content << "epistasis 0.1 0.2 0.3\n";
     content << "dominance 0.4 0.5 0.6\n";
     content << "envnoise 0.7 0.8 0.9\n";
+    content << "network 3\n";
+    content << "nblocks 4\n";
+    content << "crossblocks 0.2\n";
+    content << "pleiotropy 0.3\n";
+    content << "pleiocorr 0.8\n";
     content << "sampling 2\n";
     content << "ratio 0.25\n";
+    content << "spectrum 1\n";
+    content << "shapes 0.5 2\n";
+    content << "minfreq 0.05\n";
+    content << "nfounders 20\n";
+    content << "switchrate 0.1\n";
+    content << "ndemes 2\n";
+    content << "demesizes 4 6\n";
+    content << "fst 0.1\n";
+    content << "ngenerations 5\n";
+    content << "recombination 0.2\n";
+    content << "lastonly 0\n";
     content << "seed 12345\n";
+    content << "rng 1\n";
+    content << "nthreads 4\n";
+    content << "validation 1\n";
     content << "import 0\n";
     content << "standard 0\n";
     content << "loadarch 1\n";
     content << "savearch 0\n";
+    content << "binarch 1\n";
+    content << "streamarch 0\n";
+    content << "packedges 1\n";
+    content << "patcharch 1\n";
+    content << "archcache 0\n";
+    content << "cachesize 10\n";
     content << "savepars 1\n";
     content << "binary 1\n";
     content << "verbose 0\n";
@@ -58,7 +87,10 @@ BOOST_AUTO_TEST_CASE(readParameters)
 
     // Check that the parameters have been updated
     BOOST_CHECK_EQUAL(pars.nrepl, 1u);
+    BOOST_CHECK_EQUAL(pars.replicates.size(), 1u);
+    BOOST_CHECK_EQUAL(pars.replicates[0], 1u);
     BOOST_CHECK_EQUAL(pars.popsize, 10u);
+    BOOST_CHECK_EQUAL(pars.ploidy, 2u);
     BOOST_CHECK_EQUAL(pars.ntraits, 3u);
     BOOST_CHECK_EQUAL(pars.mutation, 0.1);
     BOOST_CHECK_EQUAL(pars.sdeffects, 0.5);
@@ -70,6 +102,11 @@ BOOST_AUTO_TEST_CASE(readParameters)
     BOOST_CHECK_EQUAL(pars.nedgespertrait[0], 0u);
     BOOST_CHECK_EQUAL(pars.nedgespertrait[1], 0u);
     BOOST_CHECK_EQUAL(pars.nedgespertrait[2], 0u);
+    BOOST_CHECK_EQUAL(pars.nhyperpertrait[0], 0u);
+    BOOST_CHECK_EQUAL(pars.nhyperpertrait[1], 4u);
+    BOOST_CHECK_EQUAL(pars.nhyperpertrait[2], 2u);
+    BOOST_CHECK_EQUAL(pars.hyperorder, 4u);
+    BOOST_CHECK_EQUAL(pars.nhyper, 6u);
     BOOST_CHECK_EQUAL(pars.skew[0], 0.5);
     BOOST_CHECK_EQUAL(pars.skew[1], 1.0);
     BOOST_CHECK_EQUAL(pars.skew[2], 1.5);
@@ -82,13 +119,40 @@ BOOST_AUTO_TEST_CASE(readParameters)
     BOOST_CHECK_EQUAL(pars.envnoise[0], 0.7);
     BOOST_CHECK_EQUAL(pars.envnoise[1], 0.8);
     BOOST_CHECK_EQUAL(pars.envnoise[2], 0.9);
+    BOOST_CHECK_EQUAL(pars.network, 3u);
+    BOOST_CHECK_EQUAL(pars.nblocks, 4u);
+    BOOST_CHECK_EQUAL(pars.crossblocks, 0.2);
+    BOOST_CHECK_EQUAL(pars.pleiotropy, 0.3);
+    BOOST_CHECK_EQUAL(pars.pleiocorr, 0.8);
     BOOST_CHECK_EQUAL(pars.sampling, 2u);
     BOOST_CHECK_EQUAL(pars.ratio, 0.25);
+    BOOST_CHECK_EQUAL(pars.spectrum, 1u);
+    BOOST_CHECK_EQUAL(pars.shapes[0], 0.5);
+    BOOST_CHECK_EQUAL(pars.shapes[1], 2.0);
+    BOOST_CHECK_EQUAL(pars.minfreq, 0.05);
+    BOOST_CHECK_EQUAL(pars.nfounders, 20u);
+    BOOST_CHECK_EQUAL(pars.switchrate, 0.1);
+    BOOST_CHECK_EQUAL(pars.ndemes, 2u);
+    BOOST_CHECK_EQUAL(pars.demesizes[0], 4u);
+    BOOST_CHECK_EQUAL(pars.demesizes[1], 6u);
+    BOOST_CHECK_EQUAL(pars.fst, 0.1);
+    BOOST_CHECK_EQUAL(pars.ngenerations, 5u);
+    BOOST_CHECK_EQUAL(pars.recombination, 0.2);
+    BOOST_CHECK(!pars.lastonly);
     BOOST_CHECK_EQUAL(pars.seed, 12345u);
+    BOOST_CHECK_EQUAL(pars.rng, 1u);
+    BOOST_CHECK_EQUAL(pars.nthreads, 4u);
+    BOOST_CHECK_EQUAL(pars.validation, 1u);
     BOOST_CHECK(!pars.import);
     BOOST_CHECK(!pars.standard);
     BOOST_CHECK(pars.loadarch);
     BOOST_CHECK(!pars.savearch);
+    BOOST_CHECK(pars.binarch);
+    BOOST_CHECK(!pars.streamarch);
+    BOOST_CHECK(pars.packedges);
+    BOOST_CHECK(pars.patcharch);
+    BOOST_CHECK(!pars.archcache);
+    BOOST_CHECK_EQUAL(pars.cachesize, 10u);
     BOOST_CHECK(pars.savepars);
     BOOST_CHECK(pars.binary);
     BOOST_CHECK(!pars.verbose);
@@ -136,6 +200,60 @@ BOOST_AUTO_TEST_CASE(readInvalidNRepl)
 
 }
 
+// Test that replicates to run can be given as lists and ranges
+BOOST_AUTO_TEST_CASE(readReplicateRanges)
+{
+
+    // Write a file with a mix of single replicates and ranges
+    tst::write("parameters.txt", "nrepl 10000\nreplicates 9008-9010 2 9000-9002 2\n");
+
+    // Read the parameter file
+    Parameters pars("parameters.txt");
+
+    // Check that the replicates are sorted and unique
+    const std::vector<size_t> expected = {2u, 9000u, 9001u, 9002u, 9008u, 9009u, 9010u};
+    BOOST_CHECK_EQUAL_COLLECTIONS(pars.replicates.begin(), pars.replicates.end(), expected.begin(), expected.end());
+
+    // Save them and read them back
+    pars.save("paramlog.txt");
+    Parameters saved("paramlog.txt");
+
+    // Check that nothing was lost
+    BOOST_CHECK_EQUAL_COLLECTIONS(saved.replicates.begin(), saved.replicates.end(), expected.begin(), expected.end());
+
+    // Remove files
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+
+}
+
+// Test error upon invalid replicates to run
+BOOST_AUTO_TEST_CASE(readInvalidReplicates)
+{
+
+    // Write files with invalid replicates
+    tst::write("p1.txt", "nrepl 10\nreplicates 0\n");
+    tst::write("p2.txt", "nrepl 10\nreplicates 5-3\n");
+    tst::write("p3.txt", "nrepl 10\nreplicates 2-\n");
+    tst::write("p4.txt", "nrepl 10\nreplicates 8-11\n");
+    tst::write("p5.txt", "nrepl 10\nreplicates 1-1000000000000\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter replicates must be strictly positive in line 2 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Invalid value type for parameter replicates in line 2 of file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Invalid value type for parameter replicates in line 2 of file p3.txt");
+    tst::checkError([&]() { Parameters pars("p4.txt"); }, "Replicate 11 is out of bounds in file p4.txt");
+    tst::checkError([&]() { Parameters pars("p5.txt"); }, "Replicate 1000000000000 is out of bounds in file p5.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+    std::remove("p4.txt");
+    std::remove("p5.txt");
+
+}
+
 // Test error upon invalid starting population size
 BOOST_AUTO_TEST_CASE(readInvalidPopSize)
 {
@@ -280,6 +398,34 @@ BOOST_AUTO_TEST_CASE(readInvalidNEdgesPerTrait)
 
 }
 
+// Test error upon invalid hyperedge parameters
+BOOST_AUTO_TEST_CASE(readInvalidHyperedges)
+{
+
+    // Write files with invalid hyperedge parameters
+    tst::write("p1.txt", "ntraits 3\nnhyperpertrait 1 2 3 4\n");
+    tst::write("p2.txt", "hyperorder 1\n");
+    tst::write("p3.txt", "ntraits 3\nnlocipertrait 4 4 4\nnhyperpertrait 0 5 0\nskew 1 1 1\nepistasis 1 1 1\ndominance 1 1 1\nenvnoise 1 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter nhyperpertrait in line 2 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter hyperorder must be at least 2 in line 1 of file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Too many hyperedges for the number of loci for trait 2 in file p3.txt");
+
+    // Check that hyperedges are optional even with several traits
+    tst::write("p4.txt", "ntraits 2\nnlocipertrait 4 4\nnedgespertrait 0 0\nskew 1 1\nepistasis 1 1\ndominance 1 1\nenvnoise 1 1\n");
+    Parameters pars("p4.txt");
+    BOOST_CHECK_EQUAL(pars.nhyperpertrait.size(), 2u);
+    BOOST_CHECK_EQUAL(pars.nhyper, 0u);
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+    std::remove("p4.txt");
+
+}
+
 // Test error upon invalid skew parameter
 BOOST_AUTO_TEST_CASE(readInvalidSkew)
 {
@@ -352,17 +498,56 @@ BOOST_AUTO_TEST_CASE(readInvalidEnvNoise)
 
 }
 
+// Test error upon invalid network parameters
+BOOST_AUTO_TEST_CASE(readInvalidNetwork)
+{
+
+    // Write files with invalid network parameters
+    tst::write("p1.txt", "network 4\n");
+    tst::write("p2.txt", "nblocks 0\n");
+    tst::write("p3.txt", "crossblocks 1.5\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter network must be between 0 and 3 in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter nblocks must be strictly positive in line 1 of file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Parameter crossblocks must be between 0 and 1 in line 1 of file p3.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+
+}
+
+// Test error upon invalid pleiotropy parameters
+BOOST_AUTO_TEST_CASE(readInvalidPleiotropy)
+{
+
+    // Write files with invalid pleiotropy parameters
+    tst::write("p1.txt", "pleiotropy 1.5\n");
+    tst::write("p2.txt", "pleiocorr -0.5\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter pleiotropy must be between 0 and 1 in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter pleiocorr must be between 0 and 1 in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
 // Test error upon invalid sampling mode
 BOOST_AUTO_TEST_CASE(readInvalidSampling)
 {
 
     // Write a file with invalid sampling mode
     tst::write("p1.txt", "sampling 1 1\n");
-    tst::write("p2.txt", "sampling 4\n");
+    tst::write("p2.txt", "sampling 6\n");
 
     // Check
     tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter sampling in line 1 of file p1.txt");
-    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter sampling must be between 0 and 3 in line 1 of file p2.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter sampling must be between 0 and 5 in line 1 of file p2.txt");
 
     // Remove files
     std::remove("p1.txt");
@@ -391,6 +576,177 @@ BOOST_AUTO_TEST_CASE(readInvalidRatio)
 
 }
 
+// Test error upon invalid frequency spectrum
+BOOST_AUTO_TEST_CASE(readInvalidSpectrum)
+{
+
+    // Write a file with invalid frequency spectrum
+    tst::write("p1.txt", "spectrum 1 1\n");
+    tst::write("p2.txt", "spectrum 4\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too many values for parameter spectrum in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter spectrum must be between 0 and 3 in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid beta shape parameters
+BOOST_AUTO_TEST_CASE(readInvalidShapes)
+{
+
+    // Write a file with invalid shape parameters
+    tst::write("p1.txt", "shapes 1\n");
+    tst::write("p2.txt", "shapes 1 0\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Too few values for parameter shapes in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter shapes must be strictly positive in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid lowest frequency of the neutral spectrum
+BOOST_AUTO_TEST_CASE(readInvalidMinFreq)
+{
+
+    // Write a file with invalid lowest frequency
+    tst::write("p1.txt", "minfreq 0\n");
+    tst::write("p2.txt", "minfreq 0.5\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter minfreq must be strictly positive in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter minfreq must be smaller than 0.5 in file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid number of founders
+BOOST_AUTO_TEST_CASE(readInvalidNFounders)
+{
+
+    // Write a file with invalid number of founders
+    tst::write("p1.txt", "nfounders 0\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter nfounders must be strictly positive in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid founder switching rate
+BOOST_AUTO_TEST_CASE(readInvalidSwitchRate)
+{
+
+    // Write a file with invalid switching rate
+    tst::write("p1.txt", "switchrate 1.5\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter switchrate must be between 0 and 1 in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test that the population is split evenly between demes by default
+BOOST_AUTO_TEST_CASE(readDefaultDemeSizes)
+{
+
+    // Write a file with demes but no sizes
+    tst::write("parameters.txt", "popsize 10\nndemes 3\n");
+
+    // Read the parameter file
+    Parameters pars("parameters.txt");
+
+    // Check
+    BOOST_CHECK_EQUAL(pars.demesizes.size(), 3u);
+    BOOST_CHECK_EQUAL(pars.demesizes[0], 4u);
+    BOOST_CHECK_EQUAL(pars.demesizes[1], 3u);
+    BOOST_CHECK_EQUAL(pars.demesizes[2], 3u);
+
+    // Remove files
+    std::remove("parameters.txt");
+
+}
+
+// Test error upon invalid demes
+BOOST_AUTO_TEST_CASE(readInvalidDemes)
+{
+
+    // Write files with invalid demes
+    tst::write("p1.txt", "ndemes 0\n");
+    tst::write("p2.txt", "popsize 3\nndemes 4\n");
+    tst::write("p3.txt", "popsize 10\nndemes 2\ndemesizes 3 4\n");
+    tst::write("p4.txt", "popsize 10\nndemes 2\ndemesizes 3 4 3\n");
+    tst::write("p5.txt", "fst 1.5\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter ndemes must be strictly positive in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter ndemes must not exceed popsize in file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Deme sizes must add up to popsize in file p3.txt");
+    tst::checkError([&]() { Parameters pars("p4.txt"); }, "Too many values for parameter demesizes in line 3 of file p4.txt");
+    tst::checkError([&]() { Parameters pars("p5.txt"); }, "Parameter fst must be between 0 and 1 in line 1 of file p5.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+    std::remove("p4.txt");
+    std::remove("p5.txt");
+
+}
+
+// Test error upon invalid reproduction parameters
+BOOST_AUTO_TEST_CASE(readInvalidReproduction)
+{
+
+    // Write files with invalid reproduction parameters
+    tst::write("p1.txt", "ngenerations -1\n");
+    tst::write("p2.txt", "recombination 2\n");
+    tst::write("p3.txt", "lastonly 2\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter ngenerations in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter recombination must be between 0 and 1 in line 1 of file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Invalid value type for parameter lastonly in line 1 of file p3.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+
+}
+
+// Test error upon invalid ploidy
+BOOST_AUTO_TEST_CASE(readInvalidPloidy)
+{
+
+    // Write files with invalid ploidy
+    tst::write("p1.txt", "ploidy 3\n");
+    tst::write("p2.txt", "ploidy 4\nngenerations 2\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter ploidy must be 1, 2, 4 or 6 in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Reproduction is only available for diploids in file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
 // Test error upon invalid random seed
 BOOST_AUTO_TEST_CASE(readInvalidSeed)
 {
@@ -409,6 +765,24 @@ BOOST_AUTO_TEST_CASE(readInvalidSeed)
 
 }
 
+// Test error upon invalid random number engine
+BOOST_AUTO_TEST_CASE(readInvalidRng)
+{
+
+    // Write a file with invalid engine
+    tst::write("p1.txt", "rng 4\n");
+    tst::write("p2.txt", "rng 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter rng must be between 0 and 3 in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Too many values for parameter rng in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
 // Test error upon invalid import flag
 BOOST_AUTO_TEST_CASE(readInvalidImport)
 {
@@ -481,6 +855,99 @@ BOOST_AUTO_TEST_CASE(readInvalidSaveArch)
 
 }
 
+// Test error upon invalid binary architecture flag
+BOOST_AUTO_TEST_CASE(readInvalidBinArch)
+{
+
+    // Write a file with invalid binary architecture flag
+    tst::write("p1.txt", "binarch 2\n");
+    tst::write("p2.txt", "binarch 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter binarch in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Too many values for parameter binarch in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid architecture streaming flag
+BOOST_AUTO_TEST_CASE(readInvalidStreamArch)
+{
+
+    // Write files with invalid streaming flags or combinations
+    tst::write("p1.txt", "streamarch 2\n");
+    tst::write("p2.txt", "streamarch 1\nloadarch 1\n");
+    tst::write("p3.txt", "streamarch 1\narchcache 1\nrng 3\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter streamarch in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter streamarch cannot be used with loadarch in file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Parameter streamarch cannot be used with archcache in file p3.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+
+}
+
+// Test error upon invalid packed edges flag
+BOOST_AUTO_TEST_CASE(readInvalidPackEdges)
+{
+
+    // Write a file with invalid packed edges flag
+    tst::write("p1.txt", "packedges 2\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter packedges in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid architecture patching flag
+BOOST_AUTO_TEST_CASE(readInvalidPatchArch)
+{
+
+    // Write files with an invalid patching flag or without an architecture to patch
+    tst::write("p1.txt", "patcharch 2\n");
+    tst::write("p2.txt", "patcharch 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter patcharch in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter patcharch requires loadarch in file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
+
+// Test error upon invalid architecture cache parameters
+BOOST_AUTO_TEST_CASE(readInvalidArchCache)
+{
+
+    // Write files with invalid cache parameters
+    tst::write("p1.txt", "archcache 2\n");
+    tst::write("p2.txt", "cachesize 0\n");
+    tst::write("p3.txt", "archcache 1\nrng 0\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter archcache in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Parameter cachesize must be strictly positive in line 1 of file p2.txt");
+    tst::checkError([&]() { Parameters pars("p3.txt"); }, "Parameter archcache requires the counter-based engine (rng 3) in file p3.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+    std::remove("p3.txt");
+
+}
+
 // Test error upon invalid parameters saving flag
 BOOST_AUTO_TEST_CASE(readInvalidSavePars)
 {
@@ -602,4 +1069,37 @@ BOOST_AUTO_TEST_CASE(errorWhenSavingParameters) {
 
     }, "Unable to open file ");
 
-}
\ No newline at end of file
+}
+
+// Test error upon invalid number of threads
+BOOST_AUTO_TEST_CASE(readInvalidNThreads)
+{
+
+    // Write a file with an invalid number of threads
+    tst::write("p1.txt", "nthreads -1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Invalid value type for parameter nthreads in line 1 of file p1.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+
+}
+
+// Test error upon invalid validation level
+BOOST_AUTO_TEST_CASE(readInvalidValidation)
+{
+
+    // Write files with an invalid validation level
+    tst::write("p1.txt", "validation 3\n");
+    tst::write("p2.txt", "validation 1 1\n");
+
+    // Check
+    tst::checkError([&]() { Parameters pars("p1.txt"); }, "Parameter validation must be between 0 and 2 in line 1 of file p1.txt");
+    tst::checkError([&]() { Parameters pars("p2.txt"); }, "Too many values for parameter validation in line 1 of file p2.txt");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
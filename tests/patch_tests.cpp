@@ -0,0 +1,145 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the proper behavior of the Patch class.
+
+#include "testutils.hpp"
+#include "../src/patch.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that an empty patch can be created
+BOOST_AUTO_TEST_CASE(patchCreated) {
+
+    // Without input file should work fine
+    Patch patch;
+
+    // Check that it changes nothing
+    BOOST_CHECK_EQUAL(patch.nloci, 0u);
+    BOOST_CHECK_EQUAL(patch.nedges, 0u);
+
+}
+
+// Test that a patch can be read from a file
+BOOST_AUTO_TEST_CASE(readPatch) {
+
+    // Write a file with a patch
+    std::ostringstream content;
+    content << "nloci 2\n";
+    content << "loci 4 2\n";
+    content << "effects 0.1 -0.2\n";
+    content << "nedges 1\n";
+    content << "edges 3\n";
+    content << "weights 0.5\n";
+    tst::write("patch.txt", content.str());
+
+    // Read the patch
+    Patch patch("patch.txt");
+
+    // Check that indices are zero-based and that dominance is left as it is
+    BOOST_CHECK_EQUAL(patch.nloci, 2u);
+    BOOST_CHECK_EQUAL(patch.nedges, 1u);
+    BOOST_CHECK_EQUAL(patch.loci[0u], 3u);
+    BOOST_CHECK_EQUAL(patch.loci[1u], 1u);
+    BOOST_CHECK_CLOSE(patch.effects[0u], Architecture::Effect(0.1), 1e-6);
+    BOOST_CHECK_CLOSE(patch.effects[1u], Architecture::Effect(-0.2), 1e-6);
+    BOOST_CHECK(patch.domcoeffs.empty());
+    BOOST_CHECK_EQUAL(patch.edges[0u], 2u);
+    BOOST_CHECK_CLOSE(patch.weights[0u], Architecture::Effect(0.5), 1e-6);
+
+    // Remove file
+    std::remove("patch.txt");
+
+}
+
+// Test that patch reading fails when the file is invalid
+BOOST_AUTO_TEST_CASE(readInvalidPatch) {
+
+    // Write files with invalid patches
+    tst::write("p1.txt", "nloci 2\neffects 0.1 0.2\n");
+    tst::write("p2.txt", "nloci 2\nloci 1 2\neffects 0.1\n");
+    tst::write("p3.txt", "nloci 1\nloci 1\ndomcoeffs 0.1\nnloci 2\nloci 1 2\n");
+    tst::write("p4.txt", "nedges 2\nweights 0.1 0.2\n");
+    tst::write("p5.txt", "nedges 1\nedges 1\n");
+    tst::write("p6.txt", "nloci 2\nloci 1 1\n");
+    tst::write("p7.txt", "nedges 2\nedges 2 2\nweights 0.1 0.2\n");
+    tst::write("p8.txt", "nloci 1\nloci 0\n");
+    tst::write("p9.txt", "nloci 1\nfrom 1\n");
+
+    // Check
+    tst::checkError([&]() { Patch patch("p1.txt"); }, "Number of patched loci does not match nloci in file p1.txt");
+    tst::checkError([&]() { Patch patch("p2.txt"); }, "Too few values for parameter effects in line 3 of file p2.txt");
+    tst::checkError([&]() { Patch patch("p3.txt"); }, "Number of dominance effects does not match number of patched loci in file p3.txt");
+    tst::checkError([&]() { Patch patch("p4.txt"); }, "Number of patched edges does not match nedges in file p4.txt");
+    tst::checkError([&]() { Patch patch("p5.txt"); }, "Number of interaction weights does not match number of patched edges in file p5.txt");
+    tst::checkError([&]() { Patch patch("p6.txt"); }, "Some loci are patched more than once in file p6.txt");
+    tst::checkError([&]() { Patch patch("p7.txt"); }, "Some edges are patched more than once in file p7.txt");
+    tst::checkError([&]() { Patch patch("p8.txt"); }, "Parameter loci must be strictly positive in line 2 of file p8.txt");
+    tst::checkError([&]() { Patch patch("p9.txt"); }, "Invalid parameter: from in line 2 of file p9.txt");
+
+    // Remove files
+    for (size_t i = 1u; i <= 9u; ++i) std::remove(("p" + std::to_string(i) + ".txt").c_str());
+
+}
+
+// Test that a patch is applied to an architecture
+BOOST_AUTO_TEST_CASE(applyPatch) {
+
+    // Write a file with an architecture
+    std::ostringstream content;
+    content << "nloci 4\n";
+    content << "nedges 2\n";
+    content << "ntraits 1\n";
+    content << "traitids 1 1 1 1\n";
+    content << "effects 0.1 0.2 0.3 0.4\n";
+    content << "domcoeffs 0.01 0.02 0.03 0.04\n";
+    content << "from 1 3\n";
+    content << "to 2 4\n";
+    content << "weights 0.5 0.6\n";
+    tst::write("architecture.txt", content.str());
+
+    // Write a patch touching one locus and one edge
+    tst::write("patch.txt", "nloci 1\nloci 3\ndomcoeffs 0.9\nnedges 1\nedges 2\nweights -0.6\n");
+
+    // Read both
+    Architecture arch("architecture.txt");
+    const Patch patch("patch.txt");
+
+    // Apply the patch
+    patch.apply(arch);
+
+    // Check that only the patched values have changed
+    BOOST_CHECK_CLOSE(arch.effects[2u], Architecture::Effect(0.3), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[1u], Architecture::Effect(0.02), 1e-6);
+    BOOST_CHECK_CLOSE(arch.domcoeffs[2u], Architecture::Effect(0.9), 1e-6);
+    BOOST_CHECK_CLOSE(arch.weights[0u], Architecture::Effect(0.5), 1e-6);
+    BOOST_CHECK_CLOSE(arch.weights[1u], Architecture::Effect(-0.6), 1e-6);
+
+    // Remove files
+    std::remove("architecture.txt");
+    std::remove("patch.txt");
+
+}
+
+// Test that a patch must fit the architecture
+BOOST_AUTO_TEST_CASE(errorWhenPatchOutOfBounds) {
+
+    // Default architecture (ten loci, no edges)
+    Architecture arch;
+
+    // Write patches going beyond it
+    tst::write("p1.txt", "nloci 1\nloci 11\neffects 0.1\n");
+    tst::write("p2.txt", "nedges 1\nedges 1\nweights 0.1\n");
+
+    // Read them
+    const Patch patch1("p1.txt");
+    const Patch patch2("p2.txt");
+
+    // Check
+    tst::checkError([&]() { patch1.apply(arch); }, "Patched locus 11 is out of bounds of the architecture");
+    tst::checkError([&]() { patch2.apply(arch); }, "Patched edge 1 is out of bounds of the architecture");
+
+    // Remove files
+    std::remove("p1.txt");
+    std::remove("p2.txt");
+
+}
@@ -0,0 +1,221 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the random number engines.
+
+#include "testutils.hpp"
+#include "../src/random.hpp"
+#include <boost/test/unit_test.hpp>
+#include <bit>
+
+// Test that the default engine reproduces the standard Mersenne Twister
+BOOST_AUTO_TEST_CASE(defaultEngineIsMersenneTwister) {
+
+    // Create engines with the same seed
+    std::mt19937_64 reference(42u);
+    rnd::Generator generator;
+    generator.seed(42u);
+
+    // Check the engine in use
+    BOOST_CHECK_EQUAL(generator.engine(), rnd::mersenne);
+
+    // Check that raw draws match
+    bool iswrong = false;
+    for (size_t i = 0u; i < 1000u; ++i) {
+        if (reference() != generator()) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Check that distributions match too
+    rnd::normal getnormal(0.0, 1.0);
+    BOOST_CHECK_EQUAL(getnormal(reference), rnd::normal(0.0, 1.0)(generator));
+
+}
+
+// Test that the Xoshiro256++ engine is reproducible
+BOOST_AUTO_TEST_CASE(xoshiroIsReproducible) {
+
+    // Create two engines with the same seed
+    rnd::Xoshiro a(1u);
+    rnd::Xoshiro b(1u);
+
+    // Check that they are reproducible
+    BOOST_CHECK_EQUAL(a(), b());
+
+    // Check that different seeds give different streams
+    rnd::Xoshiro c(2u);
+    BOOST_CHECK(a() != c());
+
+}
+
+// Test that every engine can be chosen and seeded
+BOOST_AUTO_TEST_CASE(generatorEnginesAreReproducible) {
+
+    // For each engine...
+    for (size_t type : {rnd::mersenne, rnd::xoshiro, rnd::pcg, rnd::counter}) {
+
+        // Create two generators on that engine
+        rnd::Generator a, b;
+        a.use(type);
+        b.use(type);
+
+        // Seed them identically
+        a.seed(123u);
+        b.seed(123u);
+
+        // Check that they produce the same stream
+        bool iswrong = false;
+        for (size_t i = 0u; i < 100u; ++i) {
+            if (a() != b()) {
+                iswrong = true;
+                break;
+            }
+        }
+        BOOST_CHECK(!iswrong);
+
+        // Check that a uniform sample is in range
+        const double x = rnd::uniform(0.0, 1.0)(a);
+        BOOST_CHECK(x >= 0.0 && x < 1.0);
+
+    }
+
+    // Check that engines produce different streams
+    rnd::Generator a, b;
+    a.use(rnd::xoshiro);
+    b.use(rnd::pcg);
+    a.seed(123u);
+    b.seed(123u);
+    BOOST_CHECK(a() != b());
+
+}
+
+// Test that the engines produce balanced bits
+BOOST_AUTO_TEST_CASE(enginesProduceBalancedBits) {
+
+    // Create engines
+    rnd::Xoshiro xo(7u);
+    rnd::PCG pc(7u);
+
+    // Count set bits
+    size_t nxo = 0u, npc = 0u;
+    for (size_t i = 0u; i < 10000u; ++i) {
+        nxo += std::popcount(xo());
+        npc += std::popcount(pc());
+    }
+
+    // Check that about half of the bits are set
+    BOOST_CHECK_CLOSE(nxo / 640000.0, 0.5, 1.0);
+    BOOST_CHECK_CLOSE(npc / 640000.0, 0.5, 1.0);
+
+}
+
+// Test the word-parallel Bernoulli sampler
+BOOST_AUTO_TEST_CASE(maskHasRightDensity) {
+
+    // Create an engine
+    rnd::Xoshiro engine(3u);
+
+    // Check trivial cases
+    BOOST_CHECK_EQUAL(rnd::mask(0.0, engine), 0u);
+    BOOST_CHECK_EQUAL(rnd::mask(1.0, engine), ~std::uint64_t(0u));
+
+    // Count set bits for an intermediate probability
+    size_t count = 0u;
+    for (size_t i = 0u; i < 10000u; ++i)
+        count += std::popcount(rnd::mask(0.3, engine));
+
+    // Check that the density is right
+    BOOST_CHECK_CLOSE(count / 640000.0, 0.3, 2.0);
+
+}
+
+// Test the Philox block cipher against known answers
+BOOST_AUTO_TEST_CASE(philoxKnownAnswers) {
+
+    // Encrypt a zero counter with a zero key
+    const std::array<std::uint32_t, 4u> a = rnd::Philox::encrypt({0u, 0u, 0u, 0u}, {0u, 0u});
+
+    // Check against the reference implementation
+    BOOST_CHECK_EQUAL(a[0u], 0x6627E8D5u);
+    BOOST_CHECK_EQUAL(a[1u], 0xE169C58Du);
+    BOOST_CHECK_EQUAL(a[2u], 0xBC57AC4Cu);
+    BOOST_CHECK_EQUAL(a[3u], 0x9B00DBD8u);
+
+    // Encrypt a full counter with a full key
+    const std::uint32_t f = 0xFFFFFFFFu;
+    const std::array<std::uint32_t, 4u> b = rnd::Philox::encrypt({f, f, f, f}, {f, f});
+
+    // Check against the reference implementation
+    BOOST_CHECK_EQUAL(b[0u], 0x408F276Du);
+    BOOST_CHECK_EQUAL(b[1u], 0x41C83B0Eu);
+    BOOST_CHECK_EQUAL(b[2u], 0xA20BC7C6u);
+    BOOST_CHECK_EQUAL(b[3u], 0x6D5451FDu);
+
+}
+
+// Test the Xoshiro256++ engine against known answers
+BOOST_AUTO_TEST_CASE(xoshiroKnownAnswers) {
+
+    // Create an engine (seeded with four SplitMix64 draws from 42)
+    rnd::Xoshiro engine(42u);
+
+    // Check against the reference implementation from that state
+    BOOST_CHECK_EQUAL(engine(), 15021278609987233951ull);
+    BOOST_CHECK_EQUAL(engine(), 5881210131331364753ull);
+    BOOST_CHECK_EQUAL(engine(), 18149643915985481100ull);
+    BOOST_CHECK_EQUAL(engine(), 12933668939759105464ull);
+
+}
+
+// Test the PCG64 engine against known answers
+BOOST_AUTO_TEST_CASE(pcgKnownAnswers) {
+
+    // Create an engine (initial state made of two SplitMix64 draws from 42)
+    rnd::PCG engine(42u);
+
+    // Check against the reference implementation from that state
+    BOOST_CHECK_EQUAL(engine(), 6135875595006329374ull);
+    BOOST_CHECK_EQUAL(engine(), 484393157099699209ull);
+    BOOST_CHECK_EQUAL(engine(), 4475232972869320982ull);
+    BOOST_CHECK_EQUAL(engine(), 2330525485766848842ull);
+
+}
+
+// Test that counter-based streams do not depend on the order of use
+BOOST_AUTO_TEST_CASE(counterStreamsAreOrderIndependent) {
+
+    // Create a counter-based generator
+    rnd::Generator generator;
+    generator.use(rnd::counter);
+    generator.seed(99u);
+
+    // Draw from the stream of one position
+    rnd::Stream s1 = generator.stream(rnd::mutation, 5u);
+    const std::uint64_t x1 = s1();
+
+    // Draw from other streams and from the sequential stream
+    rnd::Stream other = generator.stream(rnd::mutation, 4u);
+    other();
+    generator();
+
+    // Check that the stream of the same position gives the same draw
+    rnd::Stream s2 = generator.stream(rnd::mutation, 5u);
+    BOOST_CHECK_EQUAL(s2(), x1);
+
+    // Check that positions, phases and replicates have different streams
+    BOOST_CHECK(generator.stream(rnd::mutation, 6u)() != x1);
+    BOOST_CHECK(generator.stream(rnd::noise, 5u)() != x1);
+    generator.replicate(1u);
+    BOOST_CHECK(generator.stream(rnd::mutation, 5u)() != x1);
+
+    // Check that sequential engines share one stream across positions
+    rnd::Generator sequential;
+    sequential.seed(99u);
+    rnd::Stream t1 = sequential.stream(rnd::mutation, 5u);
+    rnd::Stream t2 = sequential.stream(rnd::mutation, 5u);
+    BOOST_CHECK(t1() != t2());
+
+}
@@ -5,6 +5,7 @@
 
 #include "testutils.hpp"
 #include "../src/readpars.hpp"
+#include <cstdint>
 #include <boost/test/unit_test.hpp>
 
 // Test that a reader initializes properly
@@ -443,6 +444,118 @@ BOOST_AUTO_TEST_CASE(readerReadVector) {
 
 }
 
+// Test that lines longer than the read buffer are read in full
+BOOST_AUTO_TEST_CASE(readerReadLongLine) {
+
+    // Write a parameter file with a line of several hundred kilobytes
+    const size_t n = 100000u;
+    std::ostringstream content;
+    content << "from";
+    for (size_t i = 0u; i < n; ++i) content << ' ' << i;
+    content << "\npopsize 10";
+    tst::write("parameters.txt", content.str());
+
+    // Create a reader
+    ReadPars reader("parameters.txt");
+
+    // Open the file
+    reader.open();
+
+    // Read the first line
+    reader.readline();
+
+    // Read the values
+    std::vector<size_t> from;
+    reader.readvalues(from, n);
+
+    // Check that none was cut across loads of the buffer
+    bool iswrong = false;
+    for (size_t i = 0u; i < n; ++i) iswrong |= from[i] != i;
+    BOOST_CHECK(!iswrong);
+
+    // Check that the next line is read as usual
+    BOOST_CHECK(!reader.iseof());
+    reader.readline();
+    BOOST_CHECK_EQUAL(reader.getname(), "popsize");
+    BOOST_CHECK_EQUAL(reader.getcount(), 2u);
+
+    // Close the file
+    reader.close();
+
+    // Remove the file
+    std::remove("parameters.txt");
+
+}
+
+// Test that a word too long for the read buffer is caught
+BOOST_AUTO_TEST_CASE(readerErrorWordTooLong) {
+
+    // Write a parameter file with a never-ending number
+    tst::write("parameters.txt", "nloci " + std::string(100000u, '1'));
+
+    // Create a reader
+    ReadPars reader("parameters.txt");
+
+    // Open the file
+    reader.open();
+
+    // Read the first line
+    reader.readline();
+
+    // Check that it throws an error
+    size_t nloci;
+    tst::checkError([&]() { reader.readvalue(nloci); }, "Could not read value for parameter nloci in line 1 of file parameters.txt");
+
+    // Close the file
+    reader.close();
+
+    // Remove the file
+    std::remove("parameters.txt");
+
+}
+
+// Test that reading lists and ranges of integers works
+BOOST_AUTO_TEST_CASE(readerReadRanges) {
+
+    // Write a parameter file
+    tst::write("parameters.txt", "replicates 3 5-7 9\noffsets -3--1 4");
+
+    // Create a reader
+    ReadPars reader("parameters.txt");
+
+    // Open the file
+    reader.open();
+
+    // Read the first line
+    reader.readline();
+
+    // Read the values
+    std::vector<std::pair<size_t, size_t> > replicates;
+    reader.readranges(replicates);
+
+    // Check that single values are read as ranges of one
+    const std::vector<std::pair<size_t, size_t> > expected1 = {{3u, 3u}, {5u, 7u}, {9u, 9u}};
+    BOOST_CHECK(replicates == expected1);
+
+    // Read the next line
+    reader.readline();
+
+    // Read the values
+    std::vector<std::pair<int, int> > offsets;
+    reader.readranges(offsets);
+
+    // Check that negative bounds are read too
+    const std::vector<std::pair<int, int> > expected2 = {{-3, -1}, {4, 4}};
+    BOOST_CHECK(offsets == expected2);
+
+    // Close the file
+    reader.close();
+
+    // Remove the file
+    std::remove("parameters.txt");
+
+}
+
 // Test that reading a vector of values fails if too many are supplied
 BOOST_AUTO_TEST_CASE(readerErrorTooManyValues) {
 
@@ -555,6 +668,109 @@ BOOST_AUTO_TEST_CASE(readerErrorNegativeSize) {
  
 }
 
+// Test that values too large for their type are caught
+BOOST_AUTO_TEST_CASE(readerErrorValueTooLarge) {
+
+    // Write a parameter file
+    tst::write("parameters.txt", "traitids 1 65536");
+
+    // Create a reader
+    ReadPars reader("parameters.txt");
+
+    // Open the file
+    reader.open();
+
+    // Read the first line
+    reader.readline();
+
+    // Container of small integers
+    std::vector<std::uint16_t> traitids;
+
+    // Check that it throws an error instead of wrapping around
+    tst::checkError([&]() { reader.readvalues<std::uint16_t>(traitids, 2u); }, "Invalid value type for parameter traitids in line 1 of file parameters.txt");
+
+    // Close the file
+    reader.close();
+
+    // Remove the file
+    std::remove("parameters.txt");
+
+}
+
+// Test that numbers are read whichever way they are written
+BOOST_AUTO_TEST_CASE(readerReadNumberFormats) {
+
+    // Write a parameter file
+    tst::write("parameters.txt", "nloci 1e3 10.0 -0 18446744073709551615\neffects 1.5e-3 -.5 .25 3");
+
+    // Create a reader
+    ReadPars reader("parameters.txt");
+
+    // Open the file
+    reader.open();
+
+    // Read the first line
+    reader.readline();
+
+    // Read integers, including the largest one
+    std::vector<std::uint64_t> nloci;
+    reader.readvalues(nloci, 4u);
+
+    // Check
+    const std::vector<std::uint64_t> expected1 = {1000u, 10u, 0u, 18446744073709551615u};
+    BOOST_CHECK_EQUAL_COLLECTIONS(nloci.begin(), nloci.end(), expected1.begin(), expected1.end());
+
+    // Read the next line
+    reader.readline();
+
+    // Read decimals
+    std::vector<double> effects;
+    reader.readvalues(effects, 4u);
+
+    // Check
+    const std::vector<double> expected2 = {0.0015, -0.5, 0.25, 3.0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(effects.begin(), effects.end(), expected2.begin(), expected2.end());
+
+    // Close the file
+    reader.close();
+
+    // Remove the file
+    std::remove("parameters.txt");
+
+}
+
+// Test that values that are not plain numbers are caught
+BOOST_AUTO_TEST_CASE(readerErrorNotANumber) {
+
+    // Write a parameter file
+    tst::write("parameters.txt", "a inf\nb nan\nc 0x10\nd 1e400\ne 1.5.2\nf -");
+
+    // Create a reader
+    ReadPars reader("parameters.txt");
+
+    // Open the file
+    reader.open();
+
+    // For each line...
+    for (const std::string name : {"a", "b", "c", "d", "e", "f"}) {
+
+        // Read it
+        reader.readline();
+
+        // Check that it throws an error
+        double x;
+        tst::checkError([&]() { reader.readvalue(x); }, "Invalid value type for parameter " + name + " in line " + std::to_string(reader.getcount()) + " of file parameters.txt");
+
+    }
+
+    // Close the file
+    reader.close();
+
+    // Remove the file
+    std::remove("parameters.txt");
+
+}
+
 // Check error triggered by the checking function
 BOOST_AUTO_TEST_CASE(checkerError) {
 
@@ -0,0 +1,173 @@
+#define BOOST_TEST_DYNAMIC_LINK
+#define BOOST_TEST_MODULE Main
+
+// Here we test the weighted sampler used to grow networks.
+
+#include "testutils.hpp"
+#include "../src/sampler.hpp"
+#include "../src/random.hpp"
+#include <boost/test/unit_test.hpp>
+
+// Test that weights add up to the total
+BOOST_AUTO_TEST_CASE(samplerKeepsTrackOfWeights) {
+
+    // Create a sampler
+    Sampler sampler(5u);
+
+    // Check that all weights start at zero
+    BOOST_CHECK_EQUAL(sampler.size(), 5u);
+    BOOST_CHECK_EQUAL(sampler.total(), 0.0);
+
+    // Set some weights
+    sampler.set(0u, 1.0);
+    sampler.set(3u, 2.5);
+    sampler.set(4u, 0.5);
+
+    // Check
+    BOOST_CHECK_EQUAL(sampler.get(3u), 2.5);
+    BOOST_CHECK_CLOSE(sampler.total(), 4.0, 1e-9);
+
+    // Change and remove weights
+    sampler.set(3u, 1.0);
+    sampler.set(0u, 0.0);
+
+    // Check
+    BOOST_CHECK_EQUAL(sampler.get(0u), 0.0);
+    BOOST_CHECK_CLOSE(sampler.total(), 1.5, 1e-9);
+
+    // Reset the sampler
+    sampler.reset(3u);
+
+    // Check
+    BOOST_CHECK_EQUAL(sampler.size(), 3u);
+    BOOST_CHECK_EQUAL(sampler.total(), 0.0);
+
+}
+
+// Test that indices with zero weight are never sampled
+BOOST_AUTO_TEST_CASE(samplerSkipsZeroWeights) {
+
+    // Seed the generator
+    rnd::rng.seed(42u);
+
+    // Create a sampler with a few non-zero weights
+    Sampler sampler(100u);
+    sampler.set(7u, 1e-12);
+    sampler.set(50u, 3.0);
+    sampler.set(99u, 1e12);
+
+    // Sample many times
+    bool iswrong = false;
+    for (size_t i = 0u; i < 10000u; ++i) {
+
+        // Sample an index
+        const size_t k = sampler.sample(rnd::rng);
+
+        // Check that its weight is not zero
+        if (sampler.get(k) == 0.0) {
+            iswrong = true;
+            break;
+        }
+    }
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+    // Exclude all but one index
+    sampler.set(50u, 0.0);
+    sampler.set(99u, 0.0);
+
+    // Check that the remaining one is always sampled
+    for (size_t i = 0u; i < 100u; ++i)
+        BOOST_CHECK_EQUAL(sampler.sample(rnd::rng), 7u);
+
+}
+
+// Test that indices are sampled in proportion to their weights
+BOOST_AUTO_TEST_CASE(samplerFollowsWeights) {
+
+    // Note: This test is PROBABILISTIC.
+
+    // Seed the generator
+    rnd::rng.seed(42u);
+
+    // Create a sampler
+    Sampler sampler(4u);
+    sampler.set(0u, 1.0);
+    sampler.set(1u, 2.0);
+    sampler.set(2u, 3.0);
+    sampler.set(3u, 4.0);
+
+    // Count how many times each index is sampled
+    std::vector<size_t> counts(4u, 0u);
+    const size_t n = 100000u;
+    for (size_t i = 0u; i < n; ++i)
+        ++counts[sampler.sample(rnd::rng)];
+
+    // Check that the frequencies match the weights
+    for (size_t k = 0u; k < 4u; ++k)
+        BOOST_CHECK_CLOSE(static_cast<double>(counts[k]) / n, (k + 1.0) / 10.0, 5.0);
+
+}
+
+// Test that the sampler draws the same indices as a discrete distribution
+BOOST_AUTO_TEST_CASE(samplerMatchesDiscreteDistribution) {
+
+    // Weights
+    const std::vector<double> probs = {0.5, 3.0, 1.0, 0.0, 2.0, 8.0, 1.5};
+
+    // Create a sampler with the same weights
+    Sampler sampler(probs.size());
+    for (size_t k = 0u; k < probs.size(); ++k)
+        sampler.set(k, probs[k]);
+
+    // Create two engines with the same seed
+    std::mt19937_64 reference(42u);
+    std::mt19937_64 engine(42u);
+
+    // Sample from both
+    bool iswrong = false;
+    for (size_t i = 0u; i < 1000u; ++i) {
+        if (rnd::discrete(probs.cbegin(), probs.cend())(reference) != sampler.sample(engine)) {
+            iswrong = true;
+            break;
+        }
+    }
+
+    // Check
+    BOOST_CHECK(!iswrong);
+
+    // Note: Both consume one uniform draw per sample, so in practice
+    // the same network is grown from the same seed as before.
+
+}
+
+// Test that the table of powers gives the right values
+BOOST_AUTO_TEST_CASE(powersAreComputedLazily) {
+
+    // Create a table
+    Powers power(1.5);
+
+    // Check that nothing is computed yet
+    BOOST_CHECK_EQUAL(power.size(), 0u);
+
+    // Check some values
+    BOOST_CHECK_CLOSE(power(4u), 8.0, 1e-9);
+    BOOST_CHECK_CLOSE(power(9u), 27.0, 1e-9);
+    BOOST_CHECK_EQUAL(power(1u), 1.0);
+
+    // Check that the table has grown to fit
+    BOOST_CHECK(power.size() >= 10u);
+
+    // Resetting with the same exponent keeps the table
+    const size_t n = power.size();
+    power.reset(1.5);
+    BOOST_CHECK_EQUAL(power.size(), n);
+
+    // But a new exponent clears it
+    power.reset(0.5);
+    BOOST_CHECK_EQUAL(power.size(), 0u);
+    BOOST_CHECK_EQUAL(power.exponent(), 0.5);
+    BOOST_CHECK_CLOSE(power(16u), 4.0, 1e-9);
+
+}
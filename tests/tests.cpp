@@ -10,6 +10,7 @@
 #include "../src/parameters.hpp"
 #include <boost/test/unit_test.hpp>
 #include <cmath>
+#include <filesystem>
 
 // Test that the simulation runs
 BOOST_AUTO_TEST_CASE(useCase) {
@@ -113,6 +114,184 @@ BOOST_AUTO_TEST_CASE(useCaseWithArchitectureLoading) {
 
 }
 
+// Test that it works when saving and loading the architecture in binary
+BOOST_AUTO_TEST_CASE(useCaseWithBinaryArchitecture) {
+
+    // Save the same architecture in text and in binary
+    tst::write("parameters.txt", "seed 42\nsdeffects 1\nsavearch 1");
+    doMain({"program", "parameters.txt"});
+    tst::write("parameters.txt", "seed 42\nsdeffects 1\nsavearch 1\nbinarch 1");
+    doMain({"program", "parameters.txt"});
+
+    // Check that the expected output files are present
+    const std::string text = tst::readtext("architecture.txt");
+    BOOST_CHECK(Architecture::isbinary("architecture.dat"));
+
+    // Rerun the simulation, which should load the binary architecture
+    tst::write("parameters.txt", "seed 1\nmutation 0.5\nloadarch 1\nbinarch 1");
+    std::remove("architecture.txt");
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Rerun from the text architecture instead (with the binary one still present)
+    tst::write("architecture.txt", text);
+    tst::write("parameters.txt", "seed 1\nmutation 0.5\nloadarch 1");
+    doMain({"program", "parameters.txt"});
+    const std::string traits = tst::readtext("traits.csv");
+
+    // Replace the text architecture by a different one
+    tst::write("parameters.txt", "seed 43\nsdeffects 1\nsavearch 1");
+    doMain({"program", "parameters.txt"});
+
+    // Check that the text architecture is the one read (the binary one does not shadow it)
+    tst::write("parameters.txt", "seed 1\nmutation 0.5\nloadarch 1");
+    doMain({"program", "parameters.txt"});
+    BOOST_CHECK(tst::readtext("traits.csv") != traits);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("architecture.dat");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that architectures can be streamed to file without simulating
+BOOST_AUTO_TEST_CASE(useCaseWithStreamedArchitecture) {
+
+    // Save an architecture the usual way
+    tst::write("parameters.txt", "seed 42\nnlocipertrait 100\nnedgespertrait 200\nsavearch 1");
+    doMain({"program", "parameters.txt"});
+    const std::string text = tst::readtext("architecture.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+    // Stream the same architecture instead
+    tst::write("parameters.txt", "seed 42\nnlocipertrait 100\nnedgespertrait 200\nstreamarch 1");
+    doMain({"program", "parameters.txt"});
+
+    // Check that only the architecture was written, and that it is the same
+    BOOST_CHECK_EQUAL(tst::readtext("architecture.txt"), text);
+    BOOST_CHECK(!std::ifstream("traits.csv").good());
+    BOOST_CHECK(!std::ifstream("genotypes.csv").good());
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+
+}
+
+// Test that packing the edges does not change the results
+BOOST_AUTO_TEST_CASE(useCaseWithPackedEdges) {
+
+    // Run the simulation with unpacked edges
+    tst::write("parameters.txt", "seed 42\nnlocipertrait 100\nnedgespertrait 300\nepistasis 0.5\nsavearch 1");
+    doMain({"program", "parameters.txt"});
+    const std::string arch = tst::readtext("architecture.txt");
+    const std::string traits = tst::readtext("traits.csv");
+
+    // Run it again with packed edges
+    tst::write("parameters.txt", "seed 42\nnlocipertrait 100\nnedgespertrait 300\nepistasis 0.5\nsavearch 1\npackedges 1");
+    doMain({"program", "parameters.txt"});
+
+    // Check that the results are the same
+    BOOST_CHECK_EQUAL(tst::readtext("architecture.txt"), arch);
+    BOOST_CHECK_EQUAL(tst::readtext("traits.csv"), traits);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that generated architectures are reused from the cache
+BOOST_AUTO_TEST_CASE(useCaseWithArchitectureCache) {
+
+    // Write a parameter file with the cache turned on
+    tst::write("parameters.txt", "rng 3\nseed 42\nnrepl 2\narchcache 1\nsavearch 1");
+
+    // Run the simulation twice
+    doMain({"program", "parameters.txt"});
+    const std::string arch1 = tst::readtext("architecture_2.txt");
+    const std::string traits1 = tst::readtext("traits_2.csv");
+    doMain({"program", "parameters.txt"});
+
+    // Check that the cache holds the architectures of both replicates
+    size_t n = 0u;
+    for (const auto &entry : std::filesystem::directory_iterator("archcache")) n += entry.path().extension() == ".dat";
+    BOOST_CHECK_EQUAL(n, 2u);
+
+    // Check that the results are the same with the cached architectures
+    BOOST_CHECK_EQUAL(tst::readtext("architecture_2.txt"), arch1);
+    BOOST_CHECK_EQUAL(tst::readtext("traits_2.csv"), traits1);
+
+    // Cleanup
+    std::filesystem::remove_all("archcache");
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture_1.txt");
+    std::remove("architecture_2.txt");
+    std::remove("genotypes_1.csv");
+    std::remove("genotypes_2.csv");
+    std::remove("traits_1.csv");
+    std::remove("traits_2.csv");
+
+}
+
+// Test that trait values are updated for edits to the architecture
+BOOST_AUTO_TEST_CASE(useCaseWithArchitecturePatch) {
+
+    // Parameters of an architecture with dominance, edges and hyperedges
+    const std::string content = "seed 42\nnlocipertrait 50\nnedgespertrait 100\nnhyperpertrait 20\nepistasis 0.5\ndominance 0.5\nsddomcoeffs 1\nenvnoise 1\n";
+
+    // Generate and save the architecture
+    tst::write("parameters.txt", content);
+    doMain({"program", "parameters.txt"});
+
+    // Run a simulation with it
+    tst::write("parameters.txt", content + "loadarch 1");
+    doMain({"program", "parameters.txt"});
+
+    // Write edits to a few loci and edges
+    tst::write("patch.txt", "nloci 2\nloci 1 7\neffects 0.5 -0.5\ndomcoeffs 1 -1\nnedges 2\nedges 3 50\nweights 2 -2\n");
+
+    // Update its trait values (with packed edges)
+    tst::write("parameters.txt", content + "loadarch 1\npackedges 1\npatcharch 1");
+    doMain({"program", "parameters.txt"});
+    const std::vector<double> patched = tst::readcsv("traits_patched.csv", true, true);
+
+    // Rerun the simulation with the edited architecture
+    Architecture arch("architecture.txt");
+    Patch("patch.txt").apply(arch);
+    arch.save("architecture.txt");
+    tst::write("parameters.txt", content + "loadarch 1");
+    doMain({"program", "parameters.txt"});
+    const std::vector<double> traits = tst::readcsv("traits.csv", true, true);
+
+    // Check that the updated trait values match (up to the precision of the files)
+    BOOST_CHECK_EQUAL(patched.size(), traits.size());
+    bool iswrong = false;
+    for (size_t i = 0u; i < traits.size(); ++i)
+        iswrong |= std::abs(patched[i] - traits[i]) > 1e-4 * (1.0 + std::abs(traits[i]));
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("patch.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+    std::remove("traits_patched.csv");
+
+}
+
 // Test that error when invalid architecture file
 BOOST_AUTO_TEST_CASE(abuseInvalidArchitectureFile) {
 
@@ -320,26 +499,498 @@ BOOST_AUTO_TEST_CASE(abuseCannotOpenTraitOutputFile) {
 
 }
 
-// Test that error when cannot open allele output file
-BOOST_AUTO_TEST_CASE(abuseCannotOpenAlleleOutputFile) {
+// Test that error when cannot open allele output file
+BOOST_AUTO_TEST_CASE(abuseCannotOpenAlleleOutputFile) {
+
+    // Create alleles to save
+    std::bitset<64u> bits;
+    std::vector<std::bitset<64u> > alleles = {bits};
+
+    // Test with empty file name
+    BOOST_CHECK_THROW(stf::saveAlleles(alleles, 4u, 8u, "", false), std::runtime_error);
+
+}
+
+// Test that it works with given number of mutations to sample (default)
+BOOST_AUTO_TEST_CASE(useCaseWithGivenSampling) {
+
+    // Write a parameter file with given sampling
+    tst::write("parameters.txt", "mutation 0.2");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with Bernoulli sampling of mutations
+BOOST_AUTO_TEST_CASE(useCaseWithBernoulliSampling) {
+
+    // Write a parameter file with Bernoulli sampling
+    tst::write("parameters.txt", "mutation 0.2\nsampling 1");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with binomial sampling of mutations
+BOOST_AUTO_TEST_CASE(useCaseWithBinomialSampling) {
+
+    // Write a parameter file with binomial sampling
+    tst::write("parameters.txt", "mutation 0.2\nsampling 2");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with binomial sampling and high mutation rate
+BOOST_AUTO_TEST_CASE(useCaseWithBinomialSamplingHighMutationRate) {
+
+    // Write a parameter file with binomial sampling and high mutation rate
+    tst::write("parameters.txt", "mutation 0.7\nsampling 2");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with binomial sampling and full shuffle (forced by low ratio)
+BOOST_AUTO_TEST_CASE(useCaseWithBinomialSamplingFullShuffle) {
+
+    // Write a parameter file with binomial sampling and low ratio to force full shuffle
+    tst::write("parameters.txt", "mutation 0.2\nsampling 2\nratio 0");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with geometric sampling of mutations
+BOOST_AUTO_TEST_CASE(useCaseWithGeometricSampling) {
+
+    // Write a parameter file with geometric sampling
+    tst::write("parameters.txt", "mutation 0.2\nsampling 3");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with geometric sampling and very high mutation rate
+BOOST_AUTO_TEST_CASE(useCaseWithGeometricSamplingHighMutationRate) {
+
+    // Write a parameter file with geometric sampling and very high mutation rate
+    tst::write("parameters.txt", "mutation 0.99\nsampling 3");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that it works with direct sampling of genotypes
+BOOST_AUTO_TEST_CASE(useCaseWithDirectSampling) {
+
+    // Write a parameter file with direct sampling
+    tst::write("parameters.txt", "mutation 0.2\nsampling 4");
+
+    // Check that the program runs
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that direct sampling places alleles at the right loci
+BOOST_AUTO_TEST_CASE(useCaseWithDirectSamplingFixedLoci) {
+
+    // Write a parameter file with direct sampling across several blocks
+    tst::write("parameters.txt", "popsize 70\nnlocipertrait 40\nsampling 4\nspectrum 3");
+
+    // Prepare frequencies where every third locus is fixed
+    std::ostringstream content;
+    content << "frequencies";
+    for (size_t j = 0u; j < 40u; ++j) content << ' ' << (j % 3u == 1u);
+    tst::write("frequencies.txt", content.str());
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 70u * 40u);
+
+    // Check that each locus has the genotype implied by its frequency
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != (i % 40u % 3u == 1u ? 2.0 : 0.0)) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("frequencies.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that haplotypes are copies of the founder if there is only one
+BOOST_AUTO_TEST_CASE(useCaseWithLinkageSamplingSingleFounder) {
+
+    // Write a parameter file with a single founder
+    tst::write("parameters.txt", "popsize 70\nnlocipertrait 40\nmutation 0.5\nsampling 5\nnfounders 1\nswitchrate 0.2");
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 70u * 40u);
+
+    // Check that all individuals are homozygous copies of the same haplotype
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != genotypes[i % 40u] || genotypes[i] == 1.0) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that haplotypes are still copies of the single founder when switching at every locus
+BOOST_AUTO_TEST_CASE(useCaseWithLinkageSamplingSwitchingEveryLocus) {
+
+    // Write a parameter file with a single founder
+    tst::write("parameters.txt", "popsize 70\nnlocipertrait 40\nmutation 0.5\nsampling 5\nnfounders 1\nswitchrate 1");
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 70u * 40u);
+
+    // Check that all individuals are homozygous copies of the same haplotype
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != genotypes[i % 40u] || genotypes[i] == 1.0) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that blocks are copied at the right loci
+BOOST_AUTO_TEST_CASE(useCaseWithLinkageSamplingFixedLoci) {
+
+    // Write a parameter file with many short blocks
+    tst::write("parameters.txt", "popsize 70\nnlocipertrait 100\nsampling 5\nspectrum 3\nnfounders 5\nswitchrate 0.1");
+
+    // Prepare frequencies where every third locus is fixed in all founders
+    std::ostringstream content;
+    content << "frequencies";
+    for (size_t j = 0u; j < 100u; ++j) content << ' ' << (j % 3u == 1u);
+    tst::write("frequencies.txt", content.str());
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 70u * 100u);
+
+    // Check that each locus has the genotype implied by its frequency
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != (i % 100u % 3u == 1u ? 2.0 : 0.0)) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("frequencies.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test with a population structured in fully differentiated demes
+BOOST_AUTO_TEST_CASE(useCaseWithDemes) {
+
+    // Write a parameter file with two demes of unequal sizes
+    tst::write("parameters.txt", "popsize 100\nnlocipertrait 40\nmutation 0.5\nndemes 2\ndemesizes 30 70\nfst 1");
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes and traits (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+    const std::vector<double> traits = tst::readcsv("traits.csv", true, true);
+
+    // Check dimensions (including the deme column)
+    BOOST_CHECK_EQUAL(genotypes.size(), 100u * 41u);
+    BOOST_CHECK_EQUAL(traits.size(), 100u * 2u);
+
+    // Check deme labels
+    bool iswrong = false;
+    for (size_t i = 0u; i < 100u; ++i) {
+        const double deme = i < 30u ? 1.0 : 2.0;
+        if (genotypes[i * 41u] != deme || traits[i * 2u] != deme) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Check that all loci are fixed within each deme
+    iswrong = false;
+    for (size_t i = 0u; i < 100u; ++i) {
+        const size_t first = i < 30u ? 0u : 30u;
+        for (size_t j = 1u; j < 41u; ++j) {
+            const double x = genotypes[i * 41u + j];
+            if (x == 1.0 || x != genotypes[first * 41u + j]) iswrong = true;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Check that the genotypes can be imported back despite the deme column
+    tst::write("parameters.txt", "popsize 100\nnlocipertrait 40\nndemes 2\nimport 1\nloadarch 1");
+    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test with multiple generations of reproduction
+BOOST_AUTO_TEST_CASE(useCaseWithGenerations) {
+
+    // Write a parameter file where every third locus is fixed
+    tst::write("parameters.txt", "popsize 70\nnlocipertrait 100\nsampling 4\nspectrum 3\nngenerations 3\nrecombination 0.3\nlastonly 0");
+
+    // Prepare frequencies where every third locus is fixed
+    std::ostringstream content;
+    content << "frequencies";
+    for (size_t j = 0u; j < 100u; ++j) content << ' ' << (j % 3u == 1u);
+    tst::write("frequencies.txt", content.str());
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Check that the traits of intermediate generations have been saved
+    BOOST_CHECK_NO_THROW(tst::readtext("traits_gen0.csv"));
+    BOOST_CHECK_NO_THROW(tst::readtext("traits_gen1.csv"));
+    BOOST_CHECK_NO_THROW(tst::readtext("traits_gen2.csv"));
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 70u * 100u);
+
+    // Check that fixed loci have been passed on to the offspring
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != (i % 100u % 3u == 1u ? 2.0 : 0.0)) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("frequencies.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+    std::remove("traits_gen0.csv");
+    std::remove("traits_gen1.csv");
+    std::remove("traits_gen2.csv");
+
+}
+
+// Test that reproduction works when every locus recombines
+BOOST_AUTO_TEST_CASE(useCaseWithGenerationsFullRecombination) {
+
+    // Write a parameter file where every third locus is fixed
+    tst::write("parameters.txt", "popsize 70\nnlocipertrait 100\nsampling 4\nspectrum 3\nngenerations 3\nrecombination 1");
+
+    // Prepare frequencies where every third locus is fixed
+    std::ostringstream content;
+    content << "frequencies";
+    for (size_t j = 0u; j < 100u; ++j) content << ' ' << (j % 3u == 1u);
+    tst::write("frequencies.txt", content.str());
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 70u * 100u);
+
+    // Check that fixed loci have been passed on to the offspring
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != (i % 100u % 3u == 1u ? 2.0 : 0.0)) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("frequencies.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that haplotypes are passed on whole without recombination
+BOOST_AUTO_TEST_CASE(useCaseWithGenerationsWithoutRecombination) {
+
+    // Write a parameter file with two founder haplotypes
+    std::ostringstream content;
+    content << "popsize 50\n";
+    content << "nlocipertrait 70\n";
+    content << "mutation 0.5\n";
+    content << "sampling 5\n";
+    content << "nfounders 2\n";
+    content << "switchrate 0\n";
+    content << "seed 1\n";
+    tst::write("parameters.txt", content.str());
+
+    // Run a single generation
+    doMain({"program", "parameters.txt"});
+    const std::vector<double> before = tst::readcsv("genotypes.csv", true, true);
+
+    // Run again with reproduction but no recombination
+    content << "ngenerations 5\n";
+    content << "recombination 0\n";
+    tst::write("parameters.txt", content.str());
+    doMain({"program", "parameters.txt"});
+    const std::vector<double> after = tst::readcsv("genotypes.csv", true, true);
 
-    // Create alleles to save
-    std::bitset<64u> bits;
-    std::vector<std::bitset<64u> > alleles = {bits};
+    // Check dimensions
+    BOOST_CHECK_EQUAL(after.size(), 50u * 70u);
 
-    // Test with empty file name
-    BOOST_CHECK_THROW(stf::saveAlleles(alleles, 4u, 8u, "", false), std::runtime_error);
+    // Function to check whether a row is a combination of the founder haplotypes
+    auto isfounded = [&](const std::vector<double> &genotypes, const size_t &i) {
 
-}
+        // Look for a row of the first generation with the same genotypes
+        for (size_t j = 0u; j < 50u; ++j)
+            if (std::equal(genotypes.begin() + i * 70u, genotypes.begin() + (i + 1u) * 70u, before.begin() + j * 70u))
+                return true;
 
-// Test that it works with given number of mutations to sample (default)
-BOOST_AUTO_TEST_CASE(useCaseWithGivenSampling) {
+        return false;
 
-    // Write a parameter file with given sampling
-    tst::write("parameters.txt", "mutation 0.2");
+    };
 
-    // Check that the program runs
-    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+    // Check that all offspring carry intact founder haplotypes
+    bool iswrong = false;
+    for (size_t i = 0u; i < 50u; ++i) if (!isfounded(after, i)) iswrong = true;
+    BOOST_CHECK(!iswrong);
 
     // Cleanup
     std::remove("parameters.txt");
@@ -350,29 +1001,45 @@ BOOST_AUTO_TEST_CASE(useCaseWithGivenSampling) {
 
 }
 
-// Test that it works with Bernoulli sampling of mutations
-BOOST_AUTO_TEST_CASE(useCaseWithBernoulliSampling) {
+// Test that each generation draws its own environmental noise
+BOOST_AUTO_TEST_CASE(useCaseWithGenerationsNoiseIsIndependent) {
 
-    // Write a parameter file with Bernoulli sampling
-    tst::write("parameters.txt", "mutation 0.2\nsampling 1");
+    // Write a parameter file where all loci are fixed, so only noise varies
+    tst::write("parameters.txt", "popsize 20\nnlocipertrait 10\nsampling 4\nspectrum 3\nngenerations 2\nlastonly 0\nenvnoise 1\nrng 3\nseed 42");
 
-    // Check that the program runs
-    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+    // Prepare frequencies where no locus carries mutations
+    tst::write("frequencies.txt", "frequencies 0 0 0 0 0 0 0 0 0 0");
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read the trait values of each generation
+    const std::string traits0 = tst::readtext("traits_gen0.csv");
+    const std::string traits1 = tst::readtext("traits_gen1.csv");
+    const std::string traits2 = tst::readtext("traits.csv");
+
+    // Check that the noise differs between generations
+    BOOST_CHECK(traits0 != traits1);
+    BOOST_CHECK(traits1 != traits2);
+    BOOST_CHECK(traits0 != traits2);
 
     // Cleanup
     std::remove("parameters.txt");
     std::remove("paramlog.txt");
     std::remove("architecture.txt");
+    std::remove("frequencies.txt");
     std::remove("genotypes.csv");
     std::remove("traits.csv");
+    std::remove("traits_gen0.csv");
+    std::remove("traits_gen1.csv");
 
 }
 
-// Test that it works with binomial sampling of mutations
-BOOST_AUTO_TEST_CASE(useCaseWithBinomialSampling) {
+// Test that it works with full mutations
+BOOST_AUTO_TEST_CASE(useCaseWithFullSampling) {
 
-    // Write a parameter file with binomial sampling
-    tst::write("parameters.txt", "mutation 0.2\nsampling 2");
+    // Write a parameter file with full sampling
+    tst::write("parameters.txt", "mutation 1");
 
     // Check that the program runs
     BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
@@ -386,11 +1053,11 @@ BOOST_AUTO_TEST_CASE(useCaseWithBinomialSampling) {
 
 }
 
-// Test that it works with binomial sampling and high mutation rate
-BOOST_AUTO_TEST_CASE(useCaseWithBinomialSamplingHighMutationRate) {
+// Test that it works with a beta spectrum of allele frequencies
+BOOST_AUTO_TEST_CASE(useCaseWithBetaSpectrum) {
 
-    // Write a parameter file with binomial sampling and high mutation rate
-    tst::write("parameters.txt", "mutation 0.7\nsampling 2");
+    // Write a parameter file with a beta spectrum
+    tst::write("parameters.txt", "spectrum 1\nshapes 0.5 0.5");
 
     // Check that the program runs
     BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
@@ -404,11 +1071,11 @@ BOOST_AUTO_TEST_CASE(useCaseWithBinomialSamplingHighMutationRate) {
 
 }
 
-// Test that it works with binomial sampling and full shuffle (forced by low ratio)
-BOOST_AUTO_TEST_CASE(useCaseWithBinomialSamplingFullShuffle) {
+// Test that it works with a neutral spectrum of allele frequencies
+BOOST_AUTO_TEST_CASE(useCaseWithNeutralSpectrum) {
 
-    // Write a parameter file with binomial sampling and low ratio to force full shuffle
-    tst::write("parameters.txt", "mutation 0.2\nsampling 2\nratio 0");
+    // Write a parameter file with a neutral spectrum
+    tst::write("parameters.txt", "spectrum 2\nminfreq 0.1");
 
     // Check that the program runs
     BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
@@ -422,50 +1089,96 @@ BOOST_AUTO_TEST_CASE(useCaseWithBinomialSamplingFullShuffle) {
 
 }
 
-// Test that it works with geometric sampling of mutations
-BOOST_AUTO_TEST_CASE(useCaseWithGeometricSampling) {
+// Test that allele frequencies can be read from file
+BOOST_AUTO_TEST_CASE(useCaseWithFrequencyFile) {
 
-    // Write a parameter file with geometric sampling
-    tst::write("parameters.txt", "mutation 0.2\nsampling 3");
+    // Write a parameter file reading frequencies from file
+    tst::write("parameters.txt", "popsize 5\nnlocipertrait 3\nspectrum 3");
 
-    // Check that the program runs
-    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+    // Write a frequency file where only the second locus is fixed
+    tst::write("frequencies.txt", "frequencies 0 1 0");
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotypes (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(genotypes.size(), 5u * 3u);
+
+    // Check that each locus has the genotype implied by its frequency
+    bool iswrong = false;
+    for (size_t i = 0u; i < genotypes.size(); ++i) {
+        if (genotypes[i] != (i % 3u == 1u ? 2.0 : 0.0)) {
+            iswrong = true;
+            break;
+        }
+    }
+    BOOST_CHECK(!iswrong);
 
     // Cleanup
     std::remove("parameters.txt");
     std::remove("paramlog.txt");
     std::remove("architecture.txt");
+    std::remove("frequencies.txt");
     std::remove("genotypes.csv");
     std::remove("traits.csv");
 
 }
 
-// Test that it works with geometric sampling and very high mutation rate
-BOOST_AUTO_TEST_CASE(useCaseWithGeometricSamplingHighMutationRate) {
+// Test error when the frequency file is invalid
+BOOST_AUTO_TEST_CASE(abuseInvalidFrequencyFile) {
 
-    // Write a parameter file with geometric sampling and very high mutation rate
-    tst::write("parameters.txt", "mutation 0.99\nsampling 3");
+    // Write a parameter file reading frequencies from file
+    tst::write("parameters.txt", "nlocipertrait 3\nspectrum 3");
 
-    // Check that the program runs
-    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+    // Write a frequency file with too few values
+    tst::write("frequencies.txt", "frequencies 0 1");
+
+    // Check error
+    tst::checkError([&] {
+        doMain({"program", "parameters.txt"});
+    }, "Too few values for parameter frequencies in line 1 of file frequencies.txt");
+
+    // Write a frequency file without frequencies
+    tst::write("frequencies.txt", "# No frequencies");
+
+    // Check error
+    tst::checkError([&] {
+        doMain({"program", "parameters.txt"});
+    }, "No frequencies found in file frequencies.txt");
 
     // Cleanup
     std::remove("parameters.txt");
     std::remove("paramlog.txt");
     std::remove("architecture.txt");
-    std::remove("genotypes.csv");
-    std::remove("traits.csv");
+    std::remove("frequencies.txt");
 
 }
 
-// Test that it works with full mutations
-BOOST_AUTO_TEST_CASE(useCaseWithFullSampling) {
+// Test that it works with counter-based random streams
+BOOST_AUTO_TEST_CASE(useCaseWithCounterBasedStreams) {
 
-    // Write a parameter file with full sampling
-    tst::write("parameters.txt", "mutation 1");
+    // Write a parameter file using every counter-based stream
+    std::ostringstream content;
+    content << "nlocipertrait 10\n";
+    content << "nedgespertrait 12\n";
+    content << "envnoise 1\n";
+    content << "spectrum 1\n";
+    content << "sampling 4\n";
+    content << "rng 3\n";
+    content << "seed 42\n";
+    tst::write("parameters.txt", content.str());
 
-    // Check that the program runs
-    BOOST_CHECK_NO_THROW(doMain({"program", "parameters.txt"}));
+    // Run twice
+    doMain({"program", "parameters.txt"});
+    const std::string traits1 = tst::readtext("traits.csv");
+    doMain({"program", "parameters.txt"});
+    const std::string traits2 = tst::readtext("traits.csv");
+
+    // Check that results are reproducible
+    BOOST_CHECK_EQUAL(traits1, traits2);
 
     // Cleanup
     std::remove("parameters.txt");
@@ -511,6 +1224,63 @@ BOOST_AUTO_TEST_CASE(useCaseWithMultipleReplicates) {
 
 }
 
+// Test that a single replicate can be rerun on its own
+BOOST_AUTO_TEST_CASE(useCaseWithReplicateSubset) {
+
+    // For each sequential engine...
+    for (const std::string engine : {"0", "1", "2"}) {
+
+        // Write a parameter file with multiple replicates
+        std::ostringstream content;
+        content << "nrepl 3\n";
+        content << "nlocipertrait 10\n";
+        content << "nedgespertrait 12\n";
+        content << "envnoise 1\n";
+        content << "mutation 0.2\n";
+        content << "seed 42\n";
+        content << "rng " << engine << '\n';
+        tst::write("parameters.txt", content.str());
+
+        // Run all the replicates
+        doMain({"program", "parameters.txt"});
+        const std::string arch1 = tst::readtext("architecture_3.txt");
+        const std::string traits1 = tst::readtext("traits_3.csv");
+        const std::string genotypes1 = tst::readtext("genotypes_3.csv");
+
+        // Remove the outputs of the full run
+        for (const std::string i : {"1", "2", "3"}) {
+            std::remove(("architecture_" + i + ".txt").c_str());
+            std::remove(("genotypes_" + i + ".csv").c_str());
+            std::remove(("traits_" + i + ".csv").c_str());
+        }
+
+        // Run only the last replicate
+        content << "replicates 3\n";
+        tst::write("parameters.txt", content.str());
+        doMain({"program", "parameters.txt"});
+
+        // Check that only that replicate was run
+        BOOST_CHECK(!std::ifstream("traits_1.csv").good());
+        BOOST_CHECK(!std::ifstream("traits_2.csv").good());
+
+        // Check that it matches its counterpart in the full run
+        BOOST_CHECK_EQUAL(tst::readtext("architecture_3.txt"), arch1);
+        BOOST_CHECK_EQUAL(tst::readtext("traits_3.csv"), traits1);
+        BOOST_CHECK_EQUAL(tst::readtext("genotypes_3.csv"), genotypes1);
+
+        // Cleanup
+        std::remove("architecture_3.txt");
+        std::remove("genotypes_3.csv");
+        std::remove("traits_3.csv");
+
+    }
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+
+}
+
 // Test with multiple replicates and supplied architecture
 BOOST_AUTO_TEST_CASE(useCaseWithMultipleReplicatesSuppliedArchitecture) {
 
@@ -624,6 +1394,107 @@ BOOST_AUTO_TEST_CASE(useCaseWithAlleleImport) {
 
 }
 
+// Test that imported genotypes are saved back unchanged
+BOOST_AUTO_TEST_CASE(useCaseWithAlleleImportRoundTrip) {
+
+    // For each ploidy...
+    for (const size_t ploidy : {1u, 2u, 4u, 6u}) {
+
+        // Write a genotype file with every possible dosage
+        std::ostringstream content;
+        content << "id,locus1,locus2,locus3,locus4,locus5\n";
+        for (size_t i = 0u; i < 7u; ++i) {
+            content << i + 1u;
+            for (size_t j = 0u; j < 5u; ++j) content << ',' << (i + j) % (ploidy + 1u);
+            content << '\n';
+        }
+        tst::write("genotypes.csv", content.str());
+
+        // Import it without mutations
+        tst::write("parameters.txt", "popsize 7\nnlocipertrait 5\nimport 1\nploidy " + std::to_string(ploidy));
+        doMain({"program", "parameters.txt"});
+
+        // Check that the genotypes are saved back unchanged
+        BOOST_CHECK_EQUAL(tst::readtext("genotypes.csv"), content.str());
+
+    }
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that trait values do not depend on ploidy in fully homozygous populations
+BOOST_AUTO_TEST_CASE(useCaseWithPloidy) {
+
+    // Prepare frequencies where every third locus is fixed
+    std::ostringstream content;
+    content << "frequencies";
+    for (size_t j = 0u; j < 40u; ++j) content << ' ' << (j % 3u == 1u);
+    tst::write("frequencies.txt", content.str());
+
+    // Prepare to store trait values
+    std::vector<std::string> traits;
+
+    // For each ploidy...
+    for (const size_t ploidy : {1u, 2u, 4u, 6u}) {
+
+        // Write a parameter file with epistasis and dominance
+        std::ostringstream params;
+        params << "popsize 70\n";
+        params << "nlocipertrait 40\n";
+        params << "nedgespertrait 50\n";
+        params << "epistasis 0.5\n";
+        params << "dominance 1\n";
+        params << "sampling 4\n";
+        params << "spectrum 3\n";
+        params << "seed 42\n";
+        params << "ploidy " << ploidy << '\n';
+        tst::write("parameters.txt", params.str());
+
+        // Run the simulation
+        doMain({"program", "parameters.txt"});
+
+        // Read in the saved genotypes (skip header and identifier column)
+        const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+
+        // Check dimensions
+        BOOST_CHECK_EQUAL(genotypes.size(), 70u * 40u);
+
+        // Check that fixed loci carry as many 1-alleles as the ploidy
+        bool iswrong = false;
+        for (size_t i = 0u; i < genotypes.size(); ++i) {
+            if (genotypes[i] != (i % 40u % 3u == 1u ? ploidy : 0.0)) {
+                iswrong = true;
+                break;
+            }
+        }
+        BOOST_CHECK(!iswrong);
+
+        // Store trait values
+        traits.push_back(tst::readtext("traits.csv"));
+
+    }
+
+    // Check that trait values are the same whatever the ploidy
+    BOOST_CHECK_EQUAL(traits[0u], traits[1u]);
+    BOOST_CHECK_EQUAL(traits[0u], traits[2u]);
+    BOOST_CHECK_EQUAL(traits[0u], traits[3u]);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("frequencies.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
 // Test error when cannot open allele import file
 BOOST_AUTO_TEST_CASE(abuseCannotOpenAlleleImportFile) {
 
@@ -959,6 +1830,175 @@ BOOST_AUTO_TEST_CASE(useCaseTraitValueCalculationWithDominance) {
 
 }
 
+// Test the correct calculation of trait values with pleiotropy
+BOOST_AUTO_TEST_CASE(useCaseTraitValueCalculationWithPleiotropy) {
+
+    // Write a parameter file with two traits and known architecture
+    std::ostringstream content;
+    content << "ntraits 2\n";
+    content << "nlocipertrait 2 1\n";
+    content << "nedgespertrait 0 0\n";
+    content << "skew 0 0\n";
+    content << "epistasis 0 0\n";
+    content << "dominance 1 0.5\n";
+    content << "envnoise 0 0\n";
+    content << "loadarch 1\n";
+    tst::write("parameters.txt", content.str());
+
+    // Prepare a genetic architecture where the first locus also affects the second trait
+    std::ostringstream arch;
+    arch << "nloci 3\n";
+    arch << "nedges 0\n";
+    arch << "ntraits 2\n";
+    arch << "traitids 1 1 2\n";
+    arch << "effects 0.3 0.4 -0.1\n";
+    arch << "domcoeffs 0.5 0.5 0.5\n";
+    arch << "npleio 1\n";
+    arch << "pleioloci 1\n";
+    arch << "pleiotraits 2\n";
+    arch << "pleioeffects 0.2\n";
+    arch << "pleiodomcoeffs 0.4\n";
+    tst::write("architecture.txt", arch.str());
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotype and trait files (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+    const std::vector<double> traits = tst::readcsv("traits.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(traits.size(), 2u * genotypes.size() / 3u);
+
+    // Tolerance on trait values (looser if effects are stored as floats)
+    const double tolerance = ARCHGEN_FLOAT_EFFECTS ? 1e-6 : 1e-9;
+
+    // Flag
+    bool iswrong = false;
+
+    // For each individual...
+    for (size_t i = 0u; 3u * i < genotypes.size(); ++i) {
+
+        // Genetic values at each locus
+        const double x0 = genotypes[3u * i] - 1.0;
+        const double x1 = genotypes[3u * i + 1u] - 1.0;
+        const double x2 = genotypes[3u * i + 2u] - 1.0;
+
+        // Expected value of the first trait
+        const double trait0 = (x0 + (x0 == 0.0) * 0.5) * 0.3 + (x1 + (x1 == 0.0) * 0.5) * 0.4;
+
+        // Expected value of the second trait, with the pleiotropic effect of the first locus
+        const double trait1 = (x2 + (x2 == 0.0) * 0.25) * -0.1 + (x0 + (x0 == 0.0) * 0.2) * 0.2;
+
+        // If no match...
+        if (std::abs(trait0 - traits[2u * i]) > tolerance || std::abs(trait1 - traits[2u * i + 1u]) > tolerance) {
+
+            // Exit
+            iswrong = true;
+            break;
+
+        }
+    }
+
+    // Make sure everything is fine
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
+// Test that trait values include the contributions of hyperedges
+BOOST_AUTO_TEST_CASE(useCaseTraitValueCalculationWithHyperedges) {
+
+    // Write a parameter file with one trait and known architecture
+    std::ostringstream content;
+    content << "popsize 50\n";
+    content << "mutation 0.5\n";
+    content << "ntraits 1\n";
+    content << "nlocipertrait 6\n";
+    content << "nedgespertrait 0\n";
+    content << "skew 0\n";
+    content << "epistasis 0.4\n";
+    content << "dominance 0\n";
+    content << "envnoise 0\n";
+    content << "loadarch 1\n";
+    tst::write("parameters.txt", content.str());
+
+    // Prepare a genetic architecture with hyperedges of orders two to five
+    std::ostringstream arch;
+    arch << "nloci 6\n";
+    arch << "nedges 0\n";
+    arch << "ntraits 1\n";
+    arch << "traitids 1 1 1 1 1 1\n";
+    arch << "effects 0.1 0.2 0.3 0.4 0.5 0.6\n";
+    arch << "domcoeffs 0 0 0 0 0 0\n";
+    arch << "nhyper 5\n";
+    arch << "hyperorders 5 3 2 4 3\n";
+    arch << "hyperloci 1 2 3 4 5 1 2 3 5 6 1 3 5 6 2 4 6\n";
+    arch << "hyperweights 0.5 0.6 0.7 0.8 0.9\n";
+    tst::write("architecture.txt", arch.str());
+
+    // Run the simulation
+    doMain({"program", "parameters.txt"});
+
+    // Read in the saved genotype and trait files (skip header and identifier column)
+    const std::vector<double> genotypes = tst::readcsv("genotypes.csv", true, true);
+    const std::vector<double> traits = tst::readcsv("traits.csv", true, true);
+
+    // Check dimensions
+    BOOST_CHECK_EQUAL(traits.size(), genotypes.size() / 6u);
+
+    // Tolerance on trait values (looser if effects are stored as floats)
+    const double tolerance = ARCHGEN_FLOAT_EFFECTS ? 1e-6 : 1e-9;
+
+    // Flag
+    bool iswrong = false;
+
+    // For each individual...
+    for (size_t i = 0u; 6u * i < genotypes.size(); ++i) {
+
+        // Genetic values at each locus
+        std::vector<double> x(6u);
+        for (size_t j = 0u; j < 6u; ++j) x[j] = genotypes[6u * i + j] - 1.0;
+
+        // Additive part
+        double trait = 0.0;
+        for (size_t j = 0u; j < 6u; ++j) trait += x[j] * 0.1 * (j + 1u) * 0.6;
+
+        // Interactions
+        trait += x[0] * x[1] * x[2] * x[3] * x[4] * 0.5 * 0.4;
+        trait += x[0] * x[1] * x[2] * 0.6 * 0.4;
+        trait += x[4] * x[5] * 0.7 * 0.4;
+        trait += x[0] * x[2] * x[4] * x[5] * 0.8 * 0.4;
+        trait += x[1] * x[3] * x[5] * 0.9 * 0.4;
+
+        // If no match...
+        if (std::abs(trait - traits[i]) > tolerance) {
+
+            // Exit
+            iswrong = true;
+            break;
+
+        }
+    }
+
+    // Make sure everything is fine
+    BOOST_CHECK(!iswrong);
+
+    // Cleanup
+    std::remove("parameters.txt");
+    std::remove("paramlog.txt");
+    std::remove("architecture.txt");
+    std::remove("genotypes.csv");
+    std::remove("traits.csv");
+
+}
+
 // Test the correct calculation of trait values with epistasis
 BOOST_AUTO_TEST_CASE(useCaseTraitValueCalculationWithEpistasis) {
 